@@ -2,6 +2,7 @@
 #define _BASETHREAD_H
 
 #include "WaitObject.h"
+#include "WaitHandler.h"
 #include "LetheTypes.h"
 #include "LetheBasic.h"
 #include <string>
@@ -37,7 +38,9 @@ namespace lethe
    *   thread's context.
    * iterate() - user-defined, called every time the iterate timeout expires, or
    *   a registered WaitObject triggers.  The handle parameter is the handle of the
-   *   triggered WaitObject, or INVALID_HANDLE_VALUE if a timeout occurred.
+   *   triggered WaitObject, or INVALID_HANDLE_VALUE if a timeout occurred.  All of
+   *   the WaitObjects that triggered together are handled before the thread waits
+   *   again.
    * error() - user-defined, called every time a registered WaitObject returns
    *   an error status. The handle parameter is the handle of the triggered
    *   WaitObject.
@@ -45,11 +48,33 @@ namespace lethe
    *   an abandoned status. The handle parameter is the handle of the triggered
    *   WaitObject.  Abandoned may only occur on mutex objects - when a mutex is
    *   closed or otherwise abandoned while still locked by the thread.
+   * addFailed() - optionally user-defined, called when the WaitSet throws while
+   *   adding an object given to addWaitObject or addExclusiveWaitObject, with the
+   *   exception's what() string.  By default, this throws a std::runtime_error
+   *   with the same text, which stops the thread.  A derived class may override
+   *   it to drop the object and keep running.
    * addWaitObject() - called to register a WaitObject with the thread.  Iterate
-   *   will be called when the WaitObject triggers.
+   *   will be called when the WaitObject triggers.  If a WaitHandler is given, its
+   *   handleWait is called instead of iterate, error or abandoned, along with the
+   *   userData pointer, so the thread doesn't need to look up the handle itself.
+   * addExclusiveWaitObject() - the same as addWaitObject with a handler, but if
+   *   the object is added exclusively to several threads, only one of them is woken
+   *   each time it triggers (see WaitSet::addExclusive).
+   * modifyWaitObject() - changes the WaitInterest flags of a registered WaitObject,
+   *   for example so a writer can wait for a stream to become writable again.  An
+   *   empty or unknown mask throws std::invalid_argument right away.
    * removeWaitObject() - called to unregister a WaitObject from the thread.
+   * setWaitPolicy(), setWaitPriority(), setWaitWeight() - change the order in which
+   *   WaitObjects that trigger together are handled (see WaitPolicy in WaitSet).  An
+   *   unknown policy or a weight of 0 throws std::invalid_argument right away.
+   * getWaitDispatchCount() - returns the number of times a registered WaitObject
+   *   has been handled by the thread.
    * setWaitTimeout() - changes the iteration timeout that was set in the
    *   constructor
+   *
+   * The WaitObject operations are queued and carried out by the thread itself.  If
+   *  the WaitSet throws for one of them (other than an add, see addFailed), the
+   *  thread stops, and getError() returns the exception's what() string.
    */
   class BaseThread : public WaitObject
   {
@@ -68,11 +93,19 @@ namespace lethe
     virtual void iterate(Handle handle);
     virtual void error(Handle handle);
     virtual void abandoned(Handle handle);
+    virtual void addFailed(WaitObject& obj, const std::string& reason);
 
     friend class CommRegistry; // Workaround to allow access to addWaitObject, TODO: find a better solution
 
     void addWaitObject(WaitObject& obj);
+    void addWaitObject(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+    void addExclusiveWaitObject(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+    void modifyWaitObject(WaitObject& obj, uint32_t interest);
     void removeWaitObject(WaitObject& obj);
+    void setWaitPolicy(WaitPolicy policy);
+    void setWaitPriority(WaitObject& obj, uint32_t priority);
+    void setWaitWeight(WaitObject& obj, uint32_t weight);
+    uint64_t getWaitDispatchCount(WaitObject& obj);
     void setWaitTimeout(uint32_t timeout);
 
     // Internal functions to be used in WindowsThread and LinuxThread (shouldn't be used outside this library)
@@ -83,20 +116,47 @@ namespace lethe
     BaseThread(const BaseThread&);
     BaseThread& operator = (const BaseThread&);
 
-    void handleObjectQueue(); // Internal function for handling queued WaitObject add/remove operations
+    // A queued WaitObject operation
+    struct ObjectOperation
+    {
+      enum Type
+      {
+        Add,
+        AddExclusive,
+        Modify,
+        Remove,
+        Policy,
+        Priority,
+        Weight
+      } type;
+
+      WaitObject* object;
+      WaitHandler* handler;
+      void* userData;
+      uint32_t value; // The interest, policy, priority or weight
+    };
+
+    void queueObjectOperation(ObjectOperation::Type type, WaitObject* obj, WaitHandler* handler, void* userData, uint32_t value);
+    void handleObjectQueue(); // Internal function for handling queued WaitObject operations
+    void dispatch(const WaitEvent& event); // Internal function for calling the user function for a wait result
 
     bool m_running; // Indicates that the thread should be looping
     bool m_exit; // Indicates that the thread is no longer startable
 
-    Event m_triggerEvent; // An event to tell the thread to reevaluate its running state
+    FastEvent m_triggerEvent; // An event to tell the thread to reevaluate its running state
     Event m_stoppedEvent; // An event that will be set when the thread has been stopped
-    Event m_exitedEvent; // An event that will be set when the thread has exited
-    Mutex m_mutex; // Mutex to limit access to the waitSet
+    FastEvent m_exitedEvent; // An event that will be set when the thread has exited
+    FastMutex m_mutex; // Mutex to limit access to the waitSet
 
-    std::queue<std::pair<bool, WaitObject*> > m_objectQueue; // A queue of WaitObjects to add or remove
+    std::queue<ObjectOperation> m_objectQueue; // A queue of WaitObjects to add or remove
     WaitSet m_waitSet; // A list of all handles provided by the implementation along with the trigger event
     uint32_t m_timeout;
 
+    static const size_t s_maxWaitCount; // The maximum number of handles received from a single wait
+    WaitEvent* m_waitEvents; // The batch of events received from the last wait
+    size_t m_waitCount; // The number of handles in the batch
+    size_t m_waitOffset; // The handle in the batch currently being dispatched
+
     std::string m_error; // The text of any exception that gets to the main loop
   };
 }
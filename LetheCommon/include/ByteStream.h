@@ -17,6 +17,22 @@ namespace lethe
    *
    * receive() - Receives data from the stream and copies it into the provided
    *   buffer, and returns the number of bytes received.
+   *
+   * sendv() - sends the buffers described by an array of iovecs, in order, as
+   *   a single send.  Streams that can't gather natively copy the buffers into
+   *   one and call send().
+   *
+   * receivev() - receives data into the buffers described by an array of
+   *   iovecs, filling each before moving on to the next, and returns the total
+   *   number of bytes received.  Streams that can't scatter natively call
+   *   receive() for each buffer until one comes up short.
+   *
+   * flush() - waits up to timeout for all sent data to be handed over, returns
+   *   false if some is still pending.
+   *
+   * getFlushObject() - returns a WaitObject that is signaled once all sent data
+   *   has been handed over, so the completion of a flush can be waited for along
+   *   with other objects in a WaitSet.
    */
   class ByteStream : public WaitObject
   {
@@ -26,7 +42,10 @@ namespace lethe
 
     virtual void send(const void*, uint32_t) = 0;
     virtual uint32_t receive(void*, uint32_t) = 0;
+    virtual void sendv(const iovec* vectors, uint32_t count);
+    virtual uint32_t receivev(const iovec* vectors, uint32_t count);
     virtual bool flush(uint32_t) = 0;
+    virtual WaitObject& getFlushObject() = 0;
   };
 }
 
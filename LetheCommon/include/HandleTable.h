@@ -0,0 +1,174 @@
+#ifndef _HANDLETABLE_H
+#define _HANDLETABLE_H
+
+#include "LetheTypes.h"
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+/*
+ * The HandleTable template maps Handles to values with a table indexed directly by
+ *  the handle, instead of hashing it.  Handles handed out by the operating system
+ *  are small and dense (file descriptors on Linux, multiples of 4 on Windows), so
+ *  the table stays small and a lookup is a single indexed load.  The table grows
+ *  as larger handles are inserted.
+ *
+ * Each entry has a generation, which changes every time a value is inserted for
+ *  the handle.  A user that keeps a handle somewhere the table can't see (such as
+ *  in epoll data) can keep the generation along with it, and find(handle, generation)
+ *  will fail if the handle has since been erased and reused.
+ *
+ * Pointers returned by find are only valid until the next insert, which may
+ *  move the table.
+ */
+namespace lethe
+{
+  template <class T>
+  class HandleTable
+  {
+  public:
+    HandleTable() :
+      m_size(0)
+    {
+      // Do nothing
+    };
+
+    bool insert(Handle handle, const T& value)
+    {
+      size_t index = getIndex(handle);
+
+      if(index >= m_slots.size())
+        m_slots.resize(std::max(index + 1, m_slots.size() * 2));
+
+      Slot& slot = m_slots[index];
+
+      if(slot.used)
+        return false;
+
+      slot.value = value;
+      slot.handle = handle;
+      slot.used = true;
+      ++slot.generation;
+      ++m_size;
+      return true;
+    };
+
+    bool erase(Handle handle)
+    {
+      Slot* slot = getSlot(handle);
+
+      if(slot == NULL)
+        return false;
+
+      slot->value = T();
+      slot->used = false;
+      --m_size;
+      return true;
+    };
+
+    T* find(Handle handle)
+    {
+      Slot* slot = getSlot(handle);
+      return (slot != NULL) ? &slot->value : NULL;
+    };
+
+    const T* find(Handle handle) const
+    {
+      const Slot* slot = const_cast<HandleTable*>(this)->getSlot(handle);
+      return (slot != NULL) ? &slot->value : NULL;
+    };
+
+    T* find(Handle handle, uint32_t generation)
+    {
+      Slot* slot = getSlot(handle);
+      return (slot != NULL && slot->generation == generation) ? &slot->value : NULL;
+    };
+
+    uint32_t getGeneration(Handle handle) const
+    {
+      const Slot* slot = const_cast<HandleTable*>(this)->getSlot(handle);
+
+      if(slot == NULL)
+        throw std::invalid_argument("handle not in table");
+
+      return slot->generation;
+    };
+
+    // Returns the entry with the lowest index, for walking or emptying the table
+    T* front(Handle& handle)
+    {
+      for(size_t i = 0; i < m_slots.size(); ++i)
+      {
+        if(m_slots[i].used)
+        {
+          handle = m_slots[i].handle;
+          return &m_slots[i].value;
+        }
+      }
+
+      handle = INVALID_HANDLE_VALUE;
+      return NULL;
+    };
+
+    size_t size() const
+    {
+      return m_size;
+    };
+
+    bool empty() const
+    {
+      return (m_size == 0);
+    };
+
+  private:
+    struct Slot
+    {
+      Slot() : value(), handle(INVALID_HANDLE_VALUE), generation(0), used(false) { };
+
+      T value;
+      Handle handle;
+      uint32_t generation;
+      bool used;
+    };
+
+    static bool isValid(Handle handle)
+    {
+#if defined(__WIN32__) || defined(_WIN32)
+      return (handle != INVALID_HANDLE_VALUE);
+#else
+      return (handle >= 0);
+#endif
+    };
+
+    static size_t getIndex(Handle handle)
+    {
+      if(!isValid(handle))
+        throw std::invalid_argument("invalid handle");
+
+#if defined(__WIN32__) || defined(_WIN32)
+      return reinterpret_cast<uintptr_t>(handle) >> 2;
+#else
+      return static_cast<size_t>(handle);
+#endif
+    };
+
+    Slot* getSlot(Handle handle)
+    {
+      if(!isValid(handle))
+        return NULL;
+
+      size_t index = getIndex(handle);
+
+      if(index >= m_slots.size() || !m_slots[index].used)
+        return NULL;
+
+      return &m_slots[index];
+    };
+
+    std::vector<Slot> m_slots;
+    size_t m_size;
+  };
+}
+
+#endif
@@ -8,6 +8,8 @@
  */
 
 #include "WaitObject.h"
+#include "WaitHandler.h"
+#include "TimerHandler.h"
 #include "ByteStream.h"
 #include "MessageStream.h"
 
@@ -28,6 +30,11 @@
     class WindowsSemaphore;
     typedef WindowsSemaphore Semaphore;
 
+    // Windows handles can't be created lazily, so these are the kernel objects
+    typedef WindowsEvent FastEvent;
+    typedef WindowsMutex FastMutex;
+    typedef WindowsSemaphore FastSemaphore;
+
     class WindowsPipe;
     typedef WindowsPipe Pipe;
 
@@ -73,15 +80,51 @@
     class LinuxSemaphore;
     typedef LinuxSemaphore Semaphore;
 
+    class LinuxFastEvent;
+    typedef LinuxFastEvent FastEvent;
+
+    class LinuxFastMutex;
+    typedef LinuxFastMutex FastMutex;
+
+    class LinuxFastSemaphore;
+    typedef LinuxFastSemaphore FastSemaphore;
+
+    class LinuxRWLock;
+    typedef LinuxRWLock RWLock;
+
+    class LinuxConditionVariable;
+    typedef LinuxConditionVariable ConditionVariable;
+
+    class LinuxBarrier;
+    typedef LinuxBarrier Barrier;
+
+    class LinuxLatch;
+    typedef LinuxLatch Latch;
+
+    class LinuxEventGroup;
+    typedef LinuxEventGroup EventGroup;
+
     class LinuxPipe;
     typedef LinuxPipe Pipe;
 
     class LinuxTimer;
     typedef LinuxTimer Timer;
 
+    class LinuxTimerWheel;
+    typedef LinuxTimerWheel TimerWheel;
+
     class LinuxSharedMemory;
     typedef LinuxSharedMemory SharedMemory;
 
+    class LinuxProcessMutex;
+    typedef LinuxProcessMutex ProcessMutex;
+
+    class LinuxProcessSemaphore;
+    typedef LinuxProcessSemaphore ProcessSemaphore;
+
+    class LinuxProcessEvent;
+    typedef LinuxProcessEvent ProcessEvent;
+
     class LinuxAtomic32;
     class LinuxAtomic64;
 
@@ -95,9 +138,21 @@
   #include "linux/LinuxEvent.h"
   #include "linux/LinuxMutex.h"
   #include "linux/LinuxSemaphore.h"
+  #include "linux/LinuxFastEvent.h"
+  #include "linux/LinuxFastMutex.h"
+  #include "linux/LinuxFastSemaphore.h"
+  #include "linux/LinuxRWLock.h"
+  #include "linux/LinuxConditionVariable.h"
+  #include "linux/LinuxBarrier.h"
+  #include "linux/LinuxLatch.h"
+  #include "linux/LinuxEventGroup.h"
   #include "linux/LinuxPipe.h"
   #include "linux/LinuxTimer.h"
+  #include "linux/LinuxTimerWheel.h"
   #include "linux/LinuxSharedMemory.h"
+  #include "linux/LinuxProcessMutex.h"
+  #include "linux/LinuxProcessSemaphore.h"
+  #include "linux/LinuxProcessEvent.h"
   #include "linux/LinuxAtomic.h"
 
   namespace lethe
@@ -8,6 +8,7 @@
 
 #include <string>
 #include <vector>
+#include <chrono>
 #include "LetheTypes.h"
 
 #if defined(__WIN32__) || defined(_WIN32)
@@ -16,6 +17,7 @@
     // Operator to output a handle in Windows, since the base type is void*
     std::ostream& operator << (std::ostream& out, const Handle& handle);
     void sleep_ms(uint32_t timeout);
+    void sleep_ms(std::chrono::nanoseconds timeout);
   }
 
 #elif defined(__linux__)
@@ -25,6 +27,23 @@
   namespace lethe
   {
     void sleep_ms(uint32_t timeout);
+    void sleep_ms(std::chrono::nanoseconds timeout);
+
+    // The kernel objects used to implement Events, Mutexes, Semaphores and Timers.
+    //  LinuxBackendModules uses the lethe eventfd and timerfd modules,
+    //  LinuxBackendStock uses the eventfd and timerfd of a stock kernel with some
+    //  state kept in user space (see Limitations.txt), and LinuxBackendAuto (default)
+    //  uses the modules when their devices are present.  Changing the backend only
+    //  affects objects created afterwards.
+    enum LinuxBackend
+    {
+      LinuxBackendAuto,
+      LinuxBackendModules,
+      LinuxBackendStock
+    };
+
+    void setLinuxBackend(LinuxBackend backend);
+    LinuxBackend getLinuxBackend();
   }
 
 #else
@@ -40,6 +59,9 @@ namespace lethe
 
   // Returns the number of milliseconds since 12:00 AM Jan 1, 1970
   uint64_t    getTime();
+  // Returns the number of nanoseconds since an arbitrary point (usually boot), this
+  //  clock is not affected by changes to the system time and is used for all timeouts
+  uint64_t    getMonotonicTime();
   // Returns the current time of day as a string, format: "Month Day Hours:Minutes:Seconds:Milliseconds"
   std::string getTimeString();
 
@@ -57,9 +79,22 @@ namespace lethe
 
   class WaitObject;
 
-  // Waits for a single WaitObject to trigger
+  // Waits for a single WaitObject to trigger.  Timeouts may be given in ms, or as a
+  //  std::chrono duration to wait with the full resolution of the platform (ns on
+  //  Linux, ms on Windows).  std::chrono::nanoseconds::max() is the same as INFINITE.
   WaitResult WaitForObject(WaitObject& obj, uint32_t timeout = INFINITE);
+  WaitResult WaitForObject(WaitObject& obj, std::chrono::nanoseconds timeout);
   WaitResult WaitForObject(Handle handle, uint32_t timeout = INFINITE);
+  WaitResult WaitForObject(Handle handle, std::chrono::nanoseconds timeout);
+
+  // Waits for all of the objects to trigger, and takes them together: either every
+  //  object is taken and WaitSuccess is returned, or none are.  Objects are not
+  //  held in any order while waiting, so two threads taking overlapping sets can't
+  //  deadlock.  Each object may only appear once.  On Linux, only objects whose
+  //  wait can be undone (Mutex, Semaphore, FastMutex and FastSemaphore) may be
+  //  used, and std::invalid_argument is thrown for anything else.
+  WaitResult WaitForAllObjects(WaitObject** objects, uint32_t count, uint32_t timeout = INFINITE);
+  WaitResult WaitForAllObjects(WaitObject** objects, uint32_t count, std::chrono::nanoseconds timeout);
 
   // Returns a string-explanation of the last error to occur from a system call
   std::string lastError();
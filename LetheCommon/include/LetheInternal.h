@@ -2,6 +2,9 @@
 #define _LETHEINTERNAL_H
 
 #include "LetheTypes.h"
+#include <string>
+#include <chrono>
+#include <time.h>
 
 // Common Lethe stuff to not expose to users
 
@@ -14,14 +17,47 @@
 
 namespace lethe
 {
-  // Returns the absolute end time from the current time based on the timeout (in ms)
+  // End times are in nanoseconds of getMonotonicTime(), so they are not affected by
+  //  changes to the system clock.  A timeout of INFINITE (or nanoseconds::max())
+  //  gives INFINITE_END_TIME.
+  const uint64_t INFINITE_END_TIME = static_cast<uint64_t>(-1);
+
+  // Returns the absolute end time from the current time based on the timeout
   uint64_t getEndTime(uint32_t timeout);
-  // Returns the difference between the current time and end time (in ms)
-  uint64_t getTimeout(uint64_t endTime);
+  uint64_t getEndTime(std::chrono::nanoseconds timeout);
+  // Returns the time left until the end time in ms, rounded up so a wait never
+  //  returns before the end time
+  uint32_t getTimeout(uint64_t endTime);
+  // Returns the time left until the end time in ns
+  uint64_t getTimeoutNs(uint64_t endTime);
+
+  // Waits for a single handle until the end time, used by WaitObject::waitUntil
+  WaitResult waitForHandle(Handle handle, uint64_t endTime);
+  // Sleeps until the end time
+  void sleepUntil(uint64_t endTime);
+  // Waits for and takes all of the objects until the end time, used by WaitForAllObjects
+  class WaitObject;
+  WaitResult waitForAllObjects(WaitObject** objects, uint32_t count, uint64_t endTime);
 
   #if defined(__linux__)
   // Helper function to set close-on-exec for a linux Handle
   bool setCloseOnExec(Handle handle);
+
+  // Converts an end time to a timespec of the same clock (CLOCK_MONOTONIC)
+  void getEndTimespec(uint64_t endTime, timespec& endTimespec);
+  // Converts the time left until an end time to a timespec, returns NULL for
+  //  INFINITE_END_TIME so the result may be passed straight to ppoll and friends
+  timespec* getTimeoutTimespec(uint64_t endTime, timespec& timeout);
+
+  // Helper functions for futexes.  futexWait sleeps while the value at address is
+  //  still value, and returns false if the end time passed first.  Futexes are
+  //  process-private unless processShared is set (for words in shared memory).
+  bool futexWait(volatile uint32_t* address, uint32_t value, uint64_t endTime, bool processShared = false);
+  void futexWake(volatile uint32_t* address, uint32_t count, bool processShared = false);
+
+  // Returns true if objects should be created with the lethe module for the given
+  //  device, according to the selected LinuxBackend
+  bool useLetheModule(const std::string& device);
   #endif
 }
 
@@ -22,9 +22,17 @@
     typedef HANDLE Handle;
   }
 
+  // Scatter/gather buffer descriptor, as declared in <sys/uio.h> on Linux
+  struct iovec
+  {
+    void* iov_base;
+    size_t iov_len;
+  };
+
 #elif defined(__linux__)
 
   #include <stdint.h>
+  #include <sys/uio.h>
 
   namespace lethe
   {
@@ -48,6 +56,39 @@ namespace lethe
     WaitAbandoned = -2,
     WaitTimeout = -3
   };
+
+  // Conditions a WaitSet will wait for on a handle, these may be combined.  Errors
+  //  are always reported, WaitHangup adds the peer shutting down its side of a socket.
+  enum WaitInterest
+  {
+    WaitReadable = 0x1,
+    WaitWritable = 0x2,
+    WaitHangup = 0x4
+  };
+
+  // Order in which a WaitSet hands out the handles that were ready at the same time
+  enum WaitPolicy
+  {
+    WaitPolicyInOrder,
+    WaitPolicyRoundRobin,
+    WaitPolicyPriority,
+    WaitPolicyWeighted
+  };
+
+  // Which side an RWLock lets in first when both readers and writers are waiting
+  enum RWLockPolicy
+  {
+    RWLockPreferReaders,
+    RWLockPreferWriters,
+    RWLockFair
+  };
+
+  // How a Mutex treats the priority of the threads waiting for it
+  enum MutexProtocol
+  {
+    MutexDefault,
+    MutexPriorityInheritance
+  };
 }
 
 #endif
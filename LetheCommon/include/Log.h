@@ -164,7 +164,7 @@ namespace lethe
       std::ofstream m_out;
     };
 
-    Mutex m_mutex;
+    FastMutex m_mutex;
     Level m_logLevel;
     Level m_statementLevel;
     std::stringstream m_statement;
@@ -0,0 +1,29 @@
+#ifndef _TIMERHANDLER_H
+#define _TIMERHANDLER_H
+
+#include "LetheTypes.h"
+
+namespace lethe
+{
+  // Identifies a timer scheduled on a TimerWheel, 0 is never a valid id
+  typedef uint64_t TimerId;
+
+  /**
+   * The TimerHandler class is an interface for objects that receive the timers
+   *  scheduled on a TimerWheel.
+   *
+   * handleTimer() - called once when the timer expires, with the id returned when
+   *   it was scheduled and the userData given along with it.  The timer is
+   *   finished by the time this is called, so it may be scheduled again from here.
+   */
+  class TimerHandler
+  {
+  public:
+    TimerHandler();
+    virtual ~TimerHandler();
+
+    virtual void handleTimer(TimerId id, void* userData) = 0;
+  };
+}
+
+#endif
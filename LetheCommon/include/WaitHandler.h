@@ -0,0 +1,47 @@
+#ifndef _WAITHANDLER_H
+#define _WAITHANDLER_H
+
+#include "LetheTypes.h"
+
+namespace lethe
+{
+  class WaitObject;
+  class WaitHandler;
+
+  /**
+   * The WaitEvent structure describes a single result received from a WaitSet.
+   *  The handler and userData are the values given when the WaitObject was added
+   *  to the WaitSet (NULL if it was added without a handler), so a user does not
+   *  need to look up what a handle belongs to.  events holds the WaitInterest
+   *  flags that are ready, an object with separate read and write handles may be
+   *  reported once for each.
+   */
+  struct WaitEvent
+  {
+    WaitObject* object;
+    Handle handle;
+    WaitResult result;
+    uint32_t events;
+    WaitHandler* handler;
+    void* userData;
+  };
+
+  /**
+   * The WaitHandler class is an interface for objects that receive the results of
+   *  WaitObjects registered with a WaitSet (or a Thread) along with a handler.
+   *
+   * handleWait() - called with the result each time the registered WaitObject
+   *   triggers or errors.  The event refers to the WaitSet's own copy, so it is
+   *   only valid until handleWait returns.
+   */
+  class WaitHandler
+  {
+  public:
+    WaitHandler();
+    virtual ~WaitHandler();
+
+    virtual void handleWait(const WaitEvent& event) = 0;
+  };
+}
+
+#endif
@@ -6,9 +6,12 @@
 
 namespace lethe
 {
-  // Prototypes of WaitSets for friending purposes
+  // Prototypes of classes for friending purposes
   class WindowsWaitSet;
   class LinuxWaitSet;
+  class LinuxFastObject;
+  class LinuxAdaptiveSpin;
+  class LinuxTimerWheel;
 
   /**
    * The WaitObject class provides the framework for cross-thread and cross-
@@ -20,10 +23,42 @@ namespace lethe
    *   On Windows, this is a HANDLE (void*), and on Linux, this is a file
    *   descriptor (int).
    *
+   * getWriteHandle() - returns the handle used when waiting for the object to
+   *   become writable.  This is the same as getHandle(), except for objects such
+   *   as pipes that use a separate handle for each direction.
+   *
+   * wait() - waits for the object to trigger, the same as WaitForObject.
+   *
+   * waitUntil() - called by wait() with the end time of the wait (see
+   *   getMonotonicTime, INFINITE_END_TIME for no timeout).  Objects that can be
+   *   waited on without a handle override this.
+   *
    * setHandle() - used if the Handle of the WaitObject is not known at
    *   construction of the base class, changes the handle that will be used.
    *   To avoid problems, this should never be used after the derived object
-   *   has finished construction.
+   *   has finished construction, except from prepareHandle().
+   *
+   * prepareHandle() - called by WaitSets before the handle of an object is
+   *   added.  Objects that work without a handle until they are added to a
+   *   WaitSet (such as FastEvent) create their handle here.
+   *
+   * finishWait() - called by WaitSets and wait() when the handle of the object
+   *   is found readable.  Objects whose handle is not consumed by the wait itself
+   *   (such as objects of the stock Linux backend) consume it here, and return
+   *   false if another waiter got to it first so the wakeup is ignored.  The
+   *   result may be changed to WaitAbandoned to report an error.
+   *
+   * canUndoWait() - returns true for objects whose successful wait takes
+   *   something that undoWait() can give back (Mutex, Semaphore and their Fast
+   *   variants).  Only these can be used with WaitForAllObjects on Linux.
+   *
+   * undoWait() - gives back what one successful wait took, so WaitForAllObjects
+   *   can back off without holding anything.
+   *
+   * tryAcquire() - takes the object if its state in user space shows that it is
+   *   available, and returns true with the result of the wait.  Returns false,
+   *   without a system call, if the object is taken or keeps no state in user
+   *   space.  LinuxAdaptiveSpin retries this while spinning.
    *
    */
   class WaitObject
@@ -33,9 +68,26 @@ namespace lethe
     virtual ~WaitObject();
 
     Handle getHandle() const;
+    virtual Handle getWriteHandle() const;
+
+    WaitResult wait(uint32_t timeout);
+    WaitResult wait(std::chrono::nanoseconds timeout);
 
   protected:
+    friend class WindowsWaitSet;
+    friend class LinuxWaitSet;
+    friend class LinuxFastObject;
+    friend class LinuxAdaptiveSpin;
+    friend class LinuxTimerWheel;
+    friend WaitResult waitForAllObjects(WaitObject** objects, uint32_t count, uint64_t endTime);
+
+    virtual WaitResult waitUntil(uint64_t endTime);
     void setHandle(Handle handle);
+    virtual void prepareHandle();
+    virtual bool finishWait(WaitResult& result);
+    virtual bool canUndoWait() const;
+    virtual void undoWait();
+    virtual bool tryAcquire(WaitResult& result);
 
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
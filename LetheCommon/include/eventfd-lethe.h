@@ -21,5 +21,23 @@ enum eventfd_mode_t
 #define EFD_SET_MAX_VALUE _IOW(EVENTFD_LETHE_MAJOR, 4, unsigned long)
 #define EFD_SET_ERROR _IOW(EVENTFD_LETHE_MAJOR, 5, bool)
 #define EFD_GET_MODE _IO(EVENTFD_LETHE_MAJOR, 6)
+#define EFD_ACQUIRE _IOW(EVENTFD_LETHE_MAJOR, 7, unsigned long)
+#define EFD_ACQUIRE_UP_TO _IOW(EVENTFD_LETHE_MAJOR, 8, unsigned long)
+#define EFD_ACQUIRE_WAIT _IOW(EVENTFD_LETHE_MAJOR, 9, struct eventfd_acquire_wait)
+
+// Parameter of EFD_ACQUIRE_WAIT, which sleeps until the whole count can be taken
+//  from a semaphore, or the end time (CLOCK_MONOTONIC, in nanoseconds) passes
+struct eventfd_acquire_wait
+{
+  unsigned long long end_time; // EFD_WAIT_FOREVER for no timeout
+  unsigned int count;
+  unsigned int padding;
+};
+
+#define EFD_WAIT_FOREVER (~0ULL)
+
+// Event bit registered with epoll so that polling a waitread object (eventfd-lethe or
+//  timerfd-lethe) only checks its state instead of consuming it (same value as POLLMSG)
+#define LETHE_POLL_PEEK 0x400
 
 #endif
@@ -0,0 +1,77 @@
+#ifndef _LINUXADAPTIVESPIN_H
+#define _LINUXADAPTIVESPIN_H
+
+#include "LetheTypes.h"
+#include "WaitObject.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxAdaptiveSpin class decides how long a thread should keep retrying a
+ *  contended lock before going to sleep in the kernel.  When the lock is released
+ *  within the spin, the handoff avoids a sleep and a wakeup, at the cost of some
+ *  cycles on the waiting core.  Mutexes and Semaphores (fast or not) each have one,
+ *  see their getSpin().
+ *
+ * getSpinCount() - returns the number of retries to make before blocking.  This is
+ *   twice the number of retries that recently succeeded, plus s_minSpins, so the
+ *   budget follows how long the lock is usually held.  Spins that fail shrink the
+ *   estimate, so a lock held for long periods goes back to blocking right away.
+ *   The count never goes over the limit, and is 0 if the limit is 0 or there is
+ *   only one processor.
+ * record() - reports the outcome of a spin, and the number of retries made.
+ * spin() - retries the object's tryAcquire(), up to getSpinCount() times or
+ *   until the end time, and records the outcome.  Returns true with the result of
+ *   the wait if the object was acquired (or abandoned).  tryAcquire() only looks
+ *   at state in user space, so spinning makes no system calls while the object
+ *   is taken.  Objects that keep their state in the kernel (those using the
+ *   eventfd-lethe module) can't be spun on, and block right away.
+ * pause() - called between retries, backs off exponentially (up to s_maxPause
+ *   cpu pause instructions) to ease the load on the lock's cache line.
+ * setLimit() - changes the most retries a spin may make, 0 disables spinning.
+ * getSuccessCount() / getFailureCount() - the number of spins that did / did not
+ *   see the lock released before giving up.
+ * setDefaultLimit() - changes the limit given to objects created afterwards
+ *   (s_initialLimit to start with).
+ */
+namespace lethe
+{
+  class LinuxAdaptiveSpin
+  {
+  public:
+    LinuxAdaptiveSpin();
+    ~LinuxAdaptiveSpin();
+
+    uint32_t getSpinCount() const;
+    void record(bool succeeded, uint32_t spins);
+    bool spin(WaitObject& obj, uint64_t endTime, WaitResult& result);
+    static void pause(uint32_t spin);
+
+    void setLimit(uint32_t limit);
+    uint32_t getLimit() const;
+
+    uint64_t getSuccessCount() const;
+    uint64_t getFailureCount() const;
+
+    static void setDefaultLimit(uint32_t limit);
+    static uint32_t getDefaultLimit();
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxAdaptiveSpin(const LinuxAdaptiveSpin&);
+    LinuxAdaptiveSpin& operator = (const LinuxAdaptiveSpin&);
+
+    static bool isMultiprocessor();
+
+    static const uint32_t s_initialLimit;
+    static const uint32_t s_minSpins;
+    static const uint32_t s_maxPause;
+    static std::atomic<uint32_t> s_defaultLimit;
+
+    std::atomic<uint32_t> m_limit;
+    std::atomic<uint32_t> m_estimate; // Recent number of retries needed, in 1/8ths
+    std::atomic<uint64_t> m_successCount;
+    std::atomic<uint64_t> m_failureCount;
+  };
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef _LINUXBARRIER_H
+#define _LINUXBARRIER_H
+
+#include "WaitObject.h"
+#include "LetheTypes.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxBarrier class holds a group of threads until all of them have
+ *  arrived, then releases them together and starts the next phase.  The phase
+ *  number and the number of threads arrived are kept in one atomic word, so
+ *  arriving is a single atomic operation, and the last thread to arrive wakes
+ *  everyone with a single system call.
+ *
+ * LinuxBarrier() - count is the number of arrivals that complete a phase, from 1
+ *   to s_maxCount.
+ * arrive() - arrives without waiting, and returns the phase arrived in.
+ * arriveAndWait() - arrives, and waits for the phase to complete.  If the timeout
+ *   expires first, the arrival is taken back and WaitTimeout is returned.
+ * getPhase() - returns the current phase, which wraps at s_maxPhase.
+ *
+ * As a WaitObject, the barrier triggers when the current phase completes,
+ *  without arriving, so a thread that hands out the work of each phase (such as
+ *  a BaseThread with the barrier in its WaitSet) can be told when it is done.
+ *  Once added to a WaitSet, the barrier gets an eventfd which is signaled on each
+ *  completion and reset by the wait that returns it, like an auto-reset Event.
+ *
+ * The barrier is only used within a single process.
+ */
+namespace lethe
+{
+  class LinuxBarrier : public WaitObject
+  {
+  public:
+    explicit LinuxBarrier(uint32_t count);
+    ~LinuxBarrier();
+
+    uint32_t arrive();
+    WaitResult arriveAndWait(uint32_t timeout = INFINITE);
+    WaitResult arriveAndWait(std::chrono::nanoseconds timeout);
+
+    uint32_t getCount() const;
+    uint32_t getPhase() const;
+
+    static const uint32_t s_maxCount;
+    static const uint32_t s_maxPhase;
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxBarrier(const LinuxBarrier&);
+    LinuxBarrier& operator = (const LinuxBarrier&);
+
+    WaitResult waitUntil(uint64_t endTime);
+    void prepareHandle();
+    bool finishWait(WaitResult& result);
+
+    bool arrive(uint32_t& phase);
+    WaitResult arriveAndWaitUntil(uint64_t endTime);
+    bool waitPhase(uint32_t phase, uint64_t endTime);
+
+    static const uint32_t s_phaseShift;
+
+    const uint32_t m_count;
+    std::atomic<uint32_t> m_state; // The phase, and the number arrived in it
+    std::atomic<uint32_t> m_waiters; // Threads sleeping on m_state
+    std::atomic<int> m_handle; // The eventfd signaled on completion, once created
+  };
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef _LINUXCONDITIONVARIABLE_H
+#define _LINUXCONDITIONVARIABLE_H
+
+#include "LetheTypes.h"
+#include "LetheFunctions.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxConditionVariable class lets threads holding a Mutex (or FastMutex)
+ *  sleep until another thread signals that the state protected by the mutex has
+ *  changed.
+ *
+ * wait() - unlocks the mutex and sleeps until the condition variable is signaled
+ *   or the timeout expires, then locks the mutex again (without a timeout) before
+ *   returning WaitSuccess or WaitTimeout.  The mutex must be locked exactly once
+ *   by the calling thread, since unlocking a recursive lock only releases one
+ *   level of it, and the wait would sleep with the mutex held.  If the mutex is
+ *   locked more than once, std::logic_error is thrown.  The lock count of a Mutex
+ *   using the eventfd-lethe module is kept in the kernel and can't be checked,
+ *   so with the module, waiting with a recursive lock deadlocks instead.  Waits
+ *   may also end without a signal, so the state should be checked again in a
+ *   loop.
+ * signal() - wakes one waiting thread.
+ * broadcast() - wakes every waiting thread with a single system call.
+ *
+ * Signals are not remembered, a thread that starts waiting after a signal is not
+ *  woken by it.  Neither call makes a system call when nobody is waiting.
+ *
+ * The condition variable sleeps on a futex, so it has no handle and can't be
+ *  used with WaitSets, and can only be used within a single process.
+ */
+namespace lethe
+{
+  class LinuxMutex;
+  class LinuxFastMutex;
+
+  class LinuxConditionVariable
+  {
+  public:
+    LinuxConditionVariable();
+    ~LinuxConditionVariable();
+
+    WaitResult wait(LinuxMutex& mutex, uint32_t timeout = INFINITE);
+    WaitResult wait(LinuxMutex& mutex, std::chrono::nanoseconds timeout);
+    WaitResult wait(LinuxFastMutex& mutex, uint32_t timeout = INFINITE);
+    WaitResult wait(LinuxFastMutex& mutex, std::chrono::nanoseconds timeout);
+
+    void signal();
+    void broadcast();
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxConditionVariable(const LinuxConditionVariable&);
+    LinuxConditionVariable& operator = (const LinuxConditionVariable&);
+
+    template <typename MutexType>
+    WaitResult waitUntil(MutexType& mutex, uint64_t endTime);
+    void wake(uint32_t count);
+
+    std::atomic<uint32_t> m_sequence; // Changed by every wake, the futex word
+    std::atomic<uint32_t> m_waiters;
+  };
+}
+
+#endif
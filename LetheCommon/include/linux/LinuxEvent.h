@@ -2,16 +2,18 @@
 #define _LINUXEVENT_H
 
 #include "WaitObject.h"
+#include <cstdatomic>
 
 /*
  * The LinuxEvent class provides a waitable event wrapper class for Linux.
  *  When the event is set, it will wake up any thread waiting on the handle until
  *  it is reset.
  *
- * In the future, this will be extended to add a boolean parameter to have the
- *  event automatically reset upon waking up a thread.  This requires a change to
- *  the eventfd subsystem in Linux, and a kernel module is under development for
- *  this purpose.
+ * Auto-reset events use the eventfd-lethe kernel module, so that waking up a
+ *  thread resets the event.  Without the module (see setLinuxBackend), a stock
+ *  eventfd is used, and the event is reset by whoever is woken by it, so a waiter
+ *  may be woken and find that another waiter already got the event.  This is
+ *  handled by wait() and WaitSets, but not by WaitForObject on the raw handle.
  */
 namespace lethe
 {
@@ -37,7 +39,13 @@ namespace lethe
     friend class LinuxHandleTransfer;
     LinuxEvent(Handle handle);
 
+    bool finishWait(WaitResult& result);
+
     static const std::string s_eventfdDevice;
+
+    bool m_stock; // Created with a stock eventfd
+    bool m_autoReset;
+    std::atomic<bool> m_error;
   };
 }
 
@@ -0,0 +1,80 @@
+#ifndef _LINUXEVENTGROUP_H
+#define _LINUXEVENTGROUP_H
+
+#include "WaitObject.h"
+#include "LetheTypes.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxEventGroup class holds 64 flag bits which can be set, cleared and
+ *  waited on together, so a thread with many flags needs one object (and one
+ *  handle) instead of one Event per flag.  The bits are kept in an atomic word,
+ *  and a set that changes them wakes every waiting thread with a single system
+ *  call.
+ *
+ * set() - sets the bits in mask.
+ * clear() - clears the bits in mask.
+ * getBits() - returns the bits currently set.
+ * waitAny() - waits for any of the bits in mask to be set.
+ * waitAll() - waits for all of the bits in mask to be set.
+ *   Both return the bits of mask that were set, or 0 if the timeout expired.  If
+ *   clear is true, the returned bits are cleared in the same atomic operation,
+ *   so each setting of a bit is seen by only one waiter.
+ *
+ * As a WaitObject (with WaitForObject or a WaitSet), the group waits on the bits
+ *  given to setWaitMask(), which defaults to any of the 64 bits without
+ *  clearing them.  Once added to a WaitSet, the group gets an eventfd, which is
+ *  signaled when the bits match.  The bits that fired are kept for
+ *  getFiredBits(), so one readiness notification reports all of them.  While
+ *  the bits still match after the wait, the eventfd stays signaled, like a
+ *  manual-reset Event.
+ *
+ * The group is only used within a single process.
+ */
+namespace lethe
+{
+  class LinuxEventGroup : public WaitObject
+  {
+  public:
+    explicit LinuxEventGroup(uint64_t initialBits = 0);
+    ~LinuxEventGroup();
+
+    void set(uint64_t mask);
+    void clear(uint64_t mask);
+    uint64_t getBits() const;
+
+    uint64_t waitAny(uint64_t mask, uint32_t timeout = INFINITE, bool clear = false);
+    uint64_t waitAny(uint64_t mask, std::chrono::nanoseconds timeout, bool clear = false);
+    uint64_t waitAll(uint64_t mask, uint32_t timeout = INFINITE, bool clear = false);
+    uint64_t waitAll(uint64_t mask, std::chrono::nanoseconds timeout, bool clear = false);
+
+    void setWaitMask(uint64_t mask, bool all = false, bool clear = false);
+    uint64_t getFiredBits() const;
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxEventGroup(const LinuxEventGroup&);
+    LinuxEventGroup& operator = (const LinuxEventGroup&);
+
+    WaitResult waitUntil(uint64_t endTime);
+    void prepareHandle();
+    bool finishWait(WaitResult& result);
+
+    uint64_t takeBits(uint64_t mask, bool all, bool clear);
+    uint64_t waitBits(uint64_t mask, bool all, bool clear, uint64_t endTime);
+    bool waitMaskMatches();
+    void signalHandle(int handle);
+
+    std::atomic<uint64_t> m_bits;
+    std::atomic<uint32_t> m_sequence; // The futex word, changed whenever bits are set
+    std::atomic<uint32_t> m_waiters; // Threads sleeping on m_sequence
+    std::atomic<int> m_handle; // The eventfd signaled when the wait mask matches, once created
+
+    std::atomic<uint64_t> m_waitMask; // The bits waited on as a WaitObject
+    std::atomic<bool> m_waitAll;
+    std::atomic<bool> m_waitClear;
+    std::atomic<uint64_t> m_firedBits; // The bits returned by the last wait as a WaitObject
+  };
+}
+
+#endif
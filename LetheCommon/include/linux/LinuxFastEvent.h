@@ -0,0 +1,40 @@
+#ifndef _LINUXFASTEVENT_H
+#define _LINUXFASTEVENT_H
+
+#include "linux/LinuxFastObject.h"
+
+/*
+ * The LinuxFastEvent class has the same interface as LinuxEvent, but is kept in
+ *  user space until it is added to a WaitSet (see LinuxFastObject).  Setting an
+ *  event that is already set, resetting an event that is not set, and waiting
+ *  on a set event do not make a system call, and waking waiters only does when
+ *  there are any.
+ *
+ * Since there is no handle to transfer, a LinuxFastEvent can only be used within
+ *  a single process.
+ */
+namespace lethe
+{
+  class LinuxFastEvent : public LinuxFastObject
+  {
+  public:
+    LinuxFastEvent(bool initialState, bool autoReset);
+    ~LinuxFastEvent();
+
+    void set();
+    void reset();
+    void error();
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxFastEvent(const LinuxFastEvent&);
+    LinuxFastEvent& operator = (const LinuxFastEvent&);
+
+    WaitResult waitUntil(uint64_t endTime);
+    WaitObject* createKernelObject(uint32_t state);
+
+    bool m_autoReset;
+  };
+}
+
+#endif
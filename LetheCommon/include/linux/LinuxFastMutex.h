@@ -0,0 +1,59 @@
+#ifndef _LINUXFASTMUTEX_H
+#define _LINUXFASTMUTEX_H
+
+#include "linux/LinuxFastObject.h"
+#include <pthread.h>
+
+/*
+ * The LinuxFastMutex class has the same interface as LinuxMutex, but is kept in
+ *  user space until it is added to a WaitSet (see LinuxFastObject).  Locking an
+ *  unlocked mutex and unlocking a mutex nobody is waiting for do not make a
+ *  system call.  Like LinuxMutex, the mutex may be locked several times by the
+ *  thread that owns it, and only the owner may unlock it.
+ *
+ * The kernel object can only be created with the calling thread as the owner,
+ *  so adding the mutex to a WaitSet while another thread has it locked throws
+ *  std::logic_error.
+ *
+ * Since there is no handle to transfer, a LinuxFastMutex can only be used within
+ *  a single process.
+ *
+ * A waiter spins on the state in user space before sleeping on the futex (see
+ *  LinuxAdaptiveSpin).  Once the object has moved to the kernel, getSpin()
+ *  returns the spin of the kernel object, which starts with the same limit.
+ */
+namespace lethe
+{
+  class LinuxFastMutex : public LinuxFastObject
+  {
+  public:
+    explicit LinuxFastMutex(bool locked);
+    ~LinuxFastMutex();
+
+    void lock(uint32_t timeout = INFINITE);
+    void unlock();
+    void error();
+
+    LinuxAdaptiveSpin& getSpin();
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxFastMutex(const LinuxFastMutex&);
+    LinuxFastMutex& operator = (const LinuxFastMutex&);
+
+    // Allow LinuxConditionVariable to refuse a mutex it can't fully unlock
+    friend class LinuxConditionVariable;
+    bool isLockedRecursively();
+
+    WaitResult waitUntil(uint64_t endTime);
+    WaitObject* createKernelObject(uint32_t state);
+    bool canUndoWait() const;
+    void undoWait();
+
+    std::atomic<pthread_t> m_owner; // The thread holding the lock, or 0
+    uint32_t m_lockCount; // The number of locks held by the owner
+    LinuxAdaptiveSpin m_spin;
+  };
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef _LINUXFASTOBJECT_H
+#define _LINUXFASTOBJECT_H
+
+#include "WaitObject.h"
+#include "LetheTypes.h"
+#include "linux/LinuxAdaptiveSpin.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxFastObject class is the base of the FastEvent, FastMutex and
+ *  FastSemaphore classes.  The state of the object is kept in an atomic word in
+ *  user space, so operations that don't need to block are done without a system
+ *  call, and blocked threads sleep on the word with a futex.
+ *
+ * No file descriptor is opened until the object is added to a WaitSet (or
+ *  error() is called).  At that point, the current state is copied into a kernel
+ *  object of the matching type, and every later operation is passed on to it, so
+ *  objects used with WaitSets behave exactly like Event, Mutex and Semaphore.
+ *  Threads blocked on the futex at the time are woken and wait on the handle
+ *  instead.
+ *
+ * Derived classes keep their state in the low bits (below s_kernelBit and
+ *  s_promotingBit), and change it with loadState and updateState:
+ * loadState() - returns the current state, with s_kernelBit set if the object
+ *   has moved to the kernel.  If the move is in progress, this waits for it.
+ * updateState() - atomically replaces state with newState, if the state has not
+ *   changed since it was loaded.  Otherwise, the current state is loaded into
+ *   state and false is returned.
+ * spinState() - spins (see LinuxAdaptiveSpin) until the state is no longer state,
+ *   and returns the new state, or state if the spin gave up.
+ * waitState() - sleeps until the state is no longer state, returns false if the
+ *   end time passed first.
+ * wakeWaiters() - wakes up to count threads sleeping in waitState.
+ * waitKernelObject() - waits on the kernel object once the object has moved to
+ *   the kernel.
+ */
+namespace lethe
+{
+  class LinuxFastObject : public WaitObject
+  {
+  public:
+    virtual ~LinuxFastObject();
+
+  protected:
+    explicit LinuxFastObject(uint32_t state);
+
+    uint32_t loadState();
+    bool updateState(uint32_t& state, uint32_t newState);
+    uint32_t spinState(uint32_t state, uint64_t endTime, LinuxAdaptiveSpin& spin);
+    bool waitState(uint32_t state, uint64_t endTime);
+    void wakeWaiters(uint32_t count);
+
+    void prepareHandle();
+    bool finishWait(WaitResult& result);
+    virtual WaitObject* createKernelObject(uint32_t state) = 0;
+    WaitObject* getKernelObject() const;
+    WaitResult waitKernelObject(uint64_t endTime);
+
+    static const uint32_t s_kernelBit; // The object has moved to the kernel
+    static const uint32_t s_promotingBit; // The object is moving to the kernel
+    static const uint32_t s_stateMask; // The bits available to derived classes
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxFastObject(const LinuxFastObject&);
+    LinuxFastObject& operator = (const LinuxFastObject&);
+
+    std::atomic<uint32_t> m_state;
+    std::atomic<uint32_t> m_waiters; // The number of threads sleeping on m_state
+    WaitObject* m_kernelObject;
+  };
+}
+
+#endif
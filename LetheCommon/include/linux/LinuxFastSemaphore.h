@@ -0,0 +1,62 @@
+#ifndef _LINUXFASTSEMAPHORE_H
+#define _LINUXFASTSEMAPHORE_H
+
+#include "linux/LinuxFastObject.h"
+
+/*
+ * The LinuxFastSemaphore class has the same interface as LinuxSemaphore, but is
+ *  kept in user space until it is added to a WaitSet (see LinuxFastObject).
+ *  Locking a semaphore with a nonzero count and unlocking one nobody is waiting
+ *  for do not make a system call.  The maximum count is limited to
+ *  s_maxCount (2^30 - 1).
+ *
+ * Since there is no handle to transfer, a LinuxFastSemaphore can only be used
+ *  within a single process.
+ *
+ * A waiter spins on the state in user space before sleeping on the futex (see
+ *  LinuxAdaptiveSpin).  Once the object has moved to the kernel, getSpin()
+ *  returns the spin of the kernel object, which starts with the same limit.
+ *
+ * The batch operations of LinuxSemaphore (lock(count, timeout), lockUpTo(),
+ *  tryLock() and tryLockUpTo()) take their count with a single atomic operation.
+ *  While anyone is waiting for a batch, unlock() wakes every waiter instead of
+ *  count of them, since the waiters woken may each need a different count.
+ */
+namespace lethe
+{
+  class LinuxFastSemaphore : public LinuxFastObject
+  {
+  public:
+    LinuxFastSemaphore(uint32_t maxCount, uint32_t initialCount);
+    ~LinuxFastSemaphore();
+
+    void lock(uint32_t timeout = INFINITE);
+    void lock(uint32_t count, uint32_t timeout);
+    uint32_t lockUpTo(uint32_t count, uint32_t timeout = INFINITE);
+    bool tryLock(uint32_t count = 1);
+    uint32_t tryLockUpTo(uint32_t count);
+    void unlock(uint32_t count);
+    void error();
+
+    LinuxAdaptiveSpin& getSpin();
+
+    static const uint32_t s_maxCount;
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxFastSemaphore(const LinuxFastSemaphore&);
+    LinuxFastSemaphore& operator = (const LinuxFastSemaphore&);
+
+    WaitResult waitUntil(uint64_t endTime);
+    WaitObject* createKernelObject(uint32_t state);
+    bool canUndoWait() const;
+    void undoWait();
+    uint32_t lockUntil(uint32_t count, bool upTo, uint64_t endTime);
+
+    uint32_t m_maxCount;
+    std::atomic<uint32_t> m_batchWaiters; // Threads waiting in lockUntil
+    LinuxAdaptiveSpin m_spin;
+  };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef _LINUXLATCH_H
+#define _LINUXLATCH_H
+
+#include "WaitObject.h"
+#include "LetheTypes.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxLatch class is a countdown latch, which triggers once it has been
+ *  counted down to zero, and stays triggered from then on.  The count is kept in
+ *  an atomic word, and the count down that reaches zero wakes every waiting
+ *  thread with a single system call.
+ *
+ * countDown() - takes count from the latch, counting down past zero throws
+ *   std::logic_error.
+ * getCount() - returns the count left.
+ *
+ * Waiting on the latch (with WaitForObject or a WaitSet) does not change it.
+ *  Once added to a WaitSet, the latch gets an eventfd, which is signaled when it
+ *  reaches zero and never reset, so it behaves like a manual-reset Event.
+ *
+ * The latch is only used within a single process.
+ */
+namespace lethe
+{
+  class LinuxLatch : public WaitObject
+  {
+  public:
+    explicit LinuxLatch(uint32_t count);
+    ~LinuxLatch();
+
+    void countDown(uint32_t count = 1);
+    uint32_t getCount() const;
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxLatch(const LinuxLatch&);
+    LinuxLatch& operator = (const LinuxLatch&);
+
+    WaitResult waitUntil(uint64_t endTime);
+    void prepareHandle();
+    bool finishWait(WaitResult& result);
+
+    void signalHandle(int handle);
+
+    std::atomic<uint32_t> m_count; // The futex word
+    std::atomic<uint32_t> m_waiters; // Threads sleeping on m_count
+    std::atomic<int> m_handle; // The eventfd signaled at zero, once created
+  };
+}
+
+#endif
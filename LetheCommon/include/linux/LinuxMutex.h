@@ -2,24 +2,50 @@
 #define _LINUXMUTEX_H
 
 #include "WaitObject.h"
+#include "linux/LinuxAdaptiveSpin.h"
 #include "LetheTypes.h"
+#include <cstdatomic>
+#include <pthread.h>
 
 /*
  * The LinuxMutex class is extremely similar to LinuxSemaphore, being a
- *  semaphore with a maximum value of 1.
+ *  semaphore with a maximum value of 1.  The mutex may be locked several times
+ *  by the thread that owns it, and only the owner may unlock it.
+ *
+ * Without the eventfd-lethe module (see setLinuxBackend), a stock eventfd in
+ *  semaphore mode holds the lock and the owner is tracked in user space.  The
+ *  mutex is not abandoned when the owner closes it, the owner can't lock it
+ *  again through a WaitSet (lock() must be used), and it can't be transferred
+ *  to another process.
+ *
+ * A thread waiting for a locked stock mutex (through lock or WaitForObject)
+ *  spins on the owner kept in user space for a while before blocking, see
+ *  LinuxAdaptiveSpin and getSpin().  With the module, the lock is only in the
+ *  kernel, so a waiter blocks right away.
+ *
+ * With MutexPriorityInheritance, the mutex is a PI futex instead: the owner
+ *  runs at the priority of the highest priority thread waiting for it until it
+ *  unlocks, so a real-time thread can't be held up by lower priority threads
+ *  keeping the owner from running.  Locking and unlocking without contention
+ *  does not make a system call, and a waiter blocks right away, without
+ *  spinning.  There is no handle, so the mutex can't be added to a WaitSet
+ *  (std::logic_error is thrown) or transferred, and error() is not supported.
  */
 namespace lethe
 {
   class LinuxMutex : public WaitObject
   {
   public:
-    explicit LinuxMutex(bool locked);
+    explicit LinuxMutex(bool locked, MutexProtocol protocol = MutexDefault);
     ~LinuxMutex();
 
     void lock(uint32_t timeout = INFINITE);
     void unlock();
     void error();
 
+    LinuxAdaptiveSpin& getSpin();
+    MutexProtocol getProtocol() const;
+
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
     LinuxMutex(const LinuxMutex&);
@@ -29,7 +55,31 @@ namespace lethe
     friend class LinuxHandleTransfer;
     LinuxMutex(Handle handle);
 
+    // Allow LinuxConditionVariable (directly or through a LinuxFastMutex) to
+    //  refuse a mutex it can't fully unlock
+    friend class LinuxConditionVariable;
+    friend class LinuxFastMutex;
+    bool isLockedRecursively();
+
+    WaitResult waitUntil(uint64_t endTime);
+    void prepareHandle();
+    bool finishWait(WaitResult& result);
+    bool canUndoWait() const;
+    void undoWait();
+    bool tryAcquire(WaitResult& result);
+
+    WaitResult lockPriorityInheritance(uint64_t endTime);
+    void unlockPriorityInheritance();
+
     static const std::string s_eventfdDevice;
+
+    MutexProtocol m_protocol;
+    bool m_stock; // Created with a stock eventfd
+    std::atomic<bool> m_error;
+    std::atomic<pthread_t> m_owner; // The thread holding a stock mutex, or 0
+    uint32_t m_lockCount; // The number of locks held by the owner of a stock or PI mutex
+    std::atomic<uint32_t> m_piState; // The PI futex word, the owner's thread id and FUTEX_WAITERS
+    LinuxAdaptiveSpin m_spin;
   };
 }
 
@@ -6,14 +6,71 @@
 #include "ByteStream.h"
 #include "LetheTypes.h"
 #include <unistd.h>
-#include <aio.h>
+#include <vector>
+#include <deque>
 
 /*
  * The LinuxPipe class encapsulates an anonymous pipe in Linux.  The Handle
  *  of this object is a file descriptor to the read side of the pipe.  If a send
- *  fails outright, an exception will be thrown.  For a partly completed send,
- *  the unsent part is buffered and will be pushed through by subsequent send
- *  operations.
+ *  fails outright, an exception will be thrown.
+ *
+ * When the pipe can't take all of a send, the rest is queued in a ring buffer
+ *  belonging to the pipe, and queued data is written ahead of any later send.
+ *  Nothing works on the queue in the background, it is pushed through by later
+ *  sends and by flush().  To drain it from an event loop, wait for the pipe to
+ *  become writable (WaitWritable) and call flush(0), or add the flush object to
+ *  the WaitSet.
+ *
+ * flush() - writes queued data, waiting up to timeout for the pipe to become
+ *   writable, and returns false if some of it is still queued.
+ * getFlushObject() - returns a WaitObject that is signaled when nothing is
+ *   queued.  Waiting on it flushes the pipe, the same as flush().  In a WaitSet,
+ *   it wakes up whenever the pipe becomes writable and writes queued data, and
+ *   is only returned once the queue is empty.  A failed write is reported as
+ *   WaitAbandoned.  Like send(), it must only be used by the sending thread.
+ * setSendCapacity() - sets the number of bytes that may be copied into the
+ *   queue, which is s_defaultSendCapacity to begin with.  A send that doesn't fit
+ *   throws std::bad_alloc without sending anything.  A send is always accepted
+ *   when nothing is copied in the queue, so a single send may be larger than the
+ *   capacity.
+ * getQueuedSize() - returns the number of bytes queued.
+ *
+ * sendv() and receivev() use writev and readv, so a header and payload go out
+ *  in one system call without being copied together first.
+ *
+ * sendZeroCopy() - sends a buffer with vmsplice, so the pipe refers to the pages
+ *   of the buffer instead of copying them.  If the pipe can't take all of it, the
+ *   rest is queued by reference, not copied, and doesn't count against the send
+ *   capacity.  The buffer still belongs to the pipe after the call returns: it
+ *   must not be changed or freed until isReleased() returns true for the
+ *   position returned by sendZeroCopy().  A buffer is released once everything
+ *   up to its end has been read out of the pipe.  Destroying the pipe doesn't
+ *   release a buffer the other side hasn't read yet.  Mapping the pages costs
+ *   more than copying a small buffer, so this is meant for large ones (see
+ *   benchSplice).
+ * isReleased() - returns true once the data sent up to the given position has
+ *   been read out of the pipe.
+ * spliceTo() - moves up to size bytes out of the pipe into another handle (a
+ *   file or a device such as /dev/null) with splice, without copying them
+ *   through user space, and returns the number of bytes moved.  A socket or
+ *   another pipe would keep referring to a zero-copy sender's pages after they
+ *   have left this pipe, which would break the isReleased() contract, so those
+ *   handles throw std::invalid_argument.
+ *
+ * setCapacity() - sets the size of the kernel buffer on the write side of the
+ *   pipe (64KB by default) with F_SETPIPE_SZ, and returns the size actually
+ *   used, which is rounded up to a power of two pages.  Sizes above
+ *   /proc/sys/fs/pipe-max-size need CAP_SYS_RESOURCE, and the pipe can't be made
+ *   smaller than the data it holds.
+ * getCapacity() - returns the current size of the kernel buffer.
+ * setAdaptiveCapacity() - grows the kernel buffer when sends are often too big
+ *   for it: once s_adaptiveThreshold of the last s_adaptiveWindow sends had to
+ *   queue data, the capacity is doubled, up to maxCapacity.  If the kernel
+ *   refuses a size, the capacity stays where it is.  A maxCapacity of 0 turns
+ *   this off, which is the default.
+ *
+ * A named pipe uses separate handles for reading and writing, getWriteHandle()
+ *  returns the write side so a WaitSet can wait for the pipe to become writable.
  */
 namespace lethe
 {
@@ -30,10 +87,30 @@ namespace lethe
     bool flush(uint32_t timeout = INFINITE);
     void send(const void* buffer, uint32_t bufferSize);
     uint32_t receive(void* buffer, uint32_t bufferSize);
+    void sendv(const iovec* vectors, uint32_t count);
+    uint32_t receivev(const iovec* vectors, uint32_t count);
+    WaitObject& getFlushObject();
+
+    uint64_t sendZeroCopy(const void* buffer, uint32_t bufferSize);
+    bool isReleased(uint64_t position);
+    uint32_t spliceTo(Handle handle, uint32_t size);
+
+    void setSendCapacity(uint32_t capacity);
+    uint64_t getQueuedSize() const;
+
+    uint32_t setCapacity(uint32_t capacity);
+    uint32_t getCapacity() const;
+    void setAdaptiveCapacity(uint32_t maxCapacity);
+
+    Handle getWriteHandle() const;
 
     const std::string& getNameIn() const;
     const std::string& getNameOut() const;
 
+    static const uint32_t s_defaultSendCapacity;
+    static const uint32_t s_adaptiveWindow;
+    static const uint32_t s_adaptiveThreshold;
+
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
     LinuxPipe(const LinuxPipe&);
@@ -43,12 +120,47 @@ namespace lethe
     friend class LinuxHandleTransfer;
     LinuxPipe(Handle pipeRead, Handle pipeWrite);
 
+    // The WaitObject signaled when the send queue is empty
+    class FlushObject : public WaitObject
+    {
+    public:
+      explicit FlushObject(LinuxPipe& pipe);
+      ~FlushObject();
+
+      void setDrained(bool drained);
+
+    private:
+      // Private, undefined copy constructor and assignment operator so they can't be used
+      FlushObject(const FlushObject&);
+      FlushObject& operator = (const FlushObject&);
+
+      WaitResult waitUntil(uint64_t endTime);
+      void prepareHandle();
+      bool finishWait(WaitResult& result);
+
+      LinuxPipe& m_pipe;
+      Handle m_drainedHandle; // An eventfd, readable while nothing is queued
+    };
+
     static const std::string s_fifoPath;
     static const std::string s_fifoBaseName;
     static LinuxAtomic s_uniqueId;
 
-    void setupAsync();
     void cleanup();
+    // A queued send, either copied into the ring (buffer is NULL) or referring
+    //  to the caller's buffer (from sendZeroCopy)
+    struct SendSegment
+    {
+      const uint8_t* buffer;
+      uint32_t size;
+    };
+
+    void queue(const iovec* vectors, uint32_t count, size_t skip);
+    void queueSegment(const SendSegment& segment);
+    bool writeQueued();
+    bool waitWritable(uint64_t endTime);
+    bool flushUntil(uint64_t endTime);
+    void adaptCapacity(bool queued);
 
     Handle m_pipeRead;
     Handle m_pipeWrite;
@@ -59,22 +171,19 @@ namespace lethe
     bool m_inCreated;
     bool m_outCreated;
 
-    // Since we can't make kernel or libc-based aio work reliably with a full pipe, do it ourselves
-    struct AsyncData
-    {
-      pthread_attr_t attr;
-      pthread_t thread;
-      uint8_t* buffer;
-      uint32_t size;
-      uint32_t offset;
-      int result;
-    };
-
-    void startAsync(uint8_t* buffer, uint32_t size);
-    static void* asyncThreadHook(void* param);
-    void asyncThreadInternal();
-
-    AsyncData m_async;
+    std::vector<uint8_t> m_sendRing; // Allocated when data is first queued
+    uint32_t m_sendOffset; // The start of the queued data in the ring
+    uint32_t m_sendSize; // The number of bytes queued in the ring
+    uint32_t m_sendCapacity;
+    std::deque<SendSegment> m_sendQueue;
+    uint64_t m_queuedSize; // The number of bytes queued, in the ring or not
+    uint64_t m_acceptedTotal; // The number of bytes taken by sends, the position of the last one
+    uint64_t m_writtenTotal; // The number of bytes written into the pipe
+
+    uint32_t m_maxCapacity; // The limit for adaptive capacity, 0 when it's off
+    uint32_t m_adaptiveSends; // The number of sends in the current window
+    uint32_t m_adaptiveQueued; // The number of those that had to queue data
+    FlushObject m_flushObject;
   };
 }
 
@@ -0,0 +1,47 @@
+#ifndef _LINUXPROCESSEVENT_H
+#define _LINUXPROCESSEVENT_H
+
+#include "LetheTypes.h"
+#include "LetheFunctions.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxProcessEvent class is an event that is constructed inside a
+ *  SharedMemory region, like LinuxProcessMutex.  The state is an atomic word in
+ *  the region, so setting an event nobody is waiting for and waiting on a set
+ *  event do not make a system call, and waiters sleep on a shared futex.
+ *
+ * wait() - returns WaitSuccess once the event is set (resetting it if it is an
+ *   auto-reset event), or WaitTimeout.
+ * set() - sets the event, waking one waiter for an auto-reset event, or every
+ *   waiter otherwise.
+ * reset() - resets the event.
+ */
+namespace lethe
+{
+  class LinuxProcessEvent
+  {
+  public:
+    LinuxProcessEvent(bool initialState, bool autoReset);
+    ~LinuxProcessEvent();
+
+    void set();
+    void reset();
+
+    WaitResult wait(uint32_t timeout = INFINITE);
+    WaitResult wait(std::chrono::nanoseconds timeout);
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxProcessEvent(const LinuxProcessEvent&);
+    LinuxProcessEvent& operator = (const LinuxProcessEvent&);
+
+    WaitResult waitUntil(uint64_t endTime);
+
+    const bool m_autoReset;
+    std::atomic<uint32_t> m_state; // 1 when set, the futex word
+    std::atomic<uint32_t> m_waiters; // Threads (of any process) sleeping on m_state
+  };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef _LINUXPROCESSMUTEX_H
+#define _LINUXPROCESSMUTEX_H
+
+#include "LetheTypes.h"
+#include "LetheFunctions.h"
+#include <pthread.h>
+
+/*
+ * The LinuxProcessMutex class is a mutex that is constructed inside a
+ *  SharedMemory region, so every process that maps the region can use it
+ *  without passing a handle.  The creating process constructs it with placement
+ *  new, other processes just cast the address in their own mapping:
+ *
+ *   ProcessMutex* mutex = new (shm.begin()) ProcessMutex(false);
+ *   ProcessMutex* mutex = static_cast<ProcessMutex*>(shm.begin());
+ *
+ * It is a process-shared, robust pthread mutex, so locking and unlocking without
+ *  contention does not make a system call, and waiters sleep on a shared futex.
+ *  Like Mutex, it may be locked several times by the thread that owns it, and
+ *  only the owner may unlock it (otherwise std::bad_syscall is thrown).
+ *
+ * lock() - returns WaitSuccess, WaitTimeout, or WaitAbandoned if the owner
+ *   died while holding the mutex.  After WaitAbandoned, the caller owns the mutex
+ *   and the data it protects should be checked before it is unlocked.
+ *
+ * The mutex must only be destroyed by one process, once no other process will
+ *  use it.  Timed locks wait on CLOCK_REALTIME with glibc older than 2.30.
+ */
+namespace lethe
+{
+  class LinuxProcessMutex
+  {
+  public:
+    explicit LinuxProcessMutex(bool locked);
+    ~LinuxProcessMutex();
+
+    WaitResult lock(uint32_t timeout = INFINITE);
+    WaitResult lock(std::chrono::nanoseconds timeout);
+    void unlock();
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxProcessMutex(const LinuxProcessMutex&);
+    LinuxProcessMutex& operator = (const LinuxProcessMutex&);
+
+    WaitResult lockUntil(uint64_t endTime);
+
+    pthread_mutex_t m_mutex;
+  };
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef _LINUXPROCESSSEMAPHORE_H
+#define _LINUXPROCESSSEMAPHORE_H
+
+#include "LetheTypes.h"
+#include "LetheFunctions.h"
+#include <cstdatomic>
+
+/*
+ * The LinuxProcessSemaphore class is a semaphore that is constructed inside a
+ *  SharedMemory region, like LinuxProcessMutex.  The count is an atomic word in
+ *  the region, so locking a semaphore with a nonzero count and unlocking one
+ *  nobody is waiting for do not make a system call, and waiters sleep on a shared
+ *  futex.  Unlike the stock Semaphore, the maximum count is enforced in every
+ *  process.
+ *
+ * lock() - returns WaitSuccess or WaitTimeout.
+ * unlock() - throws std::bad_syscall if the count would pass the maximum.
+ */
+namespace lethe
+{
+  class LinuxProcessSemaphore
+  {
+  public:
+    LinuxProcessSemaphore(uint32_t maxCount, uint32_t initialCount);
+    ~LinuxProcessSemaphore();
+
+    WaitResult lock(uint32_t timeout = INFINITE);
+    WaitResult lock(std::chrono::nanoseconds timeout);
+    void unlock(uint32_t count);
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxProcessSemaphore(const LinuxProcessSemaphore&);
+    LinuxProcessSemaphore& operator = (const LinuxProcessSemaphore&);
+
+    WaitResult lockUntil(uint64_t endTime);
+
+    const uint32_t m_maxCount;
+    std::atomic<uint32_t> m_count; // The futex word
+    std::atomic<uint32_t> m_waiters; // Threads (of any process) sleeping on m_count
+  };
+}
+
+#endif
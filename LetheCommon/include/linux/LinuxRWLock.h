@@ -0,0 +1,116 @@
+#ifndef _LINUXRWLOCK_H
+#define _LINUXRWLOCK_H
+
+#include "WaitObject.h"
+#include "LetheTypes.h"
+#include "linux/LinuxAdaptiveSpin.h"
+#include <cstdatomic>
+#include <pthread.h>
+
+/*
+ * The LinuxRWLock class is a reader-writer lock, which may be held by a single
+ *  writer (exclusive) or any number of readers (shared).  The lock is kept in an
+ *  atomic word in user space, so locking and unlocking without contention does not
+ *  make a system call, and blocked threads sleep on a futex (after spinning for a
+ *  while, see LinuxAdaptiveSpin).
+ *
+ * The RWLock itself is a WaitObject for the exclusive lock, so waiting on it (with
+ *  WaitForObject or a WaitSet) locks it for writing the same as lock().  The
+ *  WaitObject returned by getSharedObject() is waited on to lock it for reading.
+ *  Once added to a WaitSet, an object gets an eventfd which is signaled every time
+ *  the lock may have become available; the WaitSet only returns the object if the
+ *  lock is actually taken, otherwise the wakeup is ignored.
+ *
+ * The policy decides who goes first when both sides are waiting:
+ *  RWLockPreferReaders - readers get in whenever there is no writer, writers may
+ *   starve while readers keep overlapping.
+ *  RWLockPreferWriters - new readers wait while a writer is waiting, readers may
+ *   starve while writers keep coming.
+ *  RWLockFair (default) - as RWLockPreferWriters, but when a writer unlocks, the
+ *   readers that were blocked at the time are let in before the next writer.
+ *   Readers waiting through a WaitSet are not counted.
+ *
+ * The lock is not recursive, the writer locking it again (for reading or writing)
+ *  throws std::logic_error, and a WaitSet will not return it to the writer.
+ *  Unlocking a lock not held by the thread throws std::bad_syscall, as with Mutex.
+ *
+ * The lock is only used within a single process.
+ */
+namespace lethe
+{
+  class LinuxRWLock : public WaitObject
+  {
+  public:
+    explicit LinuxRWLock(RWLockPolicy policy = RWLockFair);
+    ~LinuxRWLock();
+
+    void lock(uint32_t timeout = INFINITE);
+    void unlock();
+
+    void lockShared(uint32_t timeout = INFINITE);
+    void unlockShared();
+
+    WaitObject& getSharedObject();
+    RWLockPolicy getPolicy() const;
+    LinuxAdaptiveSpin& getSpin();
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxRWLock(const LinuxRWLock&);
+    LinuxRWLock& operator = (const LinuxRWLock&);
+
+    // The WaitObject used to lock the RWLock for reading
+    class SharedObject : public WaitObject
+    {
+    public:
+      explicit SharedObject(LinuxRWLock& lock);
+      ~SharedObject();
+
+    private:
+      // Private, undefined copy constructor and assignment operator so they can't be used
+      SharedObject(const SharedObject&);
+      SharedObject& operator = (const SharedObject&);
+
+      WaitResult waitUntil(uint64_t endTime);
+      void prepareHandle();
+      bool finishWait(WaitResult& result);
+
+      LinuxRWLock& m_lock;
+    };
+
+    WaitResult waitUntil(uint64_t endTime);
+    void prepareHandle();
+    bool finishWait(WaitResult& result);
+
+    bool tryLock();
+    bool tryLockShared();
+    WaitResult waitLock(uint64_t endTime, bool shared);
+    void spinWait(uint32_t sequence, uint64_t endTime);
+    bool sleep(uint32_t sequence, uint64_t endTime);
+    void wake();
+
+    bool takePass();
+
+    static Handle createNotifyHandle(std::atomic<int>& handle);
+    static void notify(std::atomic<int>& handle);
+    static void consumeNotify(Handle handle);
+
+    static const uint32_t s_writerBit;
+    static const uint32_t s_readerMask;
+
+    RWLockPolicy m_policy;
+    std::atomic<uint32_t> m_state; // s_writerBit, or the number of readers
+    std::atomic<uint32_t> m_sequence; // Changed by every wake, the futex word
+    std::atomic<uint32_t> m_waiters; // Threads sleeping on m_sequence
+    std::atomic<uint32_t> m_writersWaiting;
+    std::atomic<uint32_t> m_readersWaiting;
+    std::atomic<uint32_t> m_readerPasses; // Readers let in ahead of writers by RWLockFair
+    std::atomic<pthread_t> m_owner; // The writer, or 0
+    std::atomic<int> m_exclusiveHandle; // eventfds signaled by wake, once created
+    std::atomic<int> m_sharedHandle;
+    LinuxAdaptiveSpin m_spin;
+    SharedObject m_sharedObject;
+  };
+}
+
+#endif
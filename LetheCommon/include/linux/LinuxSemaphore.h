@@ -2,6 +2,7 @@
 #define _LINUXSEMAPHORE_H
 
 #include "WaitObject.h"
+#include "linux/LinuxAdaptiveSpin.h"
 #include "LetheTypes.h"
 #include <cstdatomic>
 
@@ -10,14 +11,32 @@
  *  using semaphore mode. Once a wait has been completed on the Semaphore
  *  handle, the user must call lock() to obtain the lock.
  *
- * In the future, this will be extended to automatically lock on a wait,
- *  but that will require a change to the eventfd subsystem in Linux.  A
- *  kernel module is in development to extend eventfd (see ../module).
+ * Without the eventfd-lethe module (see setLinuxBackend), the count is kept in
+ *  user space, and a stock eventfd is only used to make the handle readable
+ *  while the count is nonzero, so the semaphore can't be transferred to another
+ *  process.
+ *
+ * As with LinuxMutex, a waiter spins on the count of a stock semaphore for a
+ *  while before blocking (see LinuxAdaptiveSpin and getSpin()).  With the module,
+ *  the count is only in the kernel, so a waiter blocks right away.
+ *
+ * Several units of the count may be taken with a single operation:
+ * lock(count, timeout) - waits until the whole count can be taken at once.
+ * lockUpTo() - waits until some count is available, and takes up to count of it,
+ *   returning the count taken.
+ * tryLock() and tryLockUpTo() - the same, without waiting, returning false or 0
+ *   if nothing could be taken.
+ * These are done with one ioctl by the eventfd-lethe module, and with one atomic
+ *  operation on the count kept in user space for a stock semaphore.  A stock
+ *  semaphore then waits on a futex.  With the module, lock(count, timeout) sleeps
+ *  in the module (EFD_ACQUIRE_WAIT), which checks the count again on every
+ *  unlock, from whichever process, and lockUpTo() waits on the handle.
  */
 namespace lethe
 {
   // Prototype for transferring handles between processes - defined in libProcessComm
   class LinuxHandleTransfer;
+  class LinuxFastSemaphore;
 
   class LinuxSemaphore : public WaitObject
   {
@@ -26,9 +45,15 @@ namespace lethe
     ~LinuxSemaphore();
 
     void lock(uint32_t timeout = INFINITE);
+    void lock(uint32_t count, uint32_t timeout);
+    uint32_t lockUpTo(uint32_t count, uint32_t timeout = INFINITE);
+    bool tryLock(uint32_t count = 1);
+    uint32_t tryLockUpTo(uint32_t count);
     void unlock(uint32_t count);
     void error();
 
+    LinuxAdaptiveSpin& getSpin();
+
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
     LinuxSemaphore(const LinuxSemaphore&);
@@ -38,7 +63,27 @@ namespace lethe
     friend class LinuxHandleTransfer;
     LinuxSemaphore(Handle handle);
 
+    // Allow LinuxFastSemaphore to pass batches on once moved to the kernel
+    friend class LinuxFastSemaphore;
+    uint32_t lockUntil(uint32_t count, bool upTo, uint64_t endTime);
+    uint32_t take(uint32_t count, bool upTo);
+    uint32_t acquireUntil(uint32_t count, uint64_t endTime);
+    void updateStockHandle();
+
+    WaitResult waitUntil(uint64_t endTime);
+    bool finishWait(WaitResult& result);
+    bool canUndoWait() const;
+    void undoWait();
+    bool tryAcquire(WaitResult& result);
+
     static const std::string s_eventfdDevice;
+
+    bool m_stock; // Created with a stock eventfd
+    std::atomic<bool> m_error;
+    uint32_t m_maxCount;
+    std::atomic<uint32_t> m_count; // The count of a stock semaphore, the futex word
+    std::atomic<uint32_t> m_waiters; // Threads sleeping on m_count
+    LinuxAdaptiveSpin m_spin;
   };
 }
 
@@ -3,10 +3,27 @@
 
 #include "WaitObject.h"
 #include "LetheTypes.h"
+#include <cstdatomic>
+#include <time.h>
 
 /*
  * The LinuxTimer class wraps the timerfd subsystem.  When the timer expires,
- *  it remains triggered until reset.
+ *  it remains triggered until reset.  The timeout may be given in ms, or as a
+ *  std::chrono duration for sub-millisecond timers.
+ *
+ * startAt() - starts the timer at an absolute deadline, in ns of
+ *   getMonotonicTime(), optionally repeating every period after it.  The timer
+ *   stays in phase with the deadline however late its waiters are, so a control
+ *   loop can schedule its ticks without drifting.
+ * getOverrun() - returns the number of expirations missed before the last wait
+ *   that reset an auto-reset timer, that is, the number of periods that passed
+ *   while nobody was waiting.  A waiter can use this to catch up on missed
+ *   ticks.  This is shared by all waiters, so it is only meaningful when a single
+ *   thread waits on the timer, and it is always 0 for manual-reset timers.
+ *
+ * Without the timerfd-lethe module (see setLinuxBackend), a stock timerfd is
+ *  used.  As with LinuxEvent, an auto-reset timer is then reset by the waiter it
+ *  wakes up, which is handled by wait() and WaitSets.
  */
 namespace lethe
 {
@@ -17,12 +34,17 @@ namespace lethe
   {
   public:
     LinuxTimer(uint32_t timeout, bool periodic, bool autoReset);
+    LinuxTimer(std::chrono::nanoseconds timeout, bool periodic, bool autoReset);
     ~LinuxTimer();
 
     void start(uint32_t timeout, bool periodic);
+    void start(std::chrono::nanoseconds timeout, bool periodic);
+    void startAt(uint64_t deadline, std::chrono::nanoseconds period = std::chrono::nanoseconds(0));
     void clear();
     void error();
 
+    uint64_t getOverrun();
+
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
     LinuxTimer(const LinuxTimer&);
@@ -32,7 +54,17 @@ namespace lethe
     friend class LinuxHandleTransfer;
     LinuxTimer(Handle handle);
 
+    void createHandle();
+    void start(const timespec& elapseTime, bool periodic);
+    bool finishWait(WaitResult& result);
+    void setTime(const itimerspec& timerSpec, int flags);
+
     static const std::string s_timerfdDevice;
+
+    bool m_stock; // Created with a stock timerfd
+    bool m_autoReset;
+    std::atomic<bool> m_error;
+    std::atomic<uint64_t> m_overrun; // Read by the last wait of a stock timer
   };
 }
 
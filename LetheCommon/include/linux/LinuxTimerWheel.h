@@ -0,0 +1,109 @@
+#ifndef _LINUXTIMERWHEEL_H
+#define _LINUXTIMERWHEEL_H
+
+#include "WaitObject.h"
+#include "WaitHandler.h"
+#include "TimerHandler.h"
+#include "LetheTypes.h"
+#include "linux/LinuxTimer.h"
+#include <vector>
+
+/*
+ * The LinuxTimerWheel class runs any number of one-shot timers from a single
+ *  LinuxTimer.  Timers are kept in a hierarchical timing wheel (s_levels levels of
+ *  s_slotCount slots, each level s_slotCount times coarser than the one below),
+ *  so scheduling and cancelling a timer take constant time however many timers
+ *  there are, and the kernel timer is only armed for the next slot that needs
+ *  attention.
+ *
+ * LinuxTimerWheel() - resolution is the length of one tick of the wheel, timers
+ *   expire on tick boundaries.  Timeouts of up to 2^32 ticks are kept exactly,
+ *   longer ones are moved down the wheel as they come closer.
+ * schedule() - starts a timer that calls handler.handleTimer once the timeout
+ *   has passed, and returns its id.  A timer with slack may expire up to slack
+ *   late, and is moved to the coarsest tick in that window, so timers scheduled
+ *   around the same time expire (and wake the thread) together.
+ * cancel() - stops a timer, returns false if it had already expired or been
+ *   cancelled.
+ * getCount() - returns the number of timers scheduled.
+ * advance() - calls the handlers of the timers that have expired, and arms the
+ *   kernel timer for the next one.
+ *
+ * To deliver the timers through a BaseThread, add the wheel as both the
+ *  WaitObject and the WaitHandler (addWaitObject(wheel, wheel)), and handleWait
+ *  will call advance() when the kernel timer fires.  Otherwise, wait for the
+ *  wheel (with WaitForObject or a WaitSet) and call advance() when it triggers.
+ *
+ * The wheel is not thread-safe.  Timers must be scheduled and cancelled by the
+ *  thread that advances the wheel, including from handleTimer.
+ */
+namespace lethe
+{
+  class LinuxTimerWheel : public WaitObject, public WaitHandler
+  {
+  public:
+    explicit LinuxTimerWheel(uint32_t resolution = 1);
+    explicit LinuxTimerWheel(std::chrono::nanoseconds resolution);
+    ~LinuxTimerWheel();
+
+    TimerId schedule(TimerHandler& handler, uint32_t timeout, void* userData = NULL, uint32_t slack = 0);
+    TimerId schedule(TimerHandler& handler, std::chrono::nanoseconds timeout, void* userData = NULL,
+                     std::chrono::nanoseconds slack = std::chrono::nanoseconds(0));
+    bool cancel(TimerId id);
+    size_t getCount() const;
+
+    void advance();
+    void handleWait(const WaitEvent& event);
+
+    static const uint32_t s_levels;
+    static const uint32_t s_slotCount;
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    LinuxTimerWheel(const LinuxTimerWheel&);
+    LinuxTimerWheel& operator = (const LinuxTimerWheel&);
+
+    bool finishWait(WaitResult& result);
+
+    // A timer, linked into the list of its slot
+    struct Entry
+    {
+      TimerHandler* handler;
+      void* userData;
+      uint64_t expiry; // The tick the timer expires on
+      uint32_t previous; // Within the slot, or s_none
+      uint32_t next; // Within the slot or the free list, or s_none
+      uint32_t generation; // Changed each time the entry is freed, so old ids don't match
+      uint32_t slot; // The slot the entry is linked into, or s_none if the entry is free
+    };
+
+    TimerId scheduleTimer(TimerHandler& handler, void* userData, uint64_t timeout, uint64_t slack);
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(uint64_t tick);
+    void expire(uint64_t tick);
+    int32_t findSlot(uint32_t level, uint32_t first) const;
+    uint64_t getNextTick() const;
+    void arm();
+
+    static const uint32_t s_slotBits;
+    static const uint32_t s_slotMask;
+    static const uint32_t s_none;
+    static const uint64_t s_maxTicks; // The furthest ahead a timer can be placed
+
+    LinuxTimer m_timer;
+    uint64_t m_resolution; // The length of a tick, in ns
+    uint64_t m_startTime; // The start of tick 0
+    uint64_t m_currentTick; // The last tick handled by advance
+    uint64_t m_armedTick; // The tick the kernel timer is armed for, or UINT64_MAX
+    size_t m_count;
+
+    std::vector<Entry> m_entries;
+    uint32_t m_freeList;
+    std::vector<uint32_t> m_slots; // The first entry of each slot, level by level
+    std::vector<uint64_t> m_occupied; // A bit for each slot that holds an entry
+  };
+}
+
+#endif
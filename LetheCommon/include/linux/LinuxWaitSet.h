@@ -3,18 +3,14 @@
 
 #include "LetheTypes.h"
 #include "WaitObject.h"
+#include "WaitHandler.h"
+#include "HandleTable.h"
 #include <tr1/functional>
-#include <poll.h>
+#include <cstdatomic>
+#include <sys/epoll.h>
 #include <list>
 #include <set>
 
-// Prototype of the hash map, so users don't need the include
-namespace mct
-{
-  template<typename, typename, typename, typename, typename, bool>
-  class closed_hash_map;
-}
-
 /*
  * The LinuxWaitSet class provides a method of grouping and waiting on multiple
  *  handles (file descriptors in Linux).  Handles may be added and removed, and when
@@ -23,9 +19,60 @@ namespace mct
  *  result will be WaitAbandoned, and the user should take measures to fix or remove
  *  the broken handle.
  *
- * The underlying system call used for waiting is poll, which allows minimal
- *  overhead per wait call.  A single call may return multiple wait objects.  This
- *  may lead to a deadlock if used incorrectly.
+ * The underlying system call used for waiting is epoll, so adding and removing
+ *  handles does not touch the rest of the set, there is no limit on the number of
+ *  handles, and a wait only costs as much as the number of handles that are ready.
+ *  A single call may return multiple wait objects, these are buffered and handed
+ *  out by subsequent calls to waitAny before the kernel is asked again.  This may
+ *  lead to a deadlock if used incorrectly.
+ *
+ * Timeouts may be given in ms or as a std::chrono duration.  The wait uses
+ *  epoll_pwait2 where the kernel has it, so durations are waited with ns
+ *  resolution, otherwise they are rounded up to the next ms.
+ *
+ * waitMany returns up to maxCount ready handles along with their wait results from
+ *  a single epoll_wait, or 0 if the timeout expired.  Any events buffered by a
+ *  previous call are returned first without waiting.
+ *
+ * Handles are registered with LETHE_POLL_PEEK, so that the poll done by epoll_ctl
+ *  when adding a Mutex, Semaphore, auto-reset Event or Timer does not consume it.
+ *  The object is only consumed when epoll actually reports it.
+ *
+ * A WaitObject may be added with a WaitHandler and a user pointer.  These are kept
+ *  in a HandleTable indexed by the handle, and epoll hands back the handle and its
+ *  generation with each event, so waitMany (with WaitEvents) and dispatch can find
+ *  them with a single indexed load.
+ *  dispatch waits the same as waitMany, then calls handleWait on the handler of
+ *  each event received, and returns the number of events handled.  Every object in
+ *  the set must have a handler to use dispatch.  A handler may remove objects
+ *  (including its own) from the set, any of their pending events are dropped.
+ *
+ * Objects are added with an interest mask of WaitInterest flags, WaitReadable if
+ *  none is given, which can be changed later with modify.  For objects with a
+ *  separate write handle (see WaitObject::getWriteHandle), WaitWritable adds the
+ *  write handle to the set as well, and the object may be returned once for each
+ *  handle.  The events in a WaitEvent tell which of the flags are ready.
+ *
+ * addExclusive registers the handle with EPOLLEXCLUSIVE, so when the same handle is
+ *  added exclusively to several WaitSets waited on by different threads, a readiness
+ *  event only wakes one of them.  The kernel does not allow LETHE_POLL_PEEK or
+ *  WaitHangup along with EPOLLEXCLUSIVE, so this is meant for Pipes, sockets and
+ *  other handles that are not consumed by a poll.  Objects using the lethe kernel
+ *  modules (a Mutex, Semaphore, auto-reset Event or Timer) would be acquired by the
+ *  poll made when they are added, so addExclusive throws std::invalid_argument for
+ *  them.  Objects of the stock backend are not consumed by a poll, and may be
+ *  added exclusively.
+ *
+ * The policy decides the order of the events received from a single epoll_wait:
+ *  WaitPolicyInOrder - the order the kernel reported them.
+ *  WaitPolicyRoundRobin (default) - the kernel order, starting at a different
+ *   position for each wait so the same handle does not always come first.
+ *  WaitPolicyPriority - highest priority first (see setPriority, default 0).
+ *  WaitPolicyWeighted - stride scheduling, each handle is given a share of the
+ *   dispatches proportional to its weight (see setWeight, default 1).
+ *  Since every received event has already been acquired, the policy can only
+ *  reorder a batch, not hold events back.  getDispatchCount returns the number
+ *  of events handed out for an object, to check how the policy is behaving.
  */
 namespace lethe
 {
@@ -36,36 +83,106 @@ namespace lethe
     ~LinuxWaitSet();
 
     bool add(WaitObject& obj);
+    bool add(WaitObject& obj, uint32_t interest);
+    bool add(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+    bool addExclusive(WaitObject& obj);
+    bool addExclusive(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+
+    bool modify(WaitObject& obj, uint32_t interest);
+    bool modify(Handle handle, uint32_t interest);
 
     bool remove(WaitObject& obj);
     bool remove(Handle handle);
 
     size_t getSize() const;
 
+    void setPolicy(WaitPolicy policy);
+    WaitPolicy getPolicy() const;
+
+    bool setPriority(WaitObject& obj, uint32_t priority);
+    bool setWeight(WaitObject& obj, uint32_t weight);
+    uint64_t getDispatchCount(WaitObject& obj) const;
+
     WaitResult waitAny(uint32_t timeout, Handle& handle);
+    WaitResult waitAny(std::chrono::nanoseconds timeout, Handle& handle);
+    size_t waitMany(uint32_t timeout, Handle* handles, WaitResult* results, size_t maxCount);
+    size_t waitMany(std::chrono::nanoseconds timeout, Handle* handles, WaitResult* results, size_t maxCount);
+    size_t waitMany(uint32_t timeout, WaitEvent* events, size_t maxCount);
+    size_t waitMany(std::chrono::nanoseconds timeout, WaitEvent* events, size_t maxCount);
+
+    size_t dispatch(uint32_t timeout);
+    size_t dispatch(std::chrono::nanoseconds timeout);
 
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
     LinuxWaitSet(const LinuxWaitSet&);
     LinuxWaitSet& operator = (const LinuxWaitSet&);
 
+    // Kept in a table indexed by handle, the handle and generation are stored in the
+    //  epoll data so an event for a removed or reused handle can be recognized
+    struct Registration
+    {
+      WaitObject* object;
+      Handle handle;
+      uint32_t generation;
+      Handle writeHandle;
+      WaitHandler* handler;
+      void* userData;
+      uint32_t interest;
+      bool exclusive;
+      uint32_t priority;
+      uint32_t weight;
+      uint64_t pass; // Position in virtual time for WaitPolicyWeighted
+      uint64_t dispatchCount;
+    };
+
+    // Sorts received events for WaitPolicyPriority and WaitPolicyWeighted
+    class EventOrder
+    {
+    public:
+      EventOrder(LinuxWaitSet& waitSet);
+      bool operator () (const epoll_event& a, const epoll_event& b) const;
+
+    private:
+      LinuxWaitSet& m_waitSet;
+    };
+
+    static uint64_t makeKey(Handle handle, uint32_t generation);
+    Registration* findEvent(const epoll_event& event);
+    void orderEvents();
+
+    bool addRegistration(WaitObject& obj, WaitHandler* handler, void* userData, uint32_t interest, bool exclusive);
+    void setInterest(Registration& reg, uint32_t interest);
+    void setEpollEvents(Registration& reg, Handle handle, bool added, uint32_t events);
+    static uint32_t getEpollEvents(uint32_t interest, bool includeWrite);
+    WaitResult waitAnyUntil(uint64_t endTime, Handle& handle);
+    size_t waitManyUntil(uint64_t endTime, Handle* handles, WaitResult* results, size_t maxCount);
+    size_t waitManyUntil(uint64_t endTime, WaitEvent* events, size_t maxCount);
+    size_t dispatchUntil(uint64_t endTime);
+
     void resizeEvents();
-    void findBadHandles();
-    void addEvents(const std::vector<Handle>& events);
-    WaitResult pollEvents(uint32_t timeout, uint32_t endTime);
-    WaitResult getEvent(Handle& handle);
+    WaitResult pollEvents(uint64_t endTime);
+    int waitEpoll(uint64_t endTime);
+    Registration* getEvent(WaitResult& result, uint32_t& events);
+    Registration* countEvent(Registration* reg);
+    size_t getEvents(Handle* handles, WaitResult* results, size_t maxCount);
+    size_t getEvents(WaitEvent* events, size_t maxCount);
 
-    static const uint32_t s_maxWaitObjects;
+    static const uint32_t s_minEventCapacity;
+    static const uint64_t s_strideScale; // Virtual time used by a dispatch of weight 1
+    static std::atomic<bool> s_epollPwait2; // Cleared if the kernel doesn't have epoll_pwait2
 
-    mct::closed_hash_map<Handle,
-                         WaitObject*,
-                         std::tr1::hash<Handle>,
-                         std::equal_to<Handle>,
-                         std::allocator<std::pair<const Handle, WaitObject*> >,
-                         false>* m_waitObjects;
+    HandleTable<Registration> m_registrations;
 
-    pollfd* m_waitArray;
+    Handle m_epollHandle;
+    epoll_event* m_eventArray; // Events received from the last epoll_wait
+    uint32_t m_eventCapacity;
+    uint32_t m_eventCount;
     uint32_t m_eventOffset;
+
+    WaitPolicy m_policy;
+    uint32_t m_pollCount; // Rotates the starting position for WaitPolicyRoundRobin
+    uint64_t m_virtualTime; // Pass of the last event dispatched with WaitPolicyWeighted
   };
 }
 
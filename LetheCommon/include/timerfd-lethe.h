@@ -1,5 +1,5 @@
-#ifndef _LETHE_EVENTFD_H
-#define _LETHE_EVENTFD_H
+#ifndef _LETHE_TIMERFD_H
+#define _LETHE_TIMERFD_H
 
 #include <sys/ioctl.h>
 
@@ -11,5 +11,7 @@
 #define TFD_SET_PERIODIC_TIME _IOW(TIMERFD_LETHE_MAJOR, 2, unsigned long)
 #define TFD_SET_WAITREAD_MODE _IOW(TIMERFD_LETHE_MAJOR, 3, bool)
 #define TFD_SET_ERROR _IOW(TIMERFD_LETHE_MAJOR, 4, bool)
+#define TFD_SET_DEADLINE _IOW(TIMERFD_LETHE_MAJOR, 5, unsigned long)
+#define TFD_GET_OVERRUN _IOR(TIMERFD_LETHE_MAJOR, 6, unsigned long)
 
 #endif
@@ -8,13 +8,17 @@
 
 /*
  * The WindowsMutex class is a wrapper class of CreateMutex on Windows.
+ *
+ * Windows mutexes have no priority inheritance, MutexPriorityInheritance is
+ *  accepted so code can be shared with Linux, but has no effect (the scheduler
+ *  boosts threads that have been starved instead).
  */
 namespace lethe
 {
   class WindowsMutex : public WaitObject
   {
   public:
-    explicit WindowsMutex(bool locked);
+    explicit WindowsMutex(bool locked, MutexProtocol protocol = MutexDefault);
     ~WindowsMutex();
 
     void lock(uint32_t timeout = INFINITE);
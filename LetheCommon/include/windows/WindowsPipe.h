@@ -27,7 +27,8 @@
  * If the pipe buffer is full when a send occurs, or the data is too large to
  *  fit in the buffer, a thread will be spawned to finish the send.  Only one
  *  thread will be used system-wide for this pipe, so all other sends will fail
- *  until the thread completes.
+ *  until the thread completes.  getFlushObject() returns an Event that is reset
+ *  while the thread is running.
  *
  * To implement the pipe object, a shared memory area of 64k is used as a
  *  circular buffer to contain the data being transmitted.  Two events and two
@@ -56,6 +57,7 @@ namespace lethe
     uint32_t receive(void* buffer, uint32_t bufferSize);
 
     bool flush(uint32_t timeout);
+    WaitObject& getFlushObject();
 
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
@@ -111,6 +113,7 @@ namespace lethe
     WindowsEvent* m_writeEventOut;
 
     Handle m_asyncThread;
+    WindowsEvent m_flushEvent; // Set while no asynchronous send is running
     bool m_destructing;
   };
 }
@@ -19,6 +19,7 @@ namespace lethe
     ~WindowsTimer();
 
     void start(uint32_t timeout);
+    void start(std::chrono::nanoseconds timeout);
     void clear();
     void error();
 
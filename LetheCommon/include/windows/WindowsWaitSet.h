@@ -3,6 +3,7 @@
 
 #include "LetheTypes.h"
 #include "WaitObject.h"
+#include "WaitHandler.h"
 #include <set>
 
 // Prototype of the hash map, so users don't need the include
@@ -26,6 +27,25 @@ namespace mct
  *  WaitForMultipleObjects is moved around.  After receiving an event on a handle,
  *  the pointer is moved to just after that handle in the array, so it will be the
  *  least favored in the next call.
+ *
+ * waitMany has no single system call to back it on Windows, after the first handle
+ *  is received, the rest of the set is checked without waiting.
+ *
+ * Handlers and user pointers given to add are kept in a registration for each
+ *  handle.  WaitForMultipleObjects only returns an index, so the registration is
+ *  found with the same lookup used to track the set.
+ *
+ * Only WaitReadable interest is supported, WaitForMultipleObjects has no way to
+ *  wait for a handle to become writable.  modify accepts the same masks as add.
+ *
+ * WaitPolicyRoundRobin (default) is the sliding window described above.  With
+ *  WaitPolicyInOrder the window is not moved, and with WaitPolicyPriority the
+ *  handle array is also sorted by priority, since WaitForMultipleObjects returns
+ *  the first signaled handle.  WaitPolicyWeighted has no equivalent and behaves
+ *  like WaitPolicyRoundRobin.
+ *
+ * addExclusive is the same as add, WaitForMultipleObjects already only wakes a
+ *  single waiter when an auto-reset object is signaled.
  */
 namespace lethe
 {
@@ -36,33 +56,71 @@ namespace lethe
     ~WindowsWaitSet();
 
     bool add(WaitObject& obj);
+    bool add(WaitObject& obj, uint32_t interest);
+    bool add(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+    bool addExclusive(WaitObject& obj);
+    bool addExclusive(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+
+    bool modify(WaitObject& obj, uint32_t interest);
+    bool modify(Handle handle, uint32_t interest);
 
     bool remove(WaitObject& obj);
     bool remove(Handle handle);
 
     size_t getSize() const;
 
+    void setPolicy(WaitPolicy policy);
+    WaitPolicy getPolicy() const;
+
+    bool setPriority(WaitObject& obj, uint32_t priority);
+    bool setWeight(WaitObject& obj, uint32_t weight);
+    uint64_t getDispatchCount(WaitObject& obj) const;
+
     WaitResult waitAny(uint32_t timeout, Handle& handle);
+    WaitResult waitAny(std::chrono::nanoseconds timeout, Handle& handle);
+    size_t waitMany(uint32_t timeout, Handle* handles, WaitResult* results, size_t maxCount);
+    size_t waitMany(std::chrono::nanoseconds timeout, Handle* handles, WaitResult* results, size_t maxCount);
+    size_t waitMany(uint32_t timeout, WaitEvent* events, size_t maxCount);
+    size_t waitMany(std::chrono::nanoseconds timeout, WaitEvent* events, size_t maxCount);
+
+    size_t dispatch(uint32_t timeout);
+    size_t dispatch(std::chrono::nanoseconds timeout);
 
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
     WindowsWaitSet(const WindowsWaitSet&);
     WindowsWaitSet& operator = (const WindowsWaitSet&);
 
+    struct Registration
+    {
+      WaitObject* object;
+      Handle handle;
+      WaitHandler* handler;
+      void* userData;
+      uint32_t priority;
+      uint32_t weight;
+      uint64_t dispatchCount;
+    };
+
+    Registration* findRegistration(Handle handle) const;
+    static bool comparePriority(const Registration* a, const Registration* b);
+    bool addRegistration(WaitObject& obj, WaitHandler* handler, void* userData, uint32_t interest);
+    static void checkInterest(uint32_t interest);
     void resizeEvents();
     void callPostWait(WaitResult result, Handle handle);
 
     static const uint32_t s_maxWaitObjects;
 
     mct::closed_hash_map<Handle,
-                         WaitObject*,
+                         Registration*,
                          std::tr1::hash<Handle>,
                          std::equal_to<Handle>,
-                         std::allocator<std::pair<const Handle, WaitObject*> >,
+                         std::allocator<std::pair<const Handle, Registration*> >,
                          false>* m_waitObjects;
 
     Handle* m_handleArray;
     uint32_t m_offset;
+    WaitPolicy m_policy;
   };
 }
 
@@ -32,6 +32,25 @@ enum eventfd_mode_t
 #define EFD_SET_MAX_VALUE _IOW(EVENTFD_LETHE_MAJOR, 4, unsigned long)
 #define EFD_SET_ERROR _IOW(EVENTFD_LETHE_MAJOR, 5, bool)
 #define EFD_GET_MODE _IO(EVENTFD_LETHE_MAJOR, 6)
+#define EFD_ACQUIRE _IOW(EVENTFD_LETHE_MAJOR, 7, unsigned long)
+#define EFD_ACQUIRE_UP_TO _IOW(EVENTFD_LETHE_MAJOR, 8, unsigned long)
+#define EFD_ACQUIRE_WAIT _IOW(EVENTFD_LETHE_MAJOR, 9, struct eventfd_acquire_wait)
+
+// Parameter of EFD_ACQUIRE_WAIT, which sleeps until the whole count can be taken
+//  from a semaphore, or the end time (CLOCK_MONOTONIC, in nanoseconds) passes
+struct eventfd_acquire_wait
+{
+  unsigned long long end_time; // EFD_WAIT_FOREVER for no timeout
+  unsigned int count;
+  unsigned int padding;
+};
+
+#define EFD_WAIT_FOREVER (~0ULL)
+
+// Pollers that register with LETHE_POLL_PEEK only want the current state, a waitread
+//  object is not consumed until it is polled without it (see LinuxWaitSet)
+#define LETHE_POLL_PEEK POLLMSG
+#define LETHE_POLL_IS_PEEK(wait) ((wait) != NULL && ((wait)->key & LETHE_POLL_PEEK))
 
 int init_module(void);
 void cleanup_module(void);
@@ -42,6 +61,7 @@ ssize_t eventfd_write(struct file *file, const char __user *buf, size_t count, l
 unsigned int eventfd_poll(struct file *file, poll_table *wait);
 ssize_t eventfd_read(struct file *file, char __user *buf, size_t count, loff_t *ppos);
 void eventfd_ctx_do_read(struct eventfd_ctx* ctx, __u64* cnt);
+int eventfd_acquire_wait(struct eventfd_ctx* ctx, const struct eventfd_acquire_wait* acquire);
 int eventfd_flush(struct file* file, fl_owner_t id);
 void eventfd_free(struct kref *kref);
 int eventfd_release(struct inode *inode, struct file *file);
@@ -19,6 +19,7 @@
 #include <linux/module.h>
 #include <linux/unistd.h>
 #include <linux/kprobes.h>
+#include <linux/hrtimer.h>
 #include <asm/segment.h>
 #include <asm/uaccess.h>
 #include <asm/io.h>
@@ -286,7 +287,7 @@ unsigned int eventfd_poll(struct file *file, poll_table *wait)
 
   if (ctx->error)
     events |= POLLERR;
-  else if (ctx->waitread)
+  else if (ctx->waitread && !LETHE_POLL_IS_PEEK(wait))
   {
     __u64 readCount;
     eventfd_ctx_do_read(ctx, &readCount);
@@ -425,6 +426,71 @@ ssize_t eventfd_write(struct file *file,
   return res;
 }
 
+int eventfd_acquire_wait(struct eventfd_ctx* ctx, const struct eventfd_acquire_wait* acquire)
+{
+  DECLARE_WAITQUEUE(wait, current);
+  ktime_t end_time = ns_to_ktime(acquire->end_time);
+  bool timed_out = false;
+  int retval;
+
+  if (unlikely(acquire->count == 0 || acquire->count > INT_MAX))
+    return -EINVAL;
+
+  spin_lock_irq(&ctx->wqh.lock);
+
+  if (unlikely(ctx->mode != EFD_SEMAPHORE_MODE))
+  {
+    spin_unlock_irq(&ctx->wqh.lock);
+    return -EINVAL;
+  }
+
+  // Writes wake up everything on the queue, so the count is checked again after
+  //  every unlock, whichever process it came from
+  __add_wait_queue(&ctx->wqh, &wait);
+
+  while (1)
+  {
+    set_current_state(TASK_INTERRUPTIBLE);
+
+    if (ctx->error)
+    {
+      retval = -EIO;
+      break;
+    }
+    else if (ctx->count >= acquire->count)
+    {
+      ctx->count -= acquire->count;
+      retval = acquire->count;
+      break;
+    }
+    else if (timed_out)
+    {
+      retval = -ETIMEDOUT;
+      break;
+    }
+    else if (signal_pending(current))
+    {
+      retval = -EINTR;
+      break;
+    }
+
+    spin_unlock_irq(&ctx->wqh.lock);
+
+    if (acquire->end_time == EFD_WAIT_FOREVER)
+      schedule();
+    else if (schedule_hrtimeout(&end_time, HRTIMER_MODE_ABS) == 0)
+      timed_out = true;
+
+    spin_lock_irq(&ctx->wqh.lock);
+  }
+
+  __remove_wait_queue(&ctx->wqh, &wait);
+  __set_current_state(TASK_RUNNING);
+  spin_unlock_irq(&ctx->wqh.lock);
+
+  return retval;
+}
+
 long eventfd_ioctl(struct file* file,
                    unsigned int ioctl_num,
                    unsigned long ioctl_param)
@@ -514,6 +580,34 @@ long eventfd_ioctl(struct file* file,
     retval = ctx->mode;
     break;
 
+  case EFD_ACQUIRE: // Takes the whole count from a semaphore, or nothing, returns the count taken
+  case EFD_ACQUIRE_UP_TO: // Takes as much of the count from a semaphore as there is, returns the count taken
+    spin_lock_irq(&ctx->wqh.lock);
+    if (unlikely(ctx->mode != EFD_SEMAPHORE_MODE || ioctl_param == 0 || ioctl_param > INT_MAX))
+      retval = -EINVAL;
+    else if (ctx->error)
+      retval = -EIO;
+    else if (ctx->count == 0 || (ctx->count < ioctl_param && ioctl_num == EFD_ACQUIRE))
+      retval = -EAGAIN;
+    else
+    {
+      retval = (ctx->count < ioctl_param) ? ctx->count : ioctl_param;
+      ctx->count -= retval;
+    }
+    spin_unlock_irq(&ctx->wqh.lock);
+    break;
+
+  case EFD_ACQUIRE_WAIT: // Sleeps until the whole count can be taken from a semaphore, returns the count taken
+    {
+      struct eventfd_acquire_wait acquire;
+
+      if (copy_from_user(&acquire, (void __user *) ioctl_param, sizeof(acquire)))
+        retval = -EFAULT;
+      else
+        retval = eventfd_acquire_wait(ctx, &acquire);
+    }
+    break;
+
   default:
     retval = -EINVAL;
     break;
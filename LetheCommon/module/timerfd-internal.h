@@ -26,6 +26,13 @@ struct timerfd_ctx;
 #define TFD_SET_PERIODIC_TIME _IOW(TIMERFD_LETHE_MAJOR, 2, unsigned long)
 #define TFD_SET_WAITREAD_MODE _IOW(TIMERFD_LETHE_MAJOR, 3, bool)
 #define TFD_SET_ERROR _IOW(TIMERFD_LETHE_MAJOR, 4, bool)
+#define TFD_SET_DEADLINE _IOW(TIMERFD_LETHE_MAJOR, 5, unsigned long)
+#define TFD_GET_OVERRUN _IOR(TIMERFD_LETHE_MAJOR, 6, unsigned long)
+
+// Pollers that register with LETHE_POLL_PEEK only want the current state, a waitread
+//  object is not consumed until it is polled without it (see LinuxWaitSet)
+#define LETHE_POLL_PEEK POLLMSG
+#define LETHE_POLL_IS_PEEK(wait) ((wait) != NULL && ((wait)->key & LETHE_POLL_PEEK))
 
 int init_module(void);
 void cleanup_module(void);
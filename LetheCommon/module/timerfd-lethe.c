@@ -28,6 +28,7 @@ struct timerfd_ctx
   wait_queue_head_t wqh;
   ktime_t interval;
   u64 ticks;
+  u64 overrun; // Expirations beyond the first in the last read
   int expired;
   bool waitread;
   bool error;
@@ -69,8 +70,10 @@ int timerfd_setup(struct timerfd_ctx* ctx, const struct timespec* timer, int clo
     hrtimer_start(&ctx->timer, texp, mode);
 
   ctx->timer.function = timerfd_callback;
+  ctx->interval = ktime_set(0, 0);
   ctx->expired = 0;
   ctx->ticks = 0;
+  ctx->overrun = 0;
 
   spin_unlock_irq(&ctx->wqh.lock);
 
@@ -103,7 +106,7 @@ unsigned int timerfd_poll(struct file *file, poll_table *wait)
   {
     events |= POLLIN;
 
-    if(ctx->waitread)
+    if(ctx->waitread && !LETHE_POLL_IS_PEEK(wait))
       (void) timerfd_do_read(ctx);
   }
   spin_unlock_irqrestore(&ctx->wqh.lock, flags);
@@ -123,6 +126,7 @@ ssize_t timerfd_do_read(struct timerfd_ctx* ctx)
 
   ctx->expired = 0;
   ctx->ticks = 0;
+  ctx->overrun = ticks - 1;
 
   return ticks;
 }
@@ -174,6 +178,8 @@ long timerfd_ioctl(struct file* file, unsigned int ioctl_num, unsigned long ioct
 {
   struct timerfd_ctx* ctx = file->private_data;
   struct timespec timeout;
+  struct itimerspec deadline;
+  u64 overrun;
   int res = 0;
 
   switch(ioctl_num)
@@ -202,6 +208,25 @@ long timerfd_ioctl(struct file* file, unsigned int ioctl_num, unsigned long ioct
     }
     break;
 
+  case TFD_SET_DEADLINE: // An absolute CLOCK_MONOTONIC expiration, with an optional period after it
+    if (copy_from_user(&deadline, (void*) ioctl_param, sizeof(deadline)))
+      res = -EFAULT;
+    else
+    {
+      timerfd_setup(ctx, &deadline.it_value, CLOCK_MONOTONIC, HRTIMER_MODE_ABS);
+      ctx->interval = timespec_to_ktime(deadline.it_interval);
+    }
+    break;
+
+  case TFD_GET_OVERRUN: // The expirations missed before the last read (or auto-reset poll)
+    spin_lock_irq(&ctx->wqh.lock);
+    overrun = ctx->overrun;
+    spin_unlock_irq(&ctx->wqh.lock);
+
+    if (put_user(overrun, (u64 __user *) ioctl_param))
+      res = -EFAULT;
+    break;
+
   case TFD_SET_WAITREAD_MODE:
     spin_lock_irq(&ctx->wqh.lock);
     ctx->waitread = (ioctl_param != 0);
@@ -3,9 +3,12 @@
 #include "LetheException.h"
 #include "LetheInternal.h"
 #include <sstream>
+#include <vector>
 
 using namespace lethe;
 
+const size_t BaseThread::s_maxWaitCount(64);
+
 BaseThread::BaseThread(uint32_t timeout) :
   WaitObject(INVALID_HANDLE_VALUE),
   m_running(false),
@@ -14,7 +17,10 @@ BaseThread::BaseThread(uint32_t timeout) :
   m_stoppedEvent(true, false),
   m_exitedEvent(false, false),
   m_mutex(false),
-  m_timeout(timeout)
+  m_timeout(timeout),
+  m_waitEvents(new WaitEvent[s_maxWaitCount]),
+  m_waitCount(0),
+  m_waitOffset(0)
 {
   m_waitSet.add(m_triggerEvent);
   setHandle(m_stoppedEvent.getHandle());
@@ -36,12 +42,13 @@ BaseThread::~BaseThread()
     // Linux: pthread_cancel, pthread_kill?
     // Windows:
   }
+
+  delete [] m_waitEvents;
 }
 
 void BaseThread::threadMain()
 {
   bool initialized = false;
-  Handle handle;
 
   try
   {
@@ -65,29 +72,19 @@ void BaseThread::threadMain()
           if(m_objectQueue.size() > 0)
             handleObjectQueue();
 
-          switch(m_waitSet.waitAny(m_timeout, handle))
-          {
-          case WaitSuccess:
-            if(handle == m_triggerEvent.getHandle())
-              break;
-
-          case WaitTimeout: // Fallthrough intentional
-            iterate(handle);
-            break;
-
-          case WaitAbandoned:
-            abandoned(handle);
-            break;
+          // Every handle received from the wait has already been acquired, so the
+          //  whole batch is dispatched, even if the thread is stopped part way through
+          m_waitCount = m_waitSet.waitMany(m_timeout, m_waitEvents, s_maxWaitCount);
 
-          case WaitError:
-            if(handle == m_triggerEvent.getHandle())
-              throw std::logic_error("thread trigger event error");
+          if(m_waitCount == 0)
+            iterate(INVALID_HANDLE_VALUE);
 
-            error(handle);
-            break;
+          for(m_waitOffset = 0; m_waitOffset < m_waitCount; ++m_waitOffset)
+          {
+            if(m_objectQueue.size() > 0)
+              handleObjectQueue();
 
-          default:
-            throw std::logic_error("thread internal wait failed");
+            dispatch(m_waitEvents[m_waitOffset]);
           }
         } while(m_running);
 
@@ -142,6 +139,41 @@ void BaseThread::threadMain()
   }
 }
 
+void BaseThread::dispatch(const WaitEvent& event)
+{
+  if(event.handler != NULL && event.result != WaitTimeout)
+  {
+    event.handler->handleWait(event);
+    return;
+  }
+
+  switch(event.result)
+  {
+  case WaitSuccess:
+    if(event.handle != m_triggerEvent.getHandle())
+      iterate(event.handle);
+    break;
+
+  case WaitTimeout:
+    // The object was removed after the batch was received, skip it
+    break;
+
+  case WaitAbandoned:
+    abandoned(event.handle);
+    break;
+
+  case WaitError:
+    if(event.handle == m_triggerEvent.getHandle())
+      throw std::logic_error("thread trigger event error");
+
+    error(event.handle);
+    break;
+
+  default:
+    throw std::logic_error("thread internal wait failed");
+  }
+}
+
 void BaseThread::setup()
 {
   // Do nothing
@@ -194,33 +226,159 @@ std::string BaseThread::getError()
 
 void BaseThread::addWaitObject(WaitObject& obj)
 {
+  queueObjectOperation(ObjectOperation::Add, &obj, NULL, NULL, WaitReadable);
+}
+
+void BaseThread::addWaitObject(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  queueObjectOperation(ObjectOperation::Add, &obj, &handler, userData, interest);
+}
+
+void BaseThread::addExclusiveWaitObject(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  queueObjectOperation(ObjectOperation::AddExclusive, &obj, &handler, userData, interest);
+}
+
+void BaseThread::modifyWaitObject(WaitObject& obj, uint32_t interest)
+{
+  // Refuse a bad mask here, rather than stopping the thread when the WaitSet sees it
+  if(interest == 0 || (interest & ~(WaitReadable | WaitWritable | WaitHangup)) != 0)
+    throw std::invalid_argument("interest");
+
+  queueObjectOperation(ObjectOperation::Modify, &obj, NULL, NULL, interest);
+}
+
+void BaseThread::removeWaitObject(WaitObject& obj)
+{
+  queueObjectOperation(ObjectOperation::Remove, &obj, NULL, NULL, 0);
+}
+
+void BaseThread::setWaitPolicy(WaitPolicy policy)
+{
+  if(policy != WaitPolicyInOrder && policy != WaitPolicyRoundRobin &&
+     policy != WaitPolicyPriority && policy != WaitPolicyWeighted)
+    throw std::invalid_argument("policy");
+
+  queueObjectOperation(ObjectOperation::Policy, NULL, NULL, NULL, policy);
+}
+
+void BaseThread::setWaitPriority(WaitObject& obj, uint32_t priority)
+{
+  queueObjectOperation(ObjectOperation::Priority, &obj, NULL, NULL, priority);
+}
+
+void BaseThread::setWaitWeight(WaitObject& obj, uint32_t weight)
+{
+  if(weight == 0)
+    throw std::invalid_argument("weight");
+
+  queueObjectOperation(ObjectOperation::Weight, &obj, NULL, NULL, weight);
+}
+
+uint64_t BaseThread::getWaitDispatchCount(WaitObject& obj)
+{
+  // The mutex keeps the set from being changed by handleObjectQueue during the lookup
   m_mutex.lock();
-  m_objectQueue.push(std::pair<bool, WaitObject*>(true, &obj));
+  uint64_t count = m_waitSet.getDispatchCount(obj);
   m_mutex.unlock();
-  m_triggerEvent.set();
+
+  return count;
 }
 
-void BaseThread::removeWaitObject(WaitObject& obj)
+void BaseThread::queueObjectOperation(ObjectOperation::Type type, WaitObject* obj, WaitHandler* handler, void* userData, uint32_t value)
 {
+  ObjectOperation operation;
+  operation.type = type;
+  operation.object = obj;
+  operation.handler = handler;
+  operation.userData = userData;
+  operation.value = value;
+
   m_mutex.lock();
-  m_objectQueue.push(std::pair<bool, WaitObject*>(false, &obj));
+  m_objectQueue.push(operation);
   m_mutex.unlock();
   m_triggerEvent.set();
 }
 
 void BaseThread::handleObjectQueue()
 {
+  // Failures are reported once the mutex is released, so addFailed may queue more
+  //  operations, and an exception doesn't leave the mutex held by a stopped thread
+  std::vector<std::pair<WaitObject*, std::string> > failedAdds;
+  std::string failure;
+  bool failed = false;
+
   m_mutex.lock();
-  while(m_objectQueue.size() > 0)
+  while(!failed && m_objectQueue.size() > 0)
   {
-    if(m_objectQueue.front().first)
-      m_waitSet.add(*m_objectQueue.front().second);
-    else
-      m_waitSet.remove(*m_objectQueue.front().second);
-
+    ObjectOperation operation = m_objectQueue.front();
     m_objectQueue.pop();
+
+    try
+    {
+      switch(operation.type)
+      {
+      case ObjectOperation::Add:
+        if(operation.handler != NULL)
+          m_waitSet.add(*operation.object, *operation.handler, operation.userData, operation.value);
+        else
+          m_waitSet.add(*operation.object, operation.value);
+        break;
+
+      case ObjectOperation::AddExclusive:
+        m_waitSet.addExclusive(*operation.object, *operation.handler, operation.userData, operation.value);
+        break;
+
+      case ObjectOperation::Modify:
+        m_waitSet.modify(*operation.object, operation.value);
+        break;
+
+      case ObjectOperation::Remove:
+        {
+          Handle handle = operation.object->getHandle();
+          m_waitSet.remove(handle);
+
+          // Don't dispatch the removed object if it is still in the current batch
+          for(size_t i = m_waitOffset; i < m_waitCount; ++i)
+          {
+            if(m_waitEvents[i].handle == handle)
+              m_waitEvents[i].result = WaitTimeout;
+          }
+        }
+        break;
+
+      case ObjectOperation::Policy:
+        m_waitSet.setPolicy(static_cast<WaitPolicy>(operation.value));
+        break;
+
+      case ObjectOperation::Priority:
+        m_waitSet.setPriority(*operation.object, operation.value);
+        break;
+
+      case ObjectOperation::Weight:
+        m_waitSet.setWeight(*operation.object, operation.value);
+        break;
+      }
+    }
+    catch(std::exception& ex)
+    {
+      if(operation.type == ObjectOperation::Add || operation.type == ObjectOperation::AddExclusive)
+        failedAdds.push_back(std::make_pair(operation.object, std::string(ex.what())));
+      else
+      {
+        failure.assign(ex.what());
+        failed = true;
+      }
+    }
   }
   m_mutex.unlock();
+
+  for(size_t i = 0; i < failedAdds.size(); ++i)
+    addFailed(*failedAdds[i].first, failedAdds[i].second);
+
+  // Any other failure stops the thread, as if it had been thrown from iterate
+  if(failed)
+    throw std::runtime_error(failure);
 }
 
 void BaseThread::setWaitTimeout(uint32_t timeout)
@@ -237,3 +395,9 @@ void BaseThread::abandoned(Handle handle GCC_UNUSED)
 {
   // Do nothing, optionally implemented by a derived class
 }
+
+void BaseThread::addFailed(WaitObject& obj GCC_UNUSED, const std::string& reason)
+{
+  // Stop the thread, the same as if the WaitSet's exception had reached the main loop
+  throw std::runtime_error(reason);
+}
@@ -1,4 +1,6 @@
 #include "ByteStream.h"
+#include <vector>
+#include <string.h>
 
 using namespace lethe;
 
@@ -12,3 +14,48 @@ ByteStream::~ByteStream()
 {
   // Do nothing
 }
+
+void ByteStream::sendv(const iovec* vectors, uint32_t count)
+{
+  if(count == 1)
+  {
+    send(vectors[0].iov_base, vectors[0].iov_len);
+    return;
+  }
+
+  // Gather the buffers so the data still goes out in a single send
+  size_t size = 0;
+
+  for(uint32_t i = 0; i < count; ++i)
+    size += vectors[i].iov_len;
+
+  std::vector<uint8_t> buffer(size);
+  size_t offset = 0;
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    if(vectors[i].iov_len != 0)
+      memcpy(&buffer[offset], vectors[i].iov_base, vectors[i].iov_len);
+
+    offset += vectors[i].iov_len;
+  }
+
+  send(buffer.empty() ? NULL : &buffer[0], size);
+}
+
+uint32_t ByteStream::receivev(const iovec* vectors, uint32_t count)
+{
+  uint32_t total = 0;
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    uint32_t size = receive(vectors[i].iov_base, vectors[i].iov_len);
+    total += size;
+
+    // Stop once the stream runs out of data
+    if(size < vectors[i].iov_len)
+      break;
+  }
+
+  return total;
+}
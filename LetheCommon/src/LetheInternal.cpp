@@ -2,7 +2,14 @@
 #include "LetheFunctions.h"
 
 #if defined(__linux__)
+#include "LetheException.h"
 #include <fcntl.h>
+#include <errno.h>
+#include <climits>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 bool lethe::setCloseOnExec(Handle handle)
 {
@@ -14,28 +21,101 @@ bool lethe::setCloseOnExec(Handle handle)
 
   return true;
 }
-#endif
 
-uint64_t lethe::getEndTime(uint32_t timeout)
+void lethe::getEndTimespec(uint64_t endTime, timespec& endTimespec)
+{
+  endTimespec.tv_sec = endTime / 1000000000;
+  endTimespec.tv_nsec = endTime % 1000000000;
+}
+
+timespec* lethe::getTimeoutTimespec(uint64_t endTime, timespec& timeout)
 {
-  uint64_t endTime = timeout;
+  if(endTime == INFINITE_END_TIME)
+    return NULL;
 
-  if(timeout != INFINITE)
-    endTime = timeout + getTime();
+  uint64_t remaining = getTimeoutNs(endTime);
 
-  return endTime;
+  timeout.tv_sec = remaining / 1000000000;
+  timeout.tv_nsec = remaining % 1000000000;
+  return &timeout;
 }
 
-uint64_t lethe::getTimeout(uint64_t endTime)
+bool lethe::futexWait(volatile uint32_t* address, uint32_t value, uint64_t endTime, bool processShared)
 {
-  uint64_t timeout = endTime;
+  struct timespec endTimespec;
+  struct timespec* endTimePtr = NULL;
+
+  // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC time, so there is no need
+  //  to recalculate the timeout after a spurious wakeup
+  if(endTime != INFINITE_END_TIME)
+  {
+    getEndTimespec(endTime, endTimespec);
+    endTimePtr = &endTimespec;
+  }
+
+  int operation = (processShared ? FUTEX_WAIT_BITSET : FUTEX_WAIT_BITSET_PRIVATE);
 
-  if(endTime != INFINITE)
+  if(syscall(SYS_futex, address, operation, value, endTimePtr, NULL, FUTEX_BITSET_MATCH_ANY) != 0)
   {
-    uint64_t currentTime = getTime();
-    timeout = ((currentTime > endTime) ? 0 : (endTime - currentTime));
+    if(errno == ETIMEDOUT)
+      return false;
+    else if(errno != EAGAIN && errno != EINTR)
+      throw std::bad_syscall("futex wait", lastError());
   }
 
-  return timeout;
+  return true;
+}
+
+void lethe::futexWake(volatile uint32_t* address, uint32_t count, bool processShared)
+{
+  // The kernel takes the count as an int
+  int wakeCount = (count > INT_MAX) ? INT_MAX : count;
+  int operation = (processShared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE);
+
+  if(syscall(SYS_futex, address, operation, wakeCount, NULL, NULL, 0) == -1)
+    throw std::bad_syscall("futex wake", lastError());
+}
+#endif
+
+uint64_t lethe::getEndTime(uint32_t timeout)
+{
+  if(timeout == INFINITE)
+    return INFINITE_END_TIME;
+
+  return getMonotonicTime() + static_cast<uint64_t>(timeout) * 1000000;
 }
 
+uint64_t lethe::getEndTime(std::chrono::nanoseconds timeout)
+{
+  if(timeout == std::chrono::nanoseconds::max())
+    return INFINITE_END_TIME;
+
+  uint64_t currentTime = getMonotonicTime();
+
+  if(timeout.count() <= 0)
+    return currentTime;
+
+  // Anything past the end of the clock may as well be infinite
+  if(static_cast<uint64_t>(timeout.count()) >= INFINITE_END_TIME - currentTime)
+    return INFINITE_END_TIME;
+
+  return currentTime + timeout.count();
+}
+
+uint32_t lethe::getTimeout(uint64_t endTime)
+{
+  if(endTime == INFINITE_END_TIME)
+    return INFINITE;
+
+  uint64_t timeout = (getTimeoutNs(endTime) + 999999) / 1000000;
+  return (timeout >= INFINITE) ? (INFINITE - 1) : static_cast<uint32_t>(timeout);
+}
+
+uint64_t lethe::getTimeoutNs(uint64_t endTime)
+{
+  if(endTime == INFINITE_END_TIME)
+    return INFINITE_END_TIME;
+
+  uint64_t currentTime = getMonotonicTime();
+  return ((currentTime > endTime) ? 0 : (endTime - currentTime));
+}
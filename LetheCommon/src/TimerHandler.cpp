@@ -0,0 +1,13 @@
+#include "TimerHandler.h"
+
+using namespace lethe;
+
+TimerHandler::TimerHandler()
+{
+  // Do nothing
+}
+
+TimerHandler::~TimerHandler()
+{
+  // Do nothing
+}
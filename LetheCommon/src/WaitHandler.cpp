@@ -0,0 +1,13 @@
+#include "WaitHandler.h"
+
+using namespace lethe;
+
+WaitHandler::WaitHandler()
+{
+  // Do nothing
+}
+
+WaitHandler::~WaitHandler()
+{
+  // Do nothing
+}
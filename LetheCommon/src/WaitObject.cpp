@@ -1,5 +1,6 @@
 #include "WaitObject.h"
 #include "LetheInternal.h"
+#include <stdexcept>
 
 using namespace lethe;
 
@@ -19,8 +20,58 @@ Handle WaitObject::getHandle() const
   return m_handle;
 }
 
+Handle WaitObject::getWriteHandle() const
+{
+  return m_handle;
+}
+
+WaitResult WaitObject::wait(uint32_t timeout)
+{
+  return waitUntil(getEndTime(timeout));
+}
+
+WaitResult WaitObject::wait(std::chrono::nanoseconds timeout)
+{
+  return waitUntil(getEndTime(timeout));
+}
+
+WaitResult WaitObject::waitUntil(uint64_t endTime)
+{
+  while(true)
+  {
+    WaitResult result = waitForHandle(m_handle, endTime);
+
+    if(result != WaitSuccess || finishWait(result))
+      return result;
+  }
+}
+
 void WaitObject::setHandle(Handle handle)
 {
   m_handle = handle;
 }
 
+void WaitObject::prepareHandle()
+{
+  // Do nothing
+}
+
+bool WaitObject::finishWait(WaitResult& result GCC_UNUSED)
+{
+  return true;
+}
+
+bool WaitObject::canUndoWait() const
+{
+  return false;
+}
+
+void WaitObject::undoWait()
+{
+  throw std::logic_error("wait can't be undone");
+}
+
+bool WaitObject::tryAcquire(WaitResult& result GCC_UNUSED)
+{
+  return false;
+}
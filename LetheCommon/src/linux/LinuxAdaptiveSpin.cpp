@@ -0,0 +1,143 @@
+#include "linux/LinuxAdaptiveSpin.h"
+#include "LetheInternal.h"
+#include <unistd.h>
+#include <sched.h>
+
+using namespace lethe;
+
+const uint32_t LinuxAdaptiveSpin::s_initialLimit(100);
+const uint32_t LinuxAdaptiveSpin::s_minSpins(10);
+const uint32_t LinuxAdaptiveSpin::s_maxPause(32);
+std::atomic<uint32_t> LinuxAdaptiveSpin::s_defaultLimit(s_initialLimit);
+
+LinuxAdaptiveSpin::LinuxAdaptiveSpin() :
+  m_limit(s_defaultLimit.load()),
+  m_estimate(0),
+  m_successCount(0),
+  m_failureCount(0)
+{
+  // Do nothing
+}
+
+LinuxAdaptiveSpin::~LinuxAdaptiveSpin()
+{
+  // Do nothing
+}
+
+bool LinuxAdaptiveSpin::isMultiprocessor()
+{
+  // Nothing can release the lock while we spin on the only processor
+  static const bool multiprocessor = (sysconf(_SC_NPROCESSORS_ONLN) > 1);
+  return multiprocessor;
+}
+
+uint32_t LinuxAdaptiveSpin::getSpinCount() const
+{
+  uint32_t limit = m_limit.load();
+
+  if(limit == 0 || !isMultiprocessor())
+    return 0;
+
+  uint64_t count = (static_cast<uint64_t>(m_estimate.load()) * 2) / 8 + s_minSpins;
+  return (count < limit) ? static_cast<uint32_t>(count) : limit;
+}
+
+void LinuxAdaptiveSpin::record(bool succeeded, uint32_t spins)
+{
+  uint32_t estimate = m_estimate.load();
+
+  // Move an eighth of the way towards the retries needed, or halve the estimate
+  //  if the lock wasn't released in time.  Racing updates just lose a sample.
+  if(succeeded)
+  {
+    int64_t target = static_cast<int64_t>(spins) * 8;
+    m_estimate = static_cast<uint32_t>(estimate + (target - static_cast<int64_t>(estimate)) / 8);
+    ++m_successCount;
+  }
+  else
+  {
+    m_estimate = estimate / 2;
+    ++m_failureCount;
+  }
+}
+
+bool LinuxAdaptiveSpin::spin(WaitObject& obj, uint64_t endTime, WaitResult& result)
+{
+  uint32_t count = getSpinCount();
+
+  if(count == 0)
+    return false;
+
+  // An object that is already available doesn't count as a spin
+  if(obj.tryAcquire(result))
+    return true;
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    if(endTime != INFINITE_END_TIME && getMonotonicTime() >= endTime)
+    {
+      count = i;
+      break;
+    }
+
+    pause(i);
+
+    if(obj.tryAcquire(result))
+    {
+      record(true, i + 1);
+      return true;
+    }
+  }
+
+  if(count != 0)
+    record(false, count);
+
+  return false;
+}
+
+void LinuxAdaptiveSpin::pause(uint32_t spin)
+{
+  uint32_t count = (spin < 5) ? (1u << spin) : s_maxPause;
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+#if defined(__i386__) || defined(__x86_64__)
+    __asm__ __volatile__("pause" ::: "memory");
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    sched_yield();
+    break;
+#endif
+  }
+}
+
+void LinuxAdaptiveSpin::setLimit(uint32_t limit)
+{
+  m_limit = limit;
+}
+
+uint32_t LinuxAdaptiveSpin::getLimit() const
+{
+  return m_limit.load();
+}
+
+uint64_t LinuxAdaptiveSpin::getSuccessCount() const
+{
+  return m_successCount.load();
+}
+
+uint64_t LinuxAdaptiveSpin::getFailureCount() const
+{
+  return m_failureCount.load();
+}
+
+void LinuxAdaptiveSpin::setDefaultLimit(uint32_t limit)
+{
+  s_defaultLimit = limit;
+}
+
+uint32_t LinuxAdaptiveSpin::getDefaultLimit()
+{
+  return s_defaultLimit.load();
+}
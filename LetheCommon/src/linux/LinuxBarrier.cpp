@@ -0,0 +1,181 @@
+#include "linux/LinuxBarrier.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+#include "LetheException.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+using namespace lethe;
+
+const uint32_t LinuxBarrier::s_phaseShift(20);
+const uint32_t LinuxBarrier::s_maxCount((1 << 20) - 1);
+const uint32_t LinuxBarrier::s_maxPhase(1 << 12);
+
+LinuxBarrier::LinuxBarrier(uint32_t count) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_count(count),
+  m_state(0),
+  m_waiters(0),
+  m_handle(INVALID_HANDLE_VALUE)
+{
+  if(count == 0 || count > s_maxCount)
+    throw std::invalid_argument("barrier count out of range");
+}
+
+LinuxBarrier::~LinuxBarrier()
+{
+  if(m_handle.load() != INVALID_HANDLE_VALUE)
+    close(m_handle.load());
+}
+
+uint32_t LinuxBarrier::arrive()
+{
+  uint32_t phase;
+  arrive(phase);
+  return phase;
+}
+
+WaitResult LinuxBarrier::arriveAndWait(uint32_t timeout)
+{
+  return arriveAndWaitUntil(getEndTime(timeout));
+}
+
+WaitResult LinuxBarrier::arriveAndWait(std::chrono::nanoseconds timeout)
+{
+  return arriveAndWaitUntil(getEndTime(timeout));
+}
+
+uint32_t LinuxBarrier::getCount() const
+{
+  return m_count;
+}
+
+uint32_t LinuxBarrier::getPhase() const
+{
+  return m_state.load() >> s_phaseShift;
+}
+
+WaitResult LinuxBarrier::waitUntil(uint64_t endTime)
+{
+  if(!waitPhase(getPhase(), endTime))
+    return WaitTimeout;
+
+  return WaitSuccess;
+}
+
+void LinuxBarrier::prepareHandle()
+{
+  int handle = m_handle.load();
+
+  if(handle == INVALID_HANDLE_VALUE)
+  {
+    int newHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if(newHandle == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("eventfd", lastError());
+
+    // Another WaitSet may have beaten us to it
+    if(m_handle.compare_exchange_strong(handle, newHandle))
+      handle = newHandle;
+    else
+      close(newHandle);
+  }
+
+  setHandle(handle);
+}
+
+bool LinuxBarrier::finishWait(WaitResult& result GCC_UNUSED)
+{
+  uint64_t buffer;
+
+  // Nothing to read just means another waiter got the completion first
+  if(read(getHandle(), &buffer, sizeof(buffer)) == sizeof(buffer))
+    return true;
+  else if(errno != EAGAIN)
+    throw std::bad_syscall("eventfd read", lastError());
+
+  return false;
+}
+
+bool LinuxBarrier::arrive(uint32_t& phase)
+{
+  const uint32_t arrivedMask((1 << s_phaseShift) - 1);
+  uint32_t state = m_state.load();
+  uint32_t newState;
+  bool completed;
+
+  do
+  {
+    // The last arrival resets the count along with moving to the next phase, so
+    //  arrivals for the next phase can't be mixed up with this one
+    completed = ((state & arrivedMask) + 1 == m_count);
+    newState = (completed ? (state & ~arrivedMask) + (1 << s_phaseShift) : state + 1);
+  } while(!m_state.compare_exchange_weak(state, newState));
+
+  phase = state >> s_phaseShift;
+
+  if(completed)
+  {
+    if(m_waiters.load() != 0)
+      futexWake(reinterpret_cast<volatile uint32_t*>(&m_state), UINT32_MAX);
+
+    int handle = m_handle.load();
+    uint64_t buffer(1);
+
+    if(handle != INVALID_HANDLE_VALUE &&
+       write(handle, &buffer, sizeof(buffer)) != sizeof(buffer))
+      throw std::bad_syscall("eventfd write", lastError());
+  }
+
+  return completed;
+}
+
+WaitResult LinuxBarrier::arriveAndWaitUntil(uint64_t endTime)
+{
+  uint32_t phase;
+
+  if(arrive(phase) || waitPhase(phase, endTime))
+    return WaitSuccess;
+
+  // Take the arrival back, unless the phase completed in the meantime
+  uint32_t state = m_state.load();
+
+  while((state >> s_phaseShift) == phase)
+  {
+    if(m_state.compare_exchange_weak(state, state - 1))
+      return WaitTimeout;
+  }
+
+  return WaitSuccess;
+}
+
+bool LinuxBarrier::waitPhase(uint32_t phase, uint64_t endTime)
+{
+  uint32_t state = m_state.load();
+
+  while((state >> s_phaseShift) == phase)
+  {
+    bool result;
+
+    ++m_waiters;
+
+    try
+    {
+      result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_state), state, endTime);
+    }
+    catch(...)
+    {
+      --m_waiters;
+      throw;
+    }
+
+    --m_waiters;
+    state = m_state.load();
+
+    if(!result)
+      return ((state >> s_phaseShift) != phase);
+  }
+
+  return true;
+}
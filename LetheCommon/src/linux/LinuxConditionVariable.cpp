@@ -0,0 +1,99 @@
+#include "linux/LinuxConditionVariable.h"
+#include "linux/LinuxMutex.h"
+#include "linux/LinuxFastMutex.h"
+#include "LetheInternal.h"
+#include <stdexcept>
+
+using namespace lethe;
+
+LinuxConditionVariable::LinuxConditionVariable() :
+  m_sequence(0),
+  m_waiters(0)
+{
+  // Do nothing
+}
+
+LinuxConditionVariable::~LinuxConditionVariable()
+{
+  // Do nothing
+}
+
+WaitResult LinuxConditionVariable::wait(LinuxMutex& mutex, uint32_t timeout)
+{
+  return waitUntil(mutex, getEndTime(timeout));
+}
+
+WaitResult LinuxConditionVariable::wait(LinuxMutex& mutex, std::chrono::nanoseconds timeout)
+{
+  return waitUntil(mutex, getEndTime(timeout));
+}
+
+WaitResult LinuxConditionVariable::wait(LinuxFastMutex& mutex, uint32_t timeout)
+{
+  return waitUntil(mutex, getEndTime(timeout));
+}
+
+WaitResult LinuxConditionVariable::wait(LinuxFastMutex& mutex, std::chrono::nanoseconds timeout)
+{
+  return waitUntil(mutex, getEndTime(timeout));
+}
+
+void LinuxConditionVariable::signal()
+{
+  wake(1);
+}
+
+void LinuxConditionVariable::broadcast()
+{
+  wake(UINT32_MAX);
+}
+
+template <typename MutexType>
+WaitResult LinuxConditionVariable::waitUntil(MutexType& mutex, uint64_t endTime)
+{
+  bool signaled;
+
+  // unlock() only releases one level of a recursive lock, waiting would sleep
+  //  with the mutex still held
+  if(mutex.isLockedRecursively())
+    throw std::logic_error("mutex locked more than once can't be used to wait on a condition variable");
+
+  // Count ourselves before unlocking, so a signal sent under the mutex after
+  //  that is sure to see us, and load the sequence it will change
+  ++m_waiters;
+  uint32_t sequence = m_sequence.load();
+
+  try
+  {
+    mutex.unlock();
+  }
+  catch(...)
+  {
+    --m_waiters;
+    throw;
+  }
+
+  try
+  {
+    signaled = futexWait(reinterpret_cast<volatile uint32_t*>(&m_sequence), sequence, endTime);
+  }
+  catch(...)
+  {
+    --m_waiters;
+    mutex.lock();
+    throw;
+  }
+
+  --m_waiters;
+  mutex.lock();
+  return (signaled ? WaitSuccess : WaitTimeout);
+}
+
+void LinuxConditionVariable::wake(uint32_t count)
+{
+  if(m_waiters.load() == 0)
+    return;
+
+  ++m_sequence;
+  futexWake(reinterpret_cast<volatile uint32_t*>(&m_sequence), count);
+}
@@ -8,6 +8,7 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include "eventfd-lethe.h"
+#include <sys/eventfd.h>
 #include <errno.h>
 
 using namespace lethe;
@@ -15,8 +16,23 @@ using namespace lethe;
 const std::string LinuxEvent::s_eventfdDevice("/dev/eventfd-lethe");
 
 LinuxEvent::LinuxEvent(bool initialState, bool autoReset) :
-  WaitObject(open(s_eventfdDevice.c_str(), O_RDWR))
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_stock(!useLetheModule(s_eventfdDevice)),
+  m_autoReset(autoReset),
+  m_error(false)
 {
+  if(m_stock)
+  {
+    setHandle(eventfd(initialState ? 1 : 0, EFD_NONBLOCK | EFD_CLOEXEC));
+
+    if(getHandle() == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("eventfd", lastError());
+
+    return;
+  }
+
+  setHandle(open(s_eventfdDevice.c_str(), O_RDWR));
+
   if(getHandle() == INVALID_HANDLE_VALUE)
     throw std::bad_syscall("eventfd open", lastError());
 
@@ -40,7 +56,10 @@ LinuxEvent::LinuxEvent(bool initialState, bool autoReset) :
 }
 
 LinuxEvent::LinuxEvent(Handle handle) :
-  WaitObject(handle)
+  WaitObject(handle),
+  m_stock(false),
+  m_autoReset(false),
+  m_error(false)
 {
   if(getHandle() == INVALID_HANDLE_VALUE)
     throw std::invalid_argument("handle");
@@ -89,7 +108,32 @@ void LinuxEvent::reset()
 
 void LinuxEvent::error()
 {
-  if(ioctl(getHandle(), EFD_SET_ERROR, true) != 0)
+  if(m_stock)
+  {
+    // A stock eventfd can't report an error, wake up the waiters so finishWait can
+    m_error = true;
+    set();
+  }
+  else if(ioctl(getHandle(), EFD_SET_ERROR, true) != 0)
     throw std::bad_syscall("eventfd ioctl EFD_SET_ERROR", lastError());
 }
 
+bool LinuxEvent::finishWait(WaitResult& result)
+{
+  if(!m_stock)
+    return true;
+
+  if(m_error)
+  {
+    result = WaitAbandoned;
+    return true;
+  }
+
+  if(!m_autoReset)
+    return true;
+
+  // The event only lets through the waiter that manages to reset it
+  uint64_t state;
+  return (read(getHandle(), &state, sizeof(state)) == sizeof(state));
+}
+
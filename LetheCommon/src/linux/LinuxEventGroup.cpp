@@ -0,0 +1,230 @@
+#include "linux/LinuxEventGroup.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+#include "LetheException.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+using namespace lethe;
+
+LinuxEventGroup::LinuxEventGroup(uint64_t initialBits) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_bits(initialBits),
+  m_sequence(0),
+  m_waiters(0),
+  m_handle(INVALID_HANDLE_VALUE),
+  m_waitMask(UINT64_MAX),
+  m_waitAll(false),
+  m_waitClear(false),
+  m_firedBits(0)
+{
+  // Do nothing
+}
+
+LinuxEventGroup::~LinuxEventGroup()
+{
+  if(m_handle.load() != INVALID_HANDLE_VALUE)
+    close(m_handle.load());
+}
+
+void LinuxEventGroup::set(uint64_t mask)
+{
+  uint64_t bits = m_bits.fetch_or(mask);
+
+  // Nothing to wake if every bit was already set
+  if((bits | mask) == bits)
+    return;
+
+  ++m_sequence;
+
+  if(m_waiters.load() != 0)
+    futexWake(reinterpret_cast<volatile uint32_t*>(&m_sequence), UINT32_MAX);
+
+  int handle = m_handle.load();
+
+  if(handle != INVALID_HANDLE_VALUE && waitMaskMatches())
+    signalHandle(handle);
+}
+
+void LinuxEventGroup::clear(uint64_t mask)
+{
+  m_bits.fetch_and(~mask);
+}
+
+uint64_t LinuxEventGroup::getBits() const
+{
+  return m_bits.load();
+}
+
+uint64_t LinuxEventGroup::waitAny(uint64_t mask, uint32_t timeout, bool clear)
+{
+  return waitBits(mask, false, clear, getEndTime(timeout));
+}
+
+uint64_t LinuxEventGroup::waitAny(uint64_t mask, std::chrono::nanoseconds timeout, bool clear)
+{
+  return waitBits(mask, false, clear, getEndTime(timeout));
+}
+
+uint64_t LinuxEventGroup::waitAll(uint64_t mask, uint32_t timeout, bool clear)
+{
+  return waitBits(mask, true, clear, getEndTime(timeout));
+}
+
+uint64_t LinuxEventGroup::waitAll(uint64_t mask, std::chrono::nanoseconds timeout, bool clear)
+{
+  return waitBits(mask, true, clear, getEndTime(timeout));
+}
+
+void LinuxEventGroup::setWaitMask(uint64_t mask, bool all, bool clear)
+{
+  if(mask == 0)
+    throw std::invalid_argument("event group wait mask is empty");
+
+  m_waitMask.store(mask);
+  m_waitAll.store(all);
+  m_waitClear.store(clear);
+
+  // The bits may already match the new mask
+  int handle = m_handle.load();
+
+  if(handle != INVALID_HANDLE_VALUE && waitMaskMatches())
+    signalHandle(handle);
+}
+
+uint64_t LinuxEventGroup::getFiredBits() const
+{
+  return m_firedBits.load();
+}
+
+WaitResult LinuxEventGroup::waitUntil(uint64_t endTime)
+{
+  uint64_t fired = waitBits(m_waitMask.load(), m_waitAll.load(), m_waitClear.load(), endTime);
+
+  if(fired == 0)
+    return WaitTimeout;
+
+  m_firedBits.store(fired);
+  return WaitSuccess;
+}
+
+void LinuxEventGroup::prepareHandle()
+{
+  int handle = m_handle.load();
+
+  if(handle == INVALID_HANDLE_VALUE)
+  {
+    int newHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if(newHandle == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("eventfd", lastError());
+
+    // Another WaitSet may have beaten us to it
+    if(m_handle.compare_exchange_strong(handle, newHandle))
+    {
+      handle = newHandle;
+
+      // The bits may have been set before the handle could be seen
+      if(waitMaskMatches())
+        signalHandle(handle);
+    }
+    else
+      close(newHandle);
+  }
+
+  setHandle(handle);
+}
+
+bool LinuxEventGroup::finishWait(WaitResult& result GCC_UNUSED)
+{
+  uint64_t buffer;
+
+  // Nothing to read just means another waiter got the bits first
+  if(read(getHandle(), &buffer, sizeof(buffer)) != sizeof(buffer))
+  {
+    if(errno != EAGAIN)
+      throw std::bad_syscall("eventfd read", lastError());
+
+    return false;
+  }
+
+  // The bits may have been cleared since the handle was signaled
+  uint64_t fired = takeBits(m_waitMask.load(), m_waitAll.load(), m_waitClear.load());
+
+  if(fired == 0)
+    return false;
+
+  m_firedBits.store(fired);
+
+  // Bits that are still set keep the handle signaled
+  if(waitMaskMatches())
+    signalHandle(getHandle());
+
+  return true;
+}
+
+uint64_t LinuxEventGroup::takeBits(uint64_t mask, bool all, bool clear)
+{
+  uint64_t bits = m_bits.load();
+
+  while(true)
+  {
+    uint64_t fired = bits & mask;
+
+    if(fired == 0 || (all && fired != mask))
+      return 0;
+
+    if(!clear || m_bits.compare_exchange_weak(bits, bits & ~fired))
+      return fired;
+  }
+}
+
+uint64_t LinuxEventGroup::waitBits(uint64_t mask, bool all, bool clear, uint64_t endTime)
+{
+  if(mask == 0)
+    throw std::invalid_argument("event group wait mask is empty");
+
+  while(true)
+  {
+    // The sequence is loaded before the bits, so a set after the bits were
+    //  checked changes it and the futex won't sleep
+    uint32_t sequence = m_sequence.load();
+    uint64_t fired = takeBits(mask, all, clear);
+
+    if(fired != 0)
+      return fired;
+
+    bool result;
+
+    ++m_waiters;
+
+    try
+    {
+      result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_sequence), sequence, endTime);
+    }
+    catch(...)
+    {
+      --m_waiters;
+      throw;
+    }
+
+    --m_waiters;
+
+    if(!result)
+      return takeBits(mask, all, clear);
+  }
+}
+
+bool LinuxEventGroup::waitMaskMatches()
+{
+  return (takeBits(m_waitMask.load(), m_waitAll.load(), false) != 0);
+}
+
+void LinuxEventGroup::signalHandle(int handle)
+{
+  uint64_t buffer(1);
+
+  if(write(handle, &buffer, sizeof(buffer)) != sizeof(buffer))
+    throw std::bad_syscall("eventfd write", lastError());
+}
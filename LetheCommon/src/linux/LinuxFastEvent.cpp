@@ -0,0 +1,83 @@
+#include "linux/LinuxFastEvent.h"
+#include "linux/LinuxEvent.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+
+using namespace lethe;
+
+LinuxFastEvent::LinuxFastEvent(bool initialState, bool autoReset) :
+  LinuxFastObject(initialState ? 1 : 0),
+  m_autoReset(autoReset)
+{
+  // Do nothing
+}
+
+LinuxFastEvent::~LinuxFastEvent()
+{
+  // Do nothing
+}
+
+void LinuxFastEvent::set()
+{
+  uint32_t state = loadState();
+
+  while(!(state & s_kernelBit))
+  {
+    if(state == 1)
+      return;
+
+    if(updateState(state, 1))
+    {
+      // An auto-reset event only lets one waiter through
+      wakeWaiters(m_autoReset ? 1 : UINT32_MAX);
+      return;
+    }
+  }
+
+  static_cast<LinuxEvent*>(getKernelObject())->set();
+}
+
+void LinuxFastEvent::reset()
+{
+  uint32_t state = loadState();
+
+  while(!(state & s_kernelBit))
+  {
+    if(state == 0 || updateState(state, 0))
+      return;
+  }
+
+  static_cast<LinuxEvent*>(getKernelObject())->reset();
+}
+
+void LinuxFastEvent::error()
+{
+  // Errors are only reported through the handle
+  prepareHandle();
+  static_cast<LinuxEvent*>(getKernelObject())->error();
+}
+
+WaitResult LinuxFastEvent::waitUntil(uint64_t endTime)
+{
+  uint32_t state = loadState();
+
+  while(!(state & s_kernelBit))
+  {
+    if(state == 1)
+    {
+      if(!m_autoReset || updateState(state, 0))
+        return WaitSuccess;
+    }
+    else if(!waitState(state, endTime))
+      return WaitTimeout;
+    else
+      state = loadState();
+  }
+
+  return waitKernelObject(endTime);
+}
+
+WaitObject* LinuxFastEvent::createKernelObject(uint32_t state)
+{
+  return new LinuxEvent(state == 1, m_autoReset);
+}
@@ -0,0 +1,157 @@
+#include "linux/LinuxFastMutex.h"
+#include "linux/LinuxMutex.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+#include "LetheException.h"
+#include <errno.h>
+
+using namespace lethe;
+
+LinuxFastMutex::LinuxFastMutex(bool locked) :
+  LinuxFastObject(locked ? 1 : 0),
+  m_owner(locked ? pthread_self() : 0),
+  m_lockCount(locked ? 1 : 0)
+{
+  // Do nothing
+}
+
+LinuxFastMutex::~LinuxFastMutex()
+{
+  // Do nothing
+}
+
+void LinuxFastMutex::lock(uint32_t timeout)
+{
+  if(wait(timeout) != WaitSuccess)
+    throw std::runtime_error("failed to wait for mutex");
+}
+
+void LinuxFastMutex::unlock()
+{
+  uint32_t state = loadState();
+
+  if(state & s_kernelBit)
+  {
+    static_cast<LinuxMutex*>(getKernelObject())->unlock();
+    return;
+  }
+
+  if(m_owner.load() != pthread_self())
+    throw std::bad_syscall("mutex unlock", getErrorString(EPERM));
+
+  if(--m_lockCount != 0)
+    return;
+
+  m_owner.store(0);
+
+  // While locked, the state can only be changed by another thread briefly
+  //  freezing it while failing to move the mutex to the kernel
+  while(!updateState(state, 0))
+  {
+    // Do nothing
+  }
+
+  wakeWaiters(1);
+}
+
+void LinuxFastMutex::error()
+{
+  // Errors are only reported through the handle
+  prepareHandle();
+  static_cast<LinuxMutex*>(getKernelObject())->error();
+}
+
+WaitResult LinuxFastMutex::waitUntil(uint64_t endTime)
+{
+  uint32_t state = loadState();
+  bool spun = false;
+
+  while(!(state & s_kernelBit))
+  {
+    if(m_owner.load() == pthread_self())
+    {
+      ++m_lockCount;
+      return WaitSuccess;
+    }
+
+    if(state == 0)
+    {
+      if(updateState(state, 1))
+      {
+        m_owner.store(pthread_self());
+        m_lockCount = 1;
+        return WaitSuccess;
+      }
+    }
+    else if(!spun)
+    {
+      // Only spin once per wait, if the mutex is taken again go to sleep
+      spun = true;
+      state = spinState(state, endTime, m_spin);
+    }
+    else if(!waitState(state, endTime))
+      return WaitTimeout;
+    else
+      state = loadState();
+  }
+
+  return waitKernelObject(endTime);
+}
+
+bool LinuxFastMutex::isLockedRecursively()
+{
+  if(loadState() & s_kernelBit)
+    return static_cast<LinuxMutex*>(getKernelObject())->isLockedRecursively();
+
+  return (m_owner.load() == pthread_self() && m_lockCount > 1);
+}
+
+LinuxAdaptiveSpin& LinuxFastMutex::getSpin()
+{
+  if(loadState() & s_kernelBit)
+    return static_cast<LinuxMutex*>(getKernelObject())->getSpin();
+
+  return m_spin;
+}
+
+WaitObject* LinuxFastMutex::createKernelObject(uint32_t state)
+{
+  if(state == 0)
+  {
+    LinuxMutex* mutex = new LinuxMutex(false);
+    mutex->getSpin().setLimit(m_spin.getLimit());
+    return mutex;
+  }
+
+  if(m_owner.load() != pthread_self())
+    throw std::logic_error("mutex locked by another thread can't be moved to the kernel");
+
+  // The kernel mutex starts with one lock held by this thread, add the rest
+  LinuxMutex* mutex = new LinuxMutex(true);
+  mutex->getSpin().setLimit(m_spin.getLimit());
+
+  try
+  {
+    for(uint32_t i = 1; i < m_lockCount; ++i)
+      mutex->lock(0);
+  }
+  catch(...)
+  {
+    delete mutex;
+    throw;
+  }
+
+  m_owner.store(0);
+  m_lockCount = 0;
+  return mutex;
+}
+
+bool LinuxFastMutex::canUndoWait() const
+{
+  return true;
+}
+
+void LinuxFastMutex::undoWait()
+{
+  unlock();
+}
@@ -0,0 +1,153 @@
+#include "linux/LinuxFastObject.h"
+#include "LetheInternal.h"
+#include <sched.h>
+
+using namespace lethe;
+
+const uint32_t LinuxFastObject::s_kernelBit(0x80000000);
+const uint32_t LinuxFastObject::s_promotingBit(0x40000000);
+const uint32_t LinuxFastObject::s_stateMask(0x3FFFFFFF);
+
+LinuxFastObject::LinuxFastObject(uint32_t state) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_state(state),
+  m_waiters(0),
+  m_kernelObject(NULL)
+{
+  // Do nothing
+}
+
+LinuxFastObject::~LinuxFastObject()
+{
+  delete m_kernelObject;
+}
+
+uint32_t LinuxFastObject::loadState()
+{
+  uint32_t state = m_state.load();
+
+  // A move to the kernel only takes as long as creating the kernel object
+  while(state & s_promotingBit)
+  {
+    sched_yield();
+    state = m_state.load();
+  }
+
+  return state;
+}
+
+bool LinuxFastObject::updateState(uint32_t& state, uint32_t newState)
+{
+  if(m_state.compare_exchange_strong(state, newState))
+    return true;
+
+  state = loadState();
+  return false;
+}
+
+uint32_t LinuxFastObject::spinState(uint32_t state, uint64_t endTime, LinuxAdaptiveSpin& spin)
+{
+  uint32_t count = spin.getSpinCount();
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    if(endTime != INFINITE_END_TIME && getMonotonicTime() >= endTime)
+    {
+      count = i;
+      break;
+    }
+
+    LinuxAdaptiveSpin::pause(i);
+
+    if(m_state.load() != state)
+    {
+      spin.record(true, i + 1);
+      return loadState();
+    }
+  }
+
+  if(count != 0)
+    spin.record(false, count);
+
+  return state;
+}
+
+bool LinuxFastObject::waitState(uint32_t state, uint64_t endTime)
+{
+  bool result;
+
+  // The waiter count must be visible before the futex checks the state, so that
+  //  a thread changing the state afterwards will see it and wake us
+  ++m_waiters;
+
+  try
+  {
+    result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_state), state, endTime);
+  }
+  catch(...)
+  {
+    --m_waiters;
+    throw;
+  }
+
+  --m_waiters;
+  return result;
+}
+
+void LinuxFastObject::wakeWaiters(uint32_t count)
+{
+  if(m_waiters.load() != 0)
+    futexWake(reinterpret_cast<volatile uint32_t*>(&m_state), count);
+}
+
+void LinuxFastObject::prepareHandle()
+{
+  uint32_t state = m_state.load();
+
+  // Freeze the state while the kernel object is created
+  while(true)
+  {
+    if(state & s_kernelBit)
+      return;
+
+    if(state & s_promotingBit)
+    {
+      sched_yield();
+      state = m_state.load();
+    }
+    else if(m_state.compare_exchange_strong(state, state | s_promotingBit))
+      break;
+  }
+
+  try
+  {
+    m_kernelObject = createKernelObject(state);
+  }
+  catch(...)
+  {
+    m_state.store(state);
+    throw;
+  }
+
+  setHandle(m_kernelObject->getHandle());
+  m_state.store(s_kernelBit);
+
+  // Any threads sleeping on the futex must go wait on the handle
+  wakeWaiters(UINT32_MAX);
+}
+
+bool LinuxFastObject::finishWait(WaitResult& result)
+{
+  // Only called once the object has a handle
+  return m_kernelObject->finishWait(result);
+}
+
+WaitObject* LinuxFastObject::getKernelObject() const
+{
+  return m_kernelObject;
+}
+
+WaitResult LinuxFastObject::waitKernelObject(uint64_t endTime)
+{
+  return m_kernelObject->waitUntil(endTime);
+}
@@ -0,0 +1,189 @@
+#include "linux/LinuxFastSemaphore.h"
+#include "linux/LinuxSemaphore.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+#include "LetheException.h"
+#include <errno.h>
+#include <algorithm>
+
+using namespace lethe;
+
+const uint32_t LinuxFastSemaphore::s_maxCount(0x3FFFFFFF);
+
+LinuxFastSemaphore::LinuxFastSemaphore(uint32_t maxCount, uint32_t initialCount) :
+  LinuxFastObject(initialCount),
+  m_maxCount(maxCount),
+  m_batchWaiters(0)
+{
+  if(maxCount == 0 || maxCount > s_maxCount)
+    throw std::invalid_argument("maxCount");
+
+  if(initialCount > maxCount)
+    throw std::invalid_argument("initialCount");
+}
+
+LinuxFastSemaphore::~LinuxFastSemaphore()
+{
+  // Do nothing
+}
+
+void LinuxFastSemaphore::lock(uint32_t timeout)
+{
+  if(wait(timeout) != WaitSuccess)
+    throw std::runtime_error("failed to wait for semaphore");
+}
+
+void LinuxFastSemaphore::lock(uint32_t count, uint32_t timeout)
+{
+  if(lockUntil(count, false, getEndTime(timeout)) == 0)
+    throw std::runtime_error("failed to wait for semaphore");
+}
+
+uint32_t LinuxFastSemaphore::lockUpTo(uint32_t count, uint32_t timeout)
+{
+  uint32_t taken = lockUntil(count, true, getEndTime(timeout));
+
+  if(taken == 0)
+    throw std::runtime_error("failed to wait for semaphore");
+
+  return taken;
+}
+
+bool LinuxFastSemaphore::tryLock(uint32_t count)
+{
+  return (lockUntil(count, false, 0) != 0);
+}
+
+uint32_t LinuxFastSemaphore::tryLockUpTo(uint32_t count)
+{
+  return lockUntil(count, true, 0);
+}
+
+void LinuxFastSemaphore::unlock(uint32_t count)
+{
+  uint32_t state = loadState();
+
+  while(!(state & s_kernelBit))
+  {
+    if(count > m_maxCount - state)
+      throw std::bad_syscall("semaphore unlock", getErrorString(EINVAL));
+
+    if(updateState(state, state + count))
+    {
+      wakeWaiters(m_batchWaiters.load() != 0 ? UINT32_MAX : count);
+      return;
+    }
+  }
+
+  static_cast<LinuxSemaphore*>(getKernelObject())->unlock(count);
+}
+
+void LinuxFastSemaphore::error()
+{
+  // Errors are only reported through the handle
+  prepareHandle();
+  static_cast<LinuxSemaphore*>(getKernelObject())->error();
+}
+
+WaitResult LinuxFastSemaphore::waitUntil(uint64_t endTime)
+{
+  uint32_t state = loadState();
+  bool spun = false;
+
+  while(!(state & s_kernelBit))
+  {
+    if(state != 0)
+    {
+      if(updateState(state, state - 1))
+        return WaitSuccess;
+    }
+    else if(!spun)
+    {
+      spun = true;
+      state = spinState(state, endTime, m_spin);
+    }
+    else if(!waitState(state, endTime))
+      return WaitTimeout;
+    else
+      state = loadState();
+  }
+
+  return waitKernelObject(endTime);
+}
+
+LinuxAdaptiveSpin& LinuxFastSemaphore::getSpin()
+{
+  if(loadState() & s_kernelBit)
+    return static_cast<LinuxSemaphore*>(getKernelObject())->getSpin();
+
+  return m_spin;
+}
+
+WaitObject* LinuxFastSemaphore::createKernelObject(uint32_t state)
+{
+  LinuxSemaphore* semaphore = new LinuxSemaphore(m_maxCount, state);
+  semaphore->getSpin().setLimit(m_spin.getLimit());
+  return semaphore;
+}
+
+uint32_t LinuxFastSemaphore::lockUntil(uint32_t count, bool upTo, uint64_t endTime)
+{
+  if(count == 0)
+    throw std::invalid_argument("count");
+
+  // Count ourselves before loading the state, so an unlock after that wakes us
+  ++m_batchWaiters;
+
+  uint32_t state = loadState();
+  uint32_t taken = 0;
+  bool spun = false;
+
+  try
+  {
+    while(!(state & s_kernelBit))
+    {
+      if(state != 0 && (upTo || state >= count))
+      {
+        taken = std::min(state, count);
+
+        if(updateState(state, state - taken))
+          break;
+
+        taken = 0;
+      }
+      else if(endTime == 0)
+        break; // Only trying
+      else if(!spun)
+      {
+        spun = true;
+        state = spinState(state, endTime, m_spin);
+      }
+      else if(!waitState(state, endTime))
+        break;
+      else
+        state = loadState();
+    }
+  }
+  catch(...)
+  {
+    --m_batchWaiters;
+    throw;
+  }
+
+  --m_batchWaiters;
+
+  if(state & s_kernelBit)
+    return static_cast<LinuxSemaphore*>(getKernelObject())->lockUntil(count, upTo, endTime);
+
+  return taken;
+}
+
+bool LinuxFastSemaphore::canUndoWait() const
+{
+  return true;
+}
+
+void LinuxFastSemaphore::undoWait()
+{
+  unlock(1);
+}
@@ -6,14 +6,43 @@
 #include <stdlib.h>
 #include <sys/time.h>
 #include <poll.h>
+#include <sched.h>
 #include <string.h>
 #include <errno.h>
 #include <string>
 #include <vector>
+#include <exception>
 #include <sstream>
 #include <iomanip>
 #include <ctime>
 
+static lethe::LinuxBackend s_linuxBackend = lethe::LinuxBackendAuto;
+
+void lethe::setLinuxBackend(lethe::LinuxBackend backend)
+{
+  s_linuxBackend = backend;
+}
+
+lethe::LinuxBackend lethe::getLinuxBackend()
+{
+  return s_linuxBackend;
+}
+
+bool lethe::useLetheModule(const std::string& device)
+{
+  switch(s_linuxBackend)
+  {
+  case lethe::LinuxBackendModules:
+    return true;
+
+  case lethe::LinuxBackendStock:
+    return false;
+
+  default:
+    return (access(device.c_str(), R_OK | W_OK) == 0);
+  }
+}
+
 uint32_t lethe::getParentProcessId()
 {
   return getppid();
@@ -59,20 +88,28 @@ uint32_t lethe::createProcess(const std::string& command,
 
 void lethe::sleep_ms(uint32_t timeout)
 {
-  struct timespec remaining;
-  uint32_t endTime = getEndTime(timeout);
+  lethe::sleepUntil(lethe::getEndTime(timeout));
+}
 
-  remaining.tv_sec = timeout / 1000;
-  remaining.tv_nsec = (timeout % 1000) * 1000000;
+void lethe::sleep_ms(std::chrono::nanoseconds timeout)
+{
+  lethe::sleepUntil(lethe::getEndTime(timeout));
+}
 
-  // Loop in case of EINTR - nanosleep should update remainder
-  while(nanosleep(&remaining, NULL) == -1 && errno == EINTR);
-  {
-    timeout = getTimeout(endTime);
+void lethe::sleepUntil(uint64_t endTime)
+{
+  struct timespec endTimespec;
 
-    remaining.tv_sec = timeout / 1000;
-    remaining.tv_nsec = (timeout % 1000) * 1000000;
+  if(endTime == lethe::INFINITE_END_TIME)
+  {
+    while(true)
+      pause();
   }
+
+  lethe::getEndTimespec(endTime, endTimespec);
+
+  // Sleeping until an absolute time means an EINTR can just sleep again
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &endTimespec, NULL) == EINTR);
 }
 
 std::string lethe::getErrorString(uint32_t errorCode)
@@ -111,6 +148,16 @@ uint64_t lethe::getTime()
   return (currentTime.tv_sec * 1000) + (currentTime.tv_usec / 1000);
 }
 
+uint64_t lethe::getMonotonicTime()
+{
+  timespec currentTime;
+
+  if(clock_gettime(CLOCK_MONOTONIC, &currentTime) != 0)
+    throw std::bad_syscall("clock_gettime", lethe::lastError());
+
+  return (static_cast<uint64_t>(currentTime.tv_sec) * 1000000000) + currentTime.tv_nsec;
+}
+
 std::string lethe::getTimeString()
 {
   std::ostringstream stream;
@@ -139,14 +186,115 @@ uint32_t lethe::getThreadId()
 
 lethe::WaitResult lethe::WaitForObject(lethe::WaitObject& obj, uint32_t timeout)
 {
-  return WaitForObject(obj.getHandle(), timeout);
+  return obj.wait(timeout);
+}
+
+lethe::WaitResult lethe::WaitForObject(lethe::WaitObject& obj, std::chrono::nanoseconds timeout)
+{
+  return obj.wait(timeout);
 }
 
 lethe::WaitResult lethe::WaitForObject(lethe::Handle handle, uint32_t timeout)
 {
-  uint32_t endTime = lethe::getEndTime(timeout);
+  return lethe::waitForHandle(handle, lethe::getEndTime(timeout));
+}
+
+lethe::WaitResult lethe::WaitForObject(lethe::Handle handle, std::chrono::nanoseconds timeout)
+{
+  return lethe::waitForHandle(handle, lethe::getEndTime(timeout));
+}
+
+lethe::WaitResult lethe::WaitForAllObjects(lethe::WaitObject** objects, uint32_t count, uint32_t timeout)
+{
+  return lethe::waitForAllObjects(objects, count, lethe::getEndTime(timeout));
+}
+
+lethe::WaitResult lethe::WaitForAllObjects(lethe::WaitObject** objects, uint32_t count, std::chrono::nanoseconds timeout)
+{
+  return lethe::waitForAllObjects(objects, count, lethe::getEndTime(timeout));
+}
+
+lethe::WaitResult lethe::waitForAllObjects(lethe::WaitObject** objects, uint32_t count, uint64_t endTime)
+{
+  if(objects == NULL || count == 0)
+    throw std::invalid_argument("no objects to wait for");
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    if(objects[i] == NULL || !objects[i]->canUndoWait())
+      throw std::invalid_argument("object can't be used with WaitForAllObjects");
+
+    for(uint32_t j = 0; j < i; ++j)
+    {
+      if(objects[j] == objects[i])
+        throw std::invalid_argument("object given to WaitForAllObjects more than once");
+    }
+  }
+
+  // Block on one object, then try to take the rest without waiting.  If one of
+  //  them is busy, give everything back and block on that one instead, so no
+  //  object is ever held while waiting for another (the same back-off as
+  //  std::lock), and the wait always moves to the object that is contended.
+  uint32_t first = 0;
+
+  while(true)
+  {
+    lethe::WaitResult result = objects[first]->waitUntil(endTime);
+
+    if(result != lethe::WaitSuccess)
+      return result;
+
+    uint64_t now = lethe::getMonotonicTime();
+    std::exception_ptr error;
+    uint32_t i;
+
+    for(i = 0; i < count; ++i)
+    {
+      if(i == first)
+        continue;
+
+      try
+      {
+        result = objects[i]->waitUntil(now);
+      }
+      catch(...)
+      {
+        error = std::current_exception();
+        break;
+      }
+
+      if(result != lethe::WaitSuccess)
+        break;
+    }
+
+    if(i == count)
+      return lethe::WaitSuccess;
+
+    // Give back everything taken, in the reverse order
+    for(uint32_t j = i; j-- > 0;)
+    {
+      if(j != first)
+        objects[j]->undoWait();
+    }
+
+    objects[first]->undoWait();
+
+    if(error)
+      std::rethrow_exception(error);
+    else if(result != lethe::WaitTimeout)
+      return result;
+
+    // Let the holder of the busy object run before competing for it again
+    first = i;
+    sched_yield();
+  }
+}
+
+lethe::WaitResult lethe::waitForHandle(lethe::Handle handle, uint64_t endTime)
+{
   lethe::WaitResult result = lethe::WaitSuccess;
   struct pollfd pollData;
+  struct timespec timeout;
   int pollResult;
 
   while(true)
@@ -154,7 +302,8 @@ lethe::WaitResult lethe::WaitForObject(lethe::Handle handle, uint32_t timeout)
     pollData.fd = handle;
     pollData.events = POLLIN | POLLERR | POLLHUP;
 
-    pollResult = poll(&pollData, 1, timeout);
+    // ppoll takes the timeout in ns, where poll would round it to ms
+    pollResult = ppoll(&pollData, 1, lethe::getTimeoutTimespec(endTime, timeout), NULL);
 
     if(pollResult == 1)
     {
@@ -168,19 +317,15 @@ lethe::WaitResult lethe::WaitForObject(lethe::Handle handle, uint32_t timeout)
       break;
     }
     else if(errno == EINTR)
-    {
-      timeout = lethe::getTimeout(endTime);
       continue;
-    }
     else if(errno == EBADF)
     {
       result = lethe::WaitAbandoned;
       break;
     }
     else
-      throw std::bad_syscall("poll", lethe::lastError());
+      throw std::bad_syscall("ppoll", lethe::lastError());
   }
 
   return result;
 }
-
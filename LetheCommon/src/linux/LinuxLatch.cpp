@@ -0,0 +1,119 @@
+#include "linux/LinuxLatch.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+#include "LetheException.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+using namespace lethe;
+
+LinuxLatch::LinuxLatch(uint32_t count) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_count(count),
+  m_waiters(0),
+  m_handle(INVALID_HANDLE_VALUE)
+{
+  // Do nothing
+}
+
+LinuxLatch::~LinuxLatch()
+{
+  if(m_handle.load() != INVALID_HANDLE_VALUE)
+    close(m_handle.load());
+}
+
+void LinuxLatch::countDown(uint32_t count)
+{
+  uint32_t current = m_count.load();
+
+  do
+  {
+    if(count > current)
+      throw std::logic_error("latch counted down past zero");
+  } while(!m_count.compare_exchange_weak(current, current - count));
+
+  if(count == 0 || current != count)
+    return;
+
+  if(m_waiters.load() != 0)
+    futexWake(reinterpret_cast<volatile uint32_t*>(&m_count), UINT32_MAX);
+
+  signalHandle(m_handle.load());
+}
+
+uint32_t LinuxLatch::getCount() const
+{
+  return m_count.load();
+}
+
+WaitResult LinuxLatch::waitUntil(uint64_t endTime)
+{
+  uint32_t count = m_count.load();
+
+  while(count != 0)
+  {
+    bool result;
+
+    ++m_waiters;
+
+    try
+    {
+      result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_count), count, endTime);
+    }
+    catch(...)
+    {
+      --m_waiters;
+      throw;
+    }
+
+    --m_waiters;
+    count = m_count.load();
+
+    if(!result && count != 0)
+      return WaitTimeout;
+  }
+
+  return WaitSuccess;
+}
+
+void LinuxLatch::prepareHandle()
+{
+  int handle = m_handle.load();
+
+  if(handle == INVALID_HANDLE_VALUE)
+  {
+    int newHandle = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if(newHandle == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("eventfd", lastError());
+
+    // Another WaitSet may have beaten us to it
+    if(m_handle.compare_exchange_strong(handle, newHandle))
+    {
+      handle = newHandle;
+
+      // The latch may have reached zero before it could see the handle
+      if(m_count.load() == 0)
+        signalHandle(handle);
+    }
+    else
+      close(newHandle);
+  }
+
+  setHandle(handle);
+}
+
+bool LinuxLatch::finishWait(WaitResult& result GCC_UNUSED)
+{
+  // The handle is never reset
+  return true;
+}
+
+void LinuxLatch::signalHandle(int handle)
+{
+  uint64_t buffer(1);
+
+  if(handle != INVALID_HANDLE_VALUE &&
+     write(handle, &buffer, sizeof(buffer)) != sizeof(buffer))
+    throw std::bad_syscall("eventfd write", lastError());
+}
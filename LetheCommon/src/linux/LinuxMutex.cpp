@@ -3,19 +3,93 @@
 #include "LetheFunctions.h"
 #include "LetheException.h"
 #include "eventfd-lethe.h"
+#include <sys/eventfd.h>
+#include <errno.h>
 #include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <climits>
+
+#ifndef FUTEX_LOCK_PI2
+  #define FUTEX_LOCK_PI2 13
+#endif
 
 using namespace lethe;
 
 const std::string LinuxMutex::s_eventfdDevice("/dev/eventfd-lethe");
 
-LinuxMutex::LinuxMutex(bool locked) :
-  WaitObject(open(s_eventfdDevice.c_str(), O_RDWR))
+// Thread ids are cached for PI mutexes, the cache of the thread calling fork is
+//  cleared in the child, since it gets a new id
+static __thread uint32_t s_threadId = 0;
+static pthread_once_t s_threadIdOnce = PTHREAD_ONCE_INIT;
+static std::atomic<bool> s_lockPi2(true); // Cleared if the kernel is older than FUTEX_LOCK_PI2
+
+static void clearKernelThreadId()
+{
+  s_threadId = 0;
+}
+
+static void registerClearKernelThreadId()
+{
+  pthread_atfork(NULL, NULL, clearKernelThreadId);
+}
+
+static uint32_t getKernelThreadId()
+{
+  if(s_threadId == 0)
+  {
+    pthread_once(&s_threadIdOnce, registerClearKernelThreadId);
+    s_threadId = syscall(SYS_gettid);
+  }
+
+  return s_threadId;
+}
+
+LinuxMutex::LinuxMutex(bool locked, MutexProtocol protocol) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_protocol(protocol),
+  m_stock(protocol == MutexDefault && !useLetheModule(s_eventfdDevice)),
+  m_error(false),
+  m_owner(0),
+  m_lockCount(0),
+  m_piState(0)
 {
+  if(protocol == MutexPriorityInheritance)
+  {
+    if(locked)
+    {
+      m_piState = getKernelThreadId();
+      m_lockCount = 1;
+    }
+
+    return;
+  }
+  else if(protocol != MutexDefault)
+    throw std::invalid_argument("protocol");
+
+  if(m_stock)
+  {
+    // The eventfd count is 1 while the mutex is unlocked
+    setHandle(eventfd(locked ? 0 : 1, EFD_SEMAPHORE | EFD_NONBLOCK | EFD_CLOEXEC));
+
+    if(getHandle() == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("eventfd", lastError());
+
+    if(locked)
+    {
+      m_owner = pthread_self();
+      m_lockCount = 1;
+    }
+
+    return;
+  }
+
+  setHandle(open(s_eventfdDevice.c_str(), O_RDWR));
+
   if(getHandle() == INVALID_HANDLE_VALUE)
     throw std::bad_syscall("eventfd open", lastError());
 
@@ -39,7 +113,13 @@ LinuxMutex::LinuxMutex(bool locked) :
 }
 
 LinuxMutex::LinuxMutex(Handle handle) :
-  WaitObject(handle)
+  WaitObject(handle),
+  m_protocol(MutexDefault),
+  m_stock(false),
+  m_error(false),
+  m_owner(0),
+  m_lockCount(0),
+  m_piState(0)
 {
   if(getHandle() == INVALID_HANDLE_VALUE)
     throw std::invalid_argument("handle");
@@ -67,25 +147,228 @@ LinuxMutex::LinuxMutex(Handle handle) :
 
 LinuxMutex::~LinuxMutex()
 {
-  close(getHandle());
+  if(getHandle() != INVALID_HANDLE_VALUE)
+    close(getHandle());
 }
 
 void LinuxMutex::lock(uint32_t timeout)
 {
-  if(WaitForObject(getHandle(), timeout) != WaitSuccess)
+  if(wait(timeout) != WaitSuccess)
     throw std::runtime_error("failed to wait for mutex");
 }
 
 void LinuxMutex::unlock()
 {
   uint64_t buffer(1);
+
+  if(m_protocol == MutexPriorityInheritance)
+  {
+    unlockPriorityInheritance();
+    return;
+  }
+
+  if(m_stock)
+  {
+    if(m_owner.load() != pthread_self())
+      throw std::bad_syscall("eventfd write", getErrorString(EPERM));
+
+    if(--m_lockCount != 0)
+      return;
+
+    m_owner = 0;
+  }
+
   if(write(getHandle(), &buffer, sizeof(buffer)) != sizeof(buffer))
     throw std::bad_syscall("eventfd write", lastError());
 }
 
 void LinuxMutex::error()
 {
-  if(ioctl(getHandle(), EFD_SET_ERROR, true) != 0)
+  if(m_protocol == MutexPriorityInheritance)
+    throw std::logic_error("priority inheritance mutex has no handle to report errors");
+
+  if(m_stock)
+  {
+    // A stock eventfd can't report an error, wake up the waiters so finishWait can
+    uint64_t buffer(1);
+    m_error = true;
+
+    if(write(getHandle(), &buffer, sizeof(buffer)) != sizeof(buffer))
+      throw std::bad_syscall("eventfd write", lastError());
+  }
+  else if(ioctl(getHandle(), EFD_SET_ERROR, true) != 0)
     throw std::bad_syscall("eventfd ioctl EFD_SET_ERROR", lastError());
 }
 
+WaitResult LinuxMutex::waitUntil(uint64_t endTime)
+{
+  if(m_protocol == MutexPriorityInheritance)
+    return lockPriorityInheritance(endTime);
+
+  // The eventfd of a stock mutex isn't readable while the owner holds it
+  if(m_stock && !m_error && m_owner.load() == pthread_self())
+  {
+    ++m_lockCount;
+    return WaitSuccess;
+  }
+
+  // Only a stock mutex has an owner in user space to spin on
+  WaitResult result;
+  if(m_stock && m_spin.spin(*this, endTime, result))
+    return result;
+
+  return WaitObject::waitUntil(endTime);
+}
+
+LinuxAdaptiveSpin& LinuxMutex::getSpin()
+{
+  return m_spin;
+}
+
+MutexProtocol LinuxMutex::getProtocol() const
+{
+  return m_protocol;
+}
+
+void LinuxMutex::prepareHandle()
+{
+  if(m_protocol == MutexPriorityInheritance)
+    throw std::logic_error("priority inheritance mutex can't be added to a WaitSet");
+}
+
+bool LinuxMutex::finishWait(WaitResult& result)
+{
+  if(!m_stock)
+    return true;
+
+  if(m_error)
+  {
+    result = WaitAbandoned;
+    return true;
+  }
+
+  uint64_t buffer;
+
+  if(read(getHandle(), &buffer, sizeof(buffer)) != sizeof(buffer))
+    return false;
+
+  m_owner = pthread_self();
+  m_lockCount = 1;
+  return true;
+}
+
+WaitResult LinuxMutex::lockPriorityInheritance(uint64_t endTime)
+{
+  uint32_t threadId = getKernelThreadId();
+  uint32_t state = m_piState.load();
+
+  if((state & FUTEX_TID_MASK) == threadId)
+  {
+    ++m_lockCount;
+    return WaitSuccess;
+  }
+
+  // An unlocked mutex is taken by storing our id, without the kernel
+  state = 0;
+
+  if(!m_piState.compare_exchange_strong(state, threadId))
+  {
+    if(endTime != INFINITE_END_TIME && getTimeoutNs(endTime) == 0)
+      return WaitTimeout;
+
+    // The kernel sets FUTEX_WAITERS, boosts the owner and hands us the mutex
+    while(true)
+    {
+      timespec endTimespec;
+      timespec* endTimePtr = NULL;
+      long result;
+
+      if(s_lockPi2)
+      {
+        // FUTEX_LOCK_PI2 takes an absolute CLOCK_MONOTONIC time
+        if(endTime != INFINITE_END_TIME)
+        {
+          getEndTimespec(endTime, endTimespec);
+          endTimePtr = &endTimespec;
+        }
+
+        result = syscall(SYS_futex, &m_piState, FUTEX_LOCK_PI2 | FUTEX_PRIVATE_FLAG, 0, endTimePtr, NULL, 0);
+
+        if(result != 0 && errno == ENOSYS)
+        {
+          s_lockPi2 = false;
+          continue;
+        }
+      }
+      else
+      {
+        // FUTEX_LOCK_PI only takes an absolute CLOCK_REALTIME time
+        if(endTime != INFINITE_END_TIME)
+        {
+          clock_gettime(CLOCK_REALTIME, &endTimespec);
+          getEndTimespec(endTimespec.tv_sec * 1000000000ull + endTimespec.tv_nsec + getTimeoutNs(endTime), endTimespec);
+          endTimePtr = &endTimespec;
+        }
+
+        result = syscall(SYS_futex, &m_piState, FUTEX_LOCK_PI_PRIVATE, 0, endTimePtr, NULL, 0);
+      }
+
+      if(result == 0)
+        break;
+      else if(errno == ETIMEDOUT)
+        return WaitTimeout;
+      else if(errno != EAGAIN && errno != EINTR) // EAGAIN while the owner is exiting
+        throw std::bad_syscall("futex lock pi", lastError());
+    }
+  }
+
+  m_lockCount = 1;
+  return WaitSuccess;
+}
+
+void LinuxMutex::unlockPriorityInheritance()
+{
+  uint32_t threadId = getKernelThreadId();
+
+  if((m_piState.load() & FUTEX_TID_MASK) != threadId)
+    throw std::bad_syscall("futex unlock pi", getErrorString(EPERM));
+
+  if(--m_lockCount != 0)
+    return;
+
+  // With FUTEX_WAITERS set, the kernel hands the mutex to the highest priority waiter
+  uint32_t state = threadId;
+
+  if(!m_piState.compare_exchange_strong(state, 0) &&
+     syscall(SYS_futex, &m_piState, FUTEX_UNLOCK_PI_PRIVATE, 0, NULL, NULL, 0) != 0)
+    throw std::bad_syscall("futex unlock pi", lastError());
+}
+
+bool LinuxMutex::isLockedRecursively()
+{
+  // The lock count of a module mutex is kept in the kernel, where it can't be read
+  if(m_protocol == MutexPriorityInheritance)
+    return ((m_piState.load() & FUTEX_TID_MASK) == getKernelThreadId() && m_lockCount > 1);
+
+  return (m_stock && m_owner.load() == pthread_self() && m_lockCount > 1);
+}
+
+bool LinuxMutex::canUndoWait() const
+{
+  return true;
+}
+
+void LinuxMutex::undoWait()
+{
+  unlock();
+}
+
+bool LinuxMutex::tryAcquire(WaitResult& result)
+{
+  // While the owner is set, the lock is taken and the eventfd needn't be read
+  if(!m_stock || (!m_error && m_owner.load() != 0))
+    return false;
+
+  result = WaitSuccess;
+  return finishWait(result);
+}
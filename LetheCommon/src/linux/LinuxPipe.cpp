@@ -4,30 +4,46 @@
 #include "LetheException.h"
 #include "LetheInternal.h"
 #include <sstream>
-#include <queue>
+#include <algorithm>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
 #include <errno.h>
-#include <aio.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
 
 using namespace lethe;
 
 const std::string LinuxPipe::s_fifoPath("/tmp/lethe/");
 const std::string LinuxPipe::s_fifoBaseName("lethe-fifo-");
 LinuxAtomic LinuxPipe::s_uniqueId(0);
+const uint32_t LinuxPipe::s_defaultSendCapacity(1024 * 1024);
+const uint32_t LinuxPipe::s_adaptiveWindow(16);
+const uint32_t LinuxPipe::s_adaptiveThreshold(4);
 
 LinuxPipe::LinuxPipe() :
   ByteStream(INVALID_HANDLE_VALUE),
   m_pipeRead(INVALID_HANDLE_VALUE),
   m_pipeWrite(INVALID_HANDLE_VALUE),
   m_inCreated(false),
-  m_outCreated(false)
+  m_outCreated(false),
+  m_sendOffset(0),
+  m_sendSize(0),
+  m_sendCapacity(s_defaultSendCapacity),
+  m_queuedSize(0),
+  m_acceptedTotal(0),
+  m_writtenTotal(0),
+  m_maxCapacity(0),
+  m_adaptiveSends(0),
+  m_adaptiveQueued(0),
+  m_flushObject(*this)
 {
-  setupAsync();
-
   // No name provided, auto-generate one
   std::stringstream str;
   str << s_fifoPath << s_fifoBaseName << getProcessId() << "-" << s_uniqueId.increment();
@@ -72,10 +88,18 @@ LinuxPipe::LinuxPipe(const std::string& pipeIn, bool createIn, const std::string
   m_fifoReadName(pipeIn.empty() ? "" : s_fifoPath + s_fifoBaseName + pipeIn),
   m_fifoWriteName(pipeOut.empty() ? "" : s_fifoPath + s_fifoBaseName + pipeOut),
   m_inCreated(false),
-  m_outCreated(false)
+  m_outCreated(false),
+  m_sendOffset(0),
+  m_sendSize(0),
+  m_sendCapacity(s_defaultSendCapacity),
+  m_queuedSize(0),
+  m_acceptedTotal(0),
+  m_writtenTotal(0),
+  m_maxCapacity(0),
+  m_adaptiveSends(0),
+  m_adaptiveQueued(0),
+  m_flushObject(*this)
 {
-  setupAsync();
-
   try
   {
     // Make sure the fifo path exists
@@ -138,10 +162,18 @@ LinuxPipe::LinuxPipe(Handle pipeRead, Handle pipeWrite) :
   m_pipeRead(pipeRead),
   m_pipeWrite(pipeWrite),
   m_inCreated(false),
-  m_outCreated(false)
+  m_outCreated(false),
+  m_sendOffset(0),
+  m_sendSize(0),
+  m_sendCapacity(s_defaultSendCapacity),
+  m_queuedSize(0),
+  m_acceptedTotal(0),
+  m_writtenTotal(0),
+  m_maxCapacity(0),
+  m_adaptiveSends(0),
+  m_adaptiveQueued(0),
+  m_flushObject(*this)
 {
-  setupAsync();
-
   try
   {
     if(fcntl(m_pipeRead, F_SETFL, O_NONBLOCK) != 0 ||
@@ -163,28 +195,11 @@ LinuxPipe::LinuxPipe(Handle pipeRead, Handle pipeWrite) :
   setHandle(m_pipeRead);
 }
 
-void LinuxPipe::setupAsync()
-{
-  if(pthread_attr_init(&m_async.attr) != 0)
-    throw std::bad_syscall("pthread_attr_init", lastError());
-
-  if(pthread_attr_setdetachstate(&m_async.attr, PTHREAD_CREATE_DETACHED) != 0)
-  {
-    pthread_attr_destroy(&m_async.attr);
-    throw std::bad_syscall("pthread_attr_setdetachstate", lastError());
-  }
-
-  m_async.buffer = NULL;
-  m_async.result = 0;
-}
-
 LinuxPipe::~LinuxPipe()
 {
-  // Destroy any asynchronous events and delete buffers
-  if(m_async.buffer != NULL)
+  // Give the reader a moment to take anything still queued
+  if(m_queuedSize != 0)
   {
-    m_async.result = EINTR;
-
     try
     {
       flush(30);
@@ -193,8 +208,6 @@ LinuxPipe::~LinuxPipe()
     {
       // Do nothing
     }
-
-    delete [] reinterpret_cast<volatile uint8_t*>(m_async.buffer);
   }
 
   cleanup();
@@ -202,32 +215,22 @@ LinuxPipe::~LinuxPipe()
 
 bool LinuxPipe::flush(uint32_t timeout)
 {
-  if(m_async.buffer != NULL)
-  {
-    uint64_t endTime = getEndTime(timeout);
-
-    // Polling sucks, but can't get kernel eventfd-aio or libc aio to work with a full pipe
-    do
-    {
-      timeout = getTimeout(endTime);
-
-      if(timeout == 0)
-        return false;
+  return flushUntil(getEndTime(timeout));
+}
 
-      sleep_ms((20 < timeout) ? 20 : timeout);
-    } while(m_async.buffer != NULL);
+bool LinuxPipe::flushUntil(uint64_t endTime)
+{
+  while(!writeQueued())
+  {
+    if(!waitWritable(endTime))
+      return false;
   }
 
-  if(m_async.result != 0)
-    throw std::bad_syscall("write", getErrorString(m_async.result));
-
   return true;
 }
 
 void LinuxPipe::cleanup()
 {
-  pthread_attr_destroy(&m_async.attr);
-
   if(m_pipeRead != INVALID_HANDLE_VALUE)
     close(m_pipeRead);
 
@@ -241,6 +244,53 @@ void LinuxPipe::cleanup()
     unlink(m_fifoWriteName.c_str());
 }
 
+void LinuxPipe::setSendCapacity(uint32_t capacity)
+{
+  m_sendCapacity = capacity;
+}
+
+uint64_t LinuxPipe::getQueuedSize() const
+{
+  return m_queuedSize;
+}
+
+uint32_t LinuxPipe::setCapacity(uint32_t capacity)
+{
+  int result = fcntl(m_pipeWrite, F_SETPIPE_SZ, capacity);
+
+  if(result < 0)
+    throw std::bad_syscall("fcntl", lastError());
+
+  return result;
+}
+
+uint32_t LinuxPipe::getCapacity() const
+{
+  int result = fcntl(m_pipeWrite, F_GETPIPE_SZ);
+
+  if(result < 0)
+    throw std::bad_syscall("fcntl", lastError());
+
+  return result;
+}
+
+void LinuxPipe::setAdaptiveCapacity(uint32_t maxCapacity)
+{
+  m_maxCapacity = maxCapacity;
+  m_adaptiveSends = 0;
+  m_adaptiveQueued = 0;
+}
+
+WaitObject& LinuxPipe::getFlushObject()
+{
+  return m_flushObject;
+}
+
+Handle LinuxPipe::getWriteHandle() const
+{
+  return m_pipeWrite;
+}
+
 const std::string& LinuxPipe::getNameIn() const
 {
   return m_fifoReadName;
@@ -253,16 +303,37 @@ const std::string& LinuxPipe::getNameOut() const
 
 void LinuxPipe::send(const void* buffer, uint32_t bufferSize)
 {
-  // Check if a previous async write has failed
-  if(m_async.result != 0)
-    throw std::bad_syscall("write", getErrorString(m_async.result));
+  iovec vector = { const_cast<void*>(buffer), bufferSize };
+  sendv(&vector, 1);
+}
+
+uint32_t LinuxPipe::receive(void* buffer, uint32_t bufferSize)
+{
+  iovec vector = { buffer, bufferSize };
+  return receivev(&vector, 1);
+}
+
+void LinuxPipe::sendv(const iovec* vectors, uint32_t count)
+{
+  size_t size = 0;
 
-  // If there is currently a running async write, don't allow a new write
-  if(m_async.buffer != NULL)
-    throw std::bad_alloc();
+  for(uint32_t i = 0; i < count; ++i)
+    size += vectors[i].iov_len;
 
-  // Write as much as we can to the pipe, enqueue the rest asynchronously
-  int bytesWritten = write(m_pipeWrite, buffer, bufferSize);
+  // Queued data must go out first, if it can't, the whole send joins the queue
+  if(m_queuedSize != 0 && !writeQueued())
+  {
+    if(m_sendSize != 0 && size > m_sendCapacity - std::min(m_sendSize, m_sendCapacity))
+      throw std::bad_alloc();
+
+    queue(vectors, count, 0);
+    m_acceptedTotal += size;
+    adaptCapacity(true);
+    return;
+  }
+
+  // Write as much as we can to the pipe, queue the rest
+  ssize_t bytesWritten = writev(m_pipeWrite, vectors, std::min<uint32_t>(count, IOV_MAX));
 
   if(bytesWritten < 0)
   {
@@ -272,13 +343,97 @@ void LinuxPipe::send(const void* buffer, uint32_t bufferSize)
       throw std::bad_syscall("write to pipe", lastError());
   }
 
-  if(static_cast<uint32_t>(bytesWritten) < bufferSize)
-    startAsync(((uint8_t*)buffer) + bytesWritten, bufferSize - bytesWritten);
+  m_writtenTotal += bytesWritten;
+
+  if(static_cast<size_t>(bytesWritten) < size)
+    queue(vectors, count, bytesWritten);
+
+  m_acceptedTotal += size;
+  adaptCapacity(static_cast<size_t>(bytesWritten) < size);
 }
 
-uint32_t LinuxPipe::receive(void* buffer, uint32_t bufferSize)
+uint64_t LinuxPipe::sendZeroCopy(const void* buffer, uint32_t bufferSize)
+{
+  const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer);
+  uint32_t bytesWritten = 0;
+
+  // Queued data must go out first, if it can't, the buffer is queued as it is
+  if(m_queuedSize == 0 || writeQueued())
+  {
+    while(bytesWritten < bufferSize)
+    {
+      iovec vector = { const_cast<uint8_t*>(data + bytesWritten), bufferSize - bytesWritten };
+      ssize_t result = vmsplice(m_pipeWrite, &vector, 1, SPLICE_F_NONBLOCK);
+
+      if(result < 0)
+      {
+        if(errno == EAGAIN)
+          break;
+        else if(errno != EINTR)
+          throw std::bad_syscall("vmsplice to pipe", lastError());
+      }
+      else
+      {
+        bytesWritten += result;
+        m_writtenTotal += result;
+      }
+    }
+  }
+
+  // The caller keeps the buffer until it is released, so the rest doesn't need copying
+  if(bytesWritten < bufferSize)
+  {
+    SendSegment segment = { data + bytesWritten, bufferSize - bytesWritten };
+    queueSegment(segment);
+  }
+
+  m_acceptedTotal += bufferSize;
+  adaptCapacity(bytesWritten < bufferSize);
+  return m_acceptedTotal;
+}
+
+bool LinuxPipe::isReleased(uint64_t position)
 {
-  ssize_t bytesRead(read(m_pipeRead, buffer, bufferSize));
+  if(position > m_writtenTotal)
+    return false;
+
+  // Everything written to the pipe but still unread may be in a spliced buffer
+  int unread;
+
+  if(ioctl(m_pipeWrite, FIONREAD, &unread) != 0)
+    throw std::bad_syscall("ioctl", lastError());
+
+  return position <= m_writtenTotal - unread;
+}
+
+uint32_t LinuxPipe::spliceTo(Handle handle, uint32_t size)
+{
+  struct stat handleStat;
+
+  if(fstat(handle, &handleStat) != 0)
+    throw std::bad_syscall("fstat", lastError());
+
+  // A socket or pipe would keep referring to the spliced pages after they leave
+  //  this pipe, so a zero-copy sender would be told its buffer is released too early
+  if(S_ISSOCK(handleStat.st_mode) || S_ISFIFO(handleStat.st_mode))
+    throw std::invalid_argument("spliceTo can't move data into a socket or pipe");
+
+  ssize_t bytesMoved = splice(m_pipeRead, NULL, handle, NULL, size, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+  if(bytesMoved < 0)
+  {
+    if(errno != EAGAIN)
+      throw std::bad_syscall("splice from pipe", lastError());
+    else
+      bytesMoved = 0;
+  }
+
+  return bytesMoved;
+}
+
+uint32_t LinuxPipe::receivev(const iovec* vectors, uint32_t count)
+{
+  ssize_t bytesRead(readv(m_pipeRead, vectors, std::min<uint32_t>(count, IOV_MAX)));
 
   if(bytesRead < 0)
   {
@@ -291,42 +446,282 @@ uint32_t LinuxPipe::receive(void* buffer, uint32_t bufferSize)
   return bytesRead;
 }
 
-void LinuxPipe::startAsync(uint8_t* buffer, uint32_t size)
+void LinuxPipe::queue(const iovec* vectors, uint32_t count, size_t skip)
 {
-  m_async.buffer = new uint8_t[size];
-  m_async.size = size;
-  m_async.offset = 0;
+  size_t size = 0;
+
+  for(uint32_t i = 0; i < count; ++i)
+    size += vectors[i].iov_len;
 
-  memcpy(m_async.buffer, buffer, size);
+  size -= skip;
+
+  if(size == 0)
+    return;
+
+  if(m_sendSize + size > m_sendRing.size())
+  {
+    // Grow the ring, moving the queued data to the start
+    std::vector<uint8_t> ring(std::max<size_t>(m_sendSize + size, std::min<size_t>(m_sendRing.size() * 2, m_sendCapacity)));
+    uint32_t first = std::min<size_t>(m_sendSize, m_sendRing.size() - m_sendOffset);
 
-  if(pthread_create(&m_async.thread, &m_async.attr, &asyncThreadHook, this) != 0)
-    throw std::bad_syscall("pthread_create", lastError());
+    if(m_sendSize != 0)
+    {
+      memcpy(&ring[0], &m_sendRing[m_sendOffset], first);
+      memcpy(&ring[first], &m_sendRing[0], m_sendSize - first);
+    }
+
+    m_sendRing.swap(ring);
+    m_sendOffset = 0;
+  }
+
+  // Copy whatever wasn't written, skipping the part that was
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    const uint8_t* buffer = reinterpret_cast<const uint8_t*>(vectors[i].iov_base);
+    size_t length = vectors[i].iov_len;
+
+    if(skip >= length)
+    {
+      skip -= length;
+      continue;
+    }
+
+    buffer += skip;
+    length -= skip;
+    skip = 0;
+
+    uint32_t end = (m_sendOffset + m_sendSize) % m_sendRing.size();
+    uint32_t first = std::min<size_t>(length, m_sendRing.size() - end);
+
+    memcpy(&m_sendRing[end], buffer, first);
+    memcpy(&m_sendRing[0], buffer + first, length - first);
+    m_sendSize += length;
+  }
+
+  SendSegment segment = { NULL, static_cast<uint32_t>(size) };
+  queueSegment(segment);
 }
 
-void* LinuxPipe::asyncThreadHook(void* param)
+void LinuxPipe::queueSegment(const SendSegment& segment)
 {
-  LinuxPipe* pipe = reinterpret_cast<LinuxPipe*>(param);
-  pipe->asyncThreadInternal();
-  return NULL;
+  if(m_queuedSize == 0)
+    m_flushObject.setDrained(false);
+
+  // Data copied into the ring right after other copied data joins its segment
+  if(segment.buffer == NULL && !m_sendQueue.empty() && m_sendQueue.back().buffer == NULL)
+    m_sendQueue.back().size += segment.size;
+  else
+    m_sendQueue.push_back(segment);
+
+  m_queuedSize += segment.size;
 }
 
-void LinuxPipe::asyncThreadInternal()
+bool LinuxPipe::writeQueued()
 {
-  while(m_async.result == 0)
+  if(m_sendQueue.empty())
+    return true;
+
+  while(!m_sendQueue.empty())
   {
-    int bytesWritten = write(m_pipeWrite, &m_async.buffer[m_async.offset], m_async.size);
+    SendSegment& segment = m_sendQueue.front();
+    ssize_t bytesWritten;
+
+    if(segment.buffer == NULL)
+    {
+      // Data copied into the ring may wrap around its end
+      uint32_t first = std::min<size_t>(segment.size, m_sendRing.size() - m_sendOffset);
+      iovec parts[2] = { { &m_sendRing[m_sendOffset], first },
+                         { &m_sendRing[0], segment.size - first } };
+
+      bytesWritten = writev(m_pipeWrite, parts, (first < segment.size) ? 2 : 1);
+    }
+    else
+    {
+      iovec vector = { const_cast<uint8_t*>(segment.buffer), segment.size };
+      bytesWritten = vmsplice(m_pipeWrite, &vector, 1, SPLICE_F_NONBLOCK);
+    }
+
+    if(bytesWritten < 0)
+    {
+      if(errno == EAGAIN)
+        return false;
+      else if(errno != EINTR)
+        throw std::bad_syscall("write to pipe", lastError());
+
+      continue;
+    }
 
-    if(bytesWritten > 0)
+    if(segment.buffer == NULL)
     {
-      m_async.offset += bytesWritten;
-      m_async.size -= bytesWritten;
+      m_sendOffset = (m_sendOffset + bytesWritten) % m_sendRing.size();
+      m_sendSize -= bytesWritten;
     }
-    else if(bytesWritten == 0 || errno == EAGAIN)
-      sleep_ms(20);
     else
-      m_async.result = errno;
+      segment.buffer += bytesWritten;
+
+    segment.size -= bytesWritten;
+    m_queuedSize -= bytesWritten;
+    m_writtenTotal += bytesWritten;
+
+    if(segment.size == 0)
+      m_sendQueue.pop_front();
   }
 
-  delete [] m_async.buffer;
-  m_async.buffer = NULL;
+  m_sendOffset = 0;
+  m_flushObject.setDrained(true);
+
+  // Don't hold on to a ring that grew past the capacity for one large send
+  if(m_sendRing.size() > m_sendCapacity)
+    std::vector<uint8_t>().swap(m_sendRing);
+
+  return true;
+}
+
+void LinuxPipe::adaptCapacity(bool queued)
+{
+  if(m_maxCapacity == 0)
+    return;
+
+  ++m_adaptiveSends;
+
+  if(queued)
+    ++m_adaptiveQueued;
+
+  if(m_adaptiveQueued >= s_adaptiveThreshold)
+  {
+    uint32_t capacity = getCapacity();
+
+    if(capacity < m_maxCapacity)
+    {
+      // The kernel may refuse to go past pipe-max-size, stop growing if it does
+      if(fcntl(m_pipeWrite, F_SETPIPE_SZ, std::min(capacity * 2, m_maxCapacity)) < 0)
+      {
+        if(errno != EPERM && errno != ENOMEM)
+          throw std::bad_syscall("fcntl", lastError());
+
+        m_maxCapacity = capacity;
+      }
+    }
+  }
+  else if(m_adaptiveSends < s_adaptiveWindow)
+    return;
+
+  m_adaptiveSends = 0;
+  m_adaptiveQueued = 0;
+}
+
+bool LinuxPipe::waitWritable(uint64_t endTime)
+{
+  struct pollfd pollData = { m_pipeWrite, POLLOUT, 0 };
+  struct timespec timeout;
+  int result;
+
+  do
+  {
+    result = ppoll(&pollData, 1, getTimeoutTimespec(endTime, timeout), NULL);
+  } while(result < 0 && errno == EINTR);
+
+  if(result < 0)
+    throw std::bad_syscall("ppoll", lastError());
+
+  // An error on the pipe is reported by the next write
+  return result != 0;
+}
+
+LinuxPipe::FlushObject::FlushObject(LinuxPipe& pipe) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_pipe(pipe),
+  m_drainedHandle(INVALID_HANDLE_VALUE)
+{
+  // Do nothing
+}
+
+LinuxPipe::FlushObject::~FlushObject()
+{
+  if(getHandle() != INVALID_HANDLE_VALUE)
+    close(getHandle());
+
+  if(m_drainedHandle != INVALID_HANDLE_VALUE)
+    close(m_drainedHandle);
+}
+
+void LinuxPipe::FlushObject::setDrained(bool drained)
+{
+  // Nothing to do until the object is added to a WaitSet
+  if(m_drainedHandle == INVALID_HANDLE_VALUE)
+    return;
+
+  uint64_t buffer(1);
+  ssize_t result = drained ? write(m_drainedHandle, &buffer, sizeof(buffer)) :
+                             read(m_drainedHandle, &buffer, sizeof(buffer));
+
+  if(result != sizeof(buffer) && errno != EAGAIN)
+    throw std::bad_syscall(drained ? "eventfd write" : "eventfd read", lastError());
+}
+
+WaitResult LinuxPipe::FlushObject::waitUntil(uint64_t endTime)
+{
+  try
+  {
+    return m_pipe.flushUntil(endTime) ? WaitSuccess : WaitTimeout;
+  }
+  catch(std::bad_syscall&)
+  {
+    return WaitAbandoned;
+  }
+}
+
+void LinuxPipe::FlushObject::prepareHandle()
+{
+  if(getHandle() != INVALID_HANDLE_VALUE)
+    return;
+
+  // The handle is an epoll set, readable while the pipe can take more data (so
+  //  queued data can be written) or nothing is queued
+  Handle epollHandle = epoll_create1(EPOLL_CLOEXEC);
+
+  if(epollHandle == INVALID_HANDLE_VALUE)
+    throw std::bad_syscall("epoll_create1", lastError());
+
+  Handle drainedHandle = eventfd((m_pipe.m_queuedSize == 0) ? 1 : 0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  if(drainedHandle == INVALID_HANDLE_VALUE)
+  {
+    close(epollHandle);
+    throw std::bad_syscall("eventfd", lastError());
+  }
+
+  struct epoll_event writable;
+  struct epoll_event drained;
+
+  writable.events = EPOLLOUT;
+  writable.data.fd = m_pipe.m_pipeWrite;
+  drained.events = EPOLLIN;
+  drained.data.fd = drainedHandle;
+
+  if(epoll_ctl(epollHandle, EPOLL_CTL_ADD, m_pipe.m_pipeWrite, &writable) != 0 ||
+     epoll_ctl(epollHandle, EPOLL_CTL_ADD, drainedHandle, &drained) != 0)
+  {
+    std::string error(lastError());
+    close(drainedHandle);
+    close(epollHandle);
+    throw std::bad_syscall("epoll_ctl", error);
+  }
+
+  m_drainedHandle = drainedHandle;
+  setHandle(epollHandle);
+}
+
+bool LinuxPipe::FlushObject::finishWait(WaitResult& result)
+{
+  // Push queued data through, the wakeup only counts once it's all written
+  try
+  {
+    return m_pipe.writeQueued();
+  }
+  catch(std::bad_syscall&)
+  {
+    result = WaitAbandoned;
+    return true;
+  }
 }
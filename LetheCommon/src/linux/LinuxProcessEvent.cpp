@@ -0,0 +1,80 @@
+#include "linux/LinuxProcessEvent.h"
+#include "LetheInternal.h"
+#include "LetheException.h"
+
+using namespace lethe;
+
+LinuxProcessEvent::LinuxProcessEvent(bool initialState, bool autoReset) :
+  m_autoReset(autoReset),
+  m_state(initialState ? 1 : 0),
+  m_waiters(0)
+{
+  // Do nothing
+}
+
+LinuxProcessEvent::~LinuxProcessEvent()
+{
+  // Do nothing
+}
+
+void LinuxProcessEvent::set()
+{
+  if(m_state.exchange(1) == 1)
+    return;
+
+  // An auto-reset event only lets one waiter through
+  if(m_waiters.load() != 0)
+    futexWake(reinterpret_cast<volatile uint32_t*>(&m_state), m_autoReset ? 1 : UINT32_MAX, true);
+}
+
+void LinuxProcessEvent::reset()
+{
+  m_state.store(0);
+}
+
+WaitResult LinuxProcessEvent::wait(uint32_t timeout)
+{
+  return waitUntil(getEndTime(timeout));
+}
+
+WaitResult LinuxProcessEvent::wait(std::chrono::nanoseconds timeout)
+{
+  return waitUntil(getEndTime(timeout));
+}
+
+WaitResult LinuxProcessEvent::waitUntil(uint64_t endTime)
+{
+  uint32_t state = m_state.load();
+
+  while(true)
+  {
+    if(state == 1)
+    {
+      if(!m_autoReset || m_state.compare_exchange_weak(state, 0))
+        return WaitSuccess;
+
+      continue;
+    }
+
+    bool result;
+
+    // The waiter count must be visible before the futex checks the state
+    ++m_waiters;
+
+    try
+    {
+      result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_state), state, endTime, true);
+    }
+    catch(...)
+    {
+      --m_waiters;
+      throw;
+    }
+
+    --m_waiters;
+    state = m_state.load();
+
+    if(!result && state == 0)
+      return WaitTimeout;
+  }
+}
@@ -0,0 +1,104 @@
+#include "linux/LinuxProcessMutex.h"
+#include "LetheInternal.h"
+#include "LetheException.h"
+#include <errno.h>
+#include <time.h>
+
+using namespace lethe;
+
+LinuxProcessMutex::LinuxProcessMutex(bool locked)
+{
+  pthread_mutexattr_t attributes;
+  int result = pthread_mutexattr_init(&attributes);
+
+  if(result != 0)
+    throw std::bad_syscall("pthread_mutexattr_init", getErrorString(result));
+
+  if((result = pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED)) != 0 ||
+     (result = pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST)) != 0 ||
+     (result = pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE)) != 0 ||
+     (result = pthread_mutex_init(&m_mutex, &attributes)) != 0)
+  {
+    pthread_mutexattr_destroy(&attributes);
+    throw std::bad_syscall("pthread_mutex_init", getErrorString(result));
+  }
+
+  pthread_mutexattr_destroy(&attributes);
+
+  if(locked && (result = pthread_mutex_lock(&m_mutex)) != 0)
+  {
+    pthread_mutex_destroy(&m_mutex);
+    throw std::bad_syscall("pthread_mutex_lock", getErrorString(result));
+  }
+}
+
+LinuxProcessMutex::~LinuxProcessMutex()
+{
+  pthread_mutex_destroy(&m_mutex);
+}
+
+WaitResult LinuxProcessMutex::lock(uint32_t timeout)
+{
+  return lockUntil(getEndTime(timeout));
+}
+
+WaitResult LinuxProcessMutex::lock(std::chrono::nanoseconds timeout)
+{
+  return lockUntil(getEndTime(timeout));
+}
+
+void LinuxProcessMutex::unlock()
+{
+  int result = pthread_mutex_unlock(&m_mutex);
+
+  if(result != 0)
+    throw std::bad_syscall("mutex unlock", getErrorString(result));
+}
+
+WaitResult LinuxProcessMutex::lockUntil(uint64_t endTime)
+{
+  int result;
+
+  if(endTime == INFINITE_END_TIME)
+    result = pthread_mutex_lock(&m_mutex);
+  else
+  {
+    result = pthread_mutex_trylock(&m_mutex);
+
+    if(result == EBUSY && getTimeoutNs(endTime) != 0)
+    {
+      timespec endTimespec;
+
+#if defined(__GLIBC_PREREQ) && __GLIBC_PREREQ(2, 30)
+      getEndTimespec(endTime, endTimespec);
+      result = pthread_mutex_clocklock(&m_mutex, CLOCK_MONOTONIC, &endTimespec);
+#else
+      uint64_t realEndTime;
+      clock_gettime(CLOCK_REALTIME, &endTimespec);
+      realEndTime = endTimespec.tv_sec * 1000000000ull + endTimespec.tv_nsec + getTimeoutNs(endTime);
+      getEndTimespec(realEndTime, endTimespec);
+      result = pthread_mutex_timedlock(&m_mutex, &endTimespec);
+#endif
+    }
+  }
+
+  switch(result)
+  {
+  case 0:
+    return WaitSuccess;
+
+  case EBUSY:
+  case ETIMEDOUT:
+    return WaitTimeout;
+
+  case EOWNERDEAD:
+    // The caller owns the mutex now, let the next owner take it normally
+    if((result = pthread_mutex_consistent(&m_mutex)) != 0)
+      throw std::bad_syscall("pthread_mutex_consistent", getErrorString(result));
+
+    return WaitAbandoned;
+
+  default:
+    throw std::bad_syscall("pthread_mutex_lock", getErrorString(result));
+  }
+}
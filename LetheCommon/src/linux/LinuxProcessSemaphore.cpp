@@ -0,0 +1,84 @@
+#include "linux/LinuxProcessSemaphore.h"
+#include "LetheInternal.h"
+#include "LetheException.h"
+#include <errno.h>
+
+using namespace lethe;
+
+LinuxProcessSemaphore::LinuxProcessSemaphore(uint32_t maxCount, uint32_t initialCount) :
+  m_maxCount(maxCount),
+  m_count(initialCount),
+  m_waiters(0)
+{
+  if(maxCount == 0)
+    throw std::invalid_argument("maxCount");
+
+  if(initialCount > maxCount)
+    throw std::invalid_argument("initialCount");
+}
+
+LinuxProcessSemaphore::~LinuxProcessSemaphore()
+{
+  // Do nothing
+}
+
+WaitResult LinuxProcessSemaphore::lock(uint32_t timeout)
+{
+  return lockUntil(getEndTime(timeout));
+}
+
+WaitResult LinuxProcessSemaphore::lock(std::chrono::nanoseconds timeout)
+{
+  return lockUntil(getEndTime(timeout));
+}
+
+void LinuxProcessSemaphore::unlock(uint32_t count)
+{
+  uint32_t current = m_count.load();
+
+  do
+  {
+    if(count > m_maxCount - current)
+      throw std::bad_syscall("semaphore unlock", getErrorString(EINVAL));
+  } while(!m_count.compare_exchange_weak(current, current + count));
+
+  if(m_waiters.load() != 0)
+    futexWake(reinterpret_cast<volatile uint32_t*>(&m_count), count, true);
+}
+
+WaitResult LinuxProcessSemaphore::lockUntil(uint64_t endTime)
+{
+  uint32_t count = m_count.load();
+
+  while(true)
+  {
+    if(count != 0)
+    {
+      if(m_count.compare_exchange_weak(count, count - 1))
+        return WaitSuccess;
+
+      continue;
+    }
+
+    bool result;
+
+    // The waiter count must be visible before the futex checks the count
+    ++m_waiters;
+
+    try
+    {
+      result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_count), count, endTime, true);
+    }
+    catch(...)
+    {
+      --m_waiters;
+      throw;
+    }
+
+    --m_waiters;
+    count = m_count.load();
+
+    if(!result && count == 0)
+      return WaitTimeout;
+  }
+}
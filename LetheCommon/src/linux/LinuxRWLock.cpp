@@ -0,0 +1,359 @@
+#include "linux/LinuxRWLock.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+#include "LetheException.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+using namespace lethe;
+
+const uint32_t LinuxRWLock::s_writerBit(0x80000000);
+const uint32_t LinuxRWLock::s_readerMask(0x7FFFFFFF);
+
+LinuxRWLock::LinuxRWLock(RWLockPolicy policy) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_policy(policy),
+  m_state(0),
+  m_sequence(0),
+  m_waiters(0),
+  m_writersWaiting(0),
+  m_readersWaiting(0),
+  m_readerPasses(0),
+  m_owner(0),
+  m_exclusiveHandle(INVALID_HANDLE_VALUE),
+  m_sharedHandle(INVALID_HANDLE_VALUE),
+  m_sharedObject(*this)
+{
+  // Do nothing
+}
+
+LinuxRWLock::~LinuxRWLock()
+{
+  if(m_exclusiveHandle.load() != INVALID_HANDLE_VALUE)
+    close(m_exclusiveHandle.load());
+
+  if(m_sharedHandle.load() != INVALID_HANDLE_VALUE)
+    close(m_sharedHandle.load());
+}
+
+void LinuxRWLock::lock(uint32_t timeout)
+{
+  if(wait(timeout) != WaitSuccess)
+    throw std::runtime_error("failed to wait for rwlock");
+}
+
+void LinuxRWLock::unlock()
+{
+  if(m_owner.load() != pthread_self())
+    throw std::bad_syscall("rwlock unlock", getErrorString(EPERM));
+
+  m_owner.store(0);
+
+  // Let the readers that were blocked by this writer in before the next writer
+  if(m_policy == RWLockFair)
+    m_readerPasses.store(m_readersWaiting.load());
+
+  m_state.store(0);
+  wake();
+}
+
+void LinuxRWLock::lockShared(uint32_t timeout)
+{
+  if(m_sharedObject.wait(timeout) != WaitSuccess)
+    throw std::runtime_error("failed to wait for rwlock");
+}
+
+void LinuxRWLock::unlockShared()
+{
+  uint32_t state = m_state.load();
+
+  do
+  {
+    if(state == 0 || (state & s_writerBit))
+      throw std::bad_syscall("rwlock unlock", getErrorString(EPERM));
+  } while(!m_state.compare_exchange_weak(state, state - 1));
+
+  // Only the last reader out can let anyone else in
+  if(state == 1)
+    wake();
+}
+
+WaitObject& LinuxRWLock::getSharedObject()
+{
+  return m_sharedObject;
+}
+
+RWLockPolicy LinuxRWLock::getPolicy() const
+{
+  return m_policy;
+}
+
+LinuxAdaptiveSpin& LinuxRWLock::getSpin()
+{
+  return m_spin;
+}
+
+WaitResult LinuxRWLock::waitUntil(uint64_t endTime)
+{
+  return waitLock(endTime, false);
+}
+
+void LinuxRWLock::prepareHandle()
+{
+  setHandle(createNotifyHandle(m_exclusiveHandle));
+}
+
+bool LinuxRWLock::finishWait(WaitResult& result GCC_UNUSED)
+{
+  consumeNotify(getHandle());
+  return tryLock();
+}
+
+bool LinuxRWLock::tryLock()
+{
+  // Readers let in by RWLockFair go before the next writer
+  uint32_t passes = m_readerPasses.load();
+
+  if(passes != 0)
+  {
+    // Readers only stop waiting once they have tried to get in, so any passes
+    //  left after that were for readers that timed out
+    if(m_readersWaiting.load() != 0)
+      return false;
+
+    m_readerPasses.compare_exchange_strong(passes, 0);
+  }
+
+  uint32_t state = 0;
+
+  if(!m_state.compare_exchange_strong(state, s_writerBit))
+    return false;
+
+  m_owner.store(pthread_self());
+  return true;
+}
+
+bool LinuxRWLock::tryLockShared()
+{
+  uint32_t state = m_state.load();
+
+  while(!(state & s_writerBit))
+  {
+    // Any reader getting in uses up a pass, so passes can't outlive the readers
+    //  they were given for and keep writers out
+    bool pass = takePass();
+
+    if(!pass && m_policy != RWLockPreferReaders && m_writersWaiting.load() != 0)
+      return false;
+
+    if((state & s_readerMask) == s_readerMask)
+      throw std::overflow_error("too many rwlock readers");
+
+    if(m_state.compare_exchange_weak(state, state + 1))
+      return true;
+
+    if(pass)
+      ++m_readerPasses;
+  }
+
+  return false;
+}
+
+WaitResult LinuxRWLock::waitLock(uint64_t endTime, bool shared)
+{
+  // The writer would wait on itself forever
+  if(m_owner.load() == pthread_self())
+    throw std::logic_error("rwlock already locked for writing by this thread");
+
+  if(shared ? tryLockShared() : tryLock())
+    return WaitSuccess;
+
+  std::atomic<uint32_t>& waiting = (shared ? m_readersWaiting : m_writersWaiting);
+  bool spun = false;
+  bool locked = false;
+
+  ++waiting;
+
+  try
+  {
+    while(true)
+    {
+      // Load the sequence before checking the lock, so a wake in between is not lost
+      uint32_t sequence = m_sequence.load();
+
+      if(shared ? tryLockShared() : tryLock())
+      {
+        locked = true;
+        break;
+      }
+
+      if(!spun)
+      {
+        spun = true;
+        spinWait(sequence, endTime);
+      }
+      else if(!sleep(sequence, endTime))
+        break;
+    }
+  }
+  catch(...)
+  {
+    --waiting;
+    throw;
+  }
+
+  --waiting;
+
+  if(!locked)
+  {
+    // The other side may have been held back for us, a reader also gives up
+    //  the pass it may have been given
+    if(shared)
+      takePass();
+
+    wake();
+    return WaitTimeout;
+  }
+
+  return WaitSuccess;
+}
+
+void LinuxRWLock::spinWait(uint32_t sequence, uint64_t endTime)
+{
+  uint32_t count = m_spin.getSpinCount();
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    if(endTime != INFINITE_END_TIME && getMonotonicTime() >= endTime)
+    {
+      count = i;
+      break;
+    }
+
+    LinuxAdaptiveSpin::pause(i);
+
+    if(m_sequence.load() != sequence)
+    {
+      m_spin.record(true, i + 1);
+      return;
+    }
+  }
+
+  if(count != 0)
+    m_spin.record(false, count);
+}
+
+bool LinuxRWLock::sleep(uint32_t sequence, uint64_t endTime)
+{
+  bool result;
+
+  ++m_waiters;
+
+  try
+  {
+    result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_sequence), sequence, endTime);
+  }
+  catch(...)
+  {
+    --m_waiters;
+    throw;
+  }
+
+  --m_waiters;
+  return result;
+}
+
+void LinuxRWLock::wake()
+{
+  ++m_sequence;
+
+  if(m_waiters.load() != 0)
+    futexWake(reinterpret_cast<volatile uint32_t*>(&m_sequence), UINT32_MAX);
+
+  notify(m_exclusiveHandle);
+  notify(m_sharedHandle);
+}
+
+bool LinuxRWLock::takePass()
+{
+  uint32_t passes = m_readerPasses.load();
+
+  while(passes != 0)
+  {
+    if(m_readerPasses.compare_exchange_weak(passes, passes - 1))
+      return true;
+  }
+
+  return false;
+}
+
+Handle LinuxRWLock::createNotifyHandle(std::atomic<int>& handle)
+{
+  int current = handle.load();
+
+  if(current != INVALID_HANDLE_VALUE)
+    return current;
+
+  // Start signaled, so the first wait through the handle tries the lock
+  int newHandle = eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+
+  if(newHandle == INVALID_HANDLE_VALUE)
+    throw std::bad_syscall("eventfd", lastError());
+
+  // Another WaitSet may have beaten us to it
+  if(!handle.compare_exchange_strong(current, newHandle))
+  {
+    close(newHandle);
+    return current;
+  }
+
+  return newHandle;
+}
+
+void LinuxRWLock::notify(std::atomic<int>& handle)
+{
+  int current = handle.load();
+  uint64_t buffer(1);
+
+  if(current != INVALID_HANDLE_VALUE &&
+     write(current, &buffer, sizeof(buffer)) != sizeof(buffer))
+    throw std::bad_syscall("eventfd write", lastError());
+}
+
+void LinuxRWLock::consumeNotify(Handle handle)
+{
+  uint64_t buffer;
+
+  // Nothing to read just means another waiter got to it first
+  if(read(handle, &buffer, sizeof(buffer)) != sizeof(buffer) && errno != EAGAIN)
+    throw std::bad_syscall("eventfd read", lastError());
+}
+
+LinuxRWLock::SharedObject::SharedObject(LinuxRWLock& lock) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_lock(lock)
+{
+  // Do nothing
+}
+
+LinuxRWLock::SharedObject::~SharedObject()
+{
+  // The handle belongs to the RWLock
+}
+
+WaitResult LinuxRWLock::SharedObject::waitUntil(uint64_t endTime)
+{
+  return m_lock.waitLock(endTime, true);
+}
+
+void LinuxRWLock::SharedObject::prepareHandle()
+{
+  setHandle(createNotifyHandle(m_lock.m_sharedHandle));
+}
+
+bool LinuxRWLock::SharedObject::finishWait(WaitResult& result GCC_UNUSED)
+{
+  consumeNotify(getHandle());
+  return m_lock.tryLockShared();
+}
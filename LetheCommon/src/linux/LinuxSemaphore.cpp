@@ -4,10 +4,15 @@
 #include "LetheFunctions.h"
 #include "LetheException.h"
 #include "eventfd-lethe.h"
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
 #include <sstream>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <algorithm>
 
 using namespace lethe;
 
@@ -15,8 +20,28 @@ const std::string LinuxSemaphore::s_eventfdDevice("/dev/eventfd-lethe");
 
 LinuxSemaphore::LinuxSemaphore(uint32_t maxCount,
                                uint32_t initialCount) :
-  WaitObject(open(s_eventfdDevice.c_str(), O_RDWR))
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_stock(!useLetheModule(s_eventfdDevice)),
+  m_error(false),
+  m_maxCount(maxCount),
+  m_count(initialCount),
+  m_waiters(0)
 {
+  if(m_stock)
+  {
+    if(initialCount > maxCount)
+      throw std::invalid_argument("initialCount");
+
+    setHandle(eventfd(initialCount != 0 ? 1 : 0, EFD_NONBLOCK | EFD_CLOEXEC));
+
+    if(getHandle() == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("eventfd", lastError());
+
+    return;
+  }
+
+  setHandle(open(s_eventfdDevice.c_str(), O_RDWR));
+
   if(getHandle() == INVALID_HANDLE_VALUE)
     throw std::bad_syscall("eventfd open", lastError());
 
@@ -46,7 +71,12 @@ LinuxSemaphore::LinuxSemaphore(uint32_t maxCount,
 }
 
 LinuxSemaphore::LinuxSemaphore(Handle handle) :
-  WaitObject(handle)
+  WaitObject(handle),
+  m_stock(false),
+  m_error(false),
+  m_maxCount(0),
+  m_count(0),
+  m_waiters(0)
 {
   if(getHandle() == INVALID_HANDLE_VALUE)
     throw std::invalid_argument("handle");
@@ -79,21 +109,282 @@ LinuxSemaphore::~LinuxSemaphore()
 
 void LinuxSemaphore::lock(uint32_t timeout)
 {
-  if(WaitForObject(getHandle(), timeout) != WaitSuccess)
+  if(wait(timeout) != WaitSuccess)
     throw std::runtime_error("failed to wait for semaphore");
 }
 
+void LinuxSemaphore::lock(uint32_t count, uint32_t timeout)
+{
+  if(lockUntil(count, false, getEndTime(timeout)) == 0)
+    throw std::runtime_error("failed to wait for semaphore");
+}
+
+uint32_t LinuxSemaphore::lockUpTo(uint32_t count, uint32_t timeout)
+{
+  uint32_t taken = lockUntil(count, true, getEndTime(timeout));
+
+  if(taken == 0)
+    throw std::runtime_error("failed to wait for semaphore");
+
+  return taken;
+}
+
+bool LinuxSemaphore::tryLock(uint32_t count)
+{
+  return (lockUntil(count, false, 0) != 0);
+}
+
+uint32_t LinuxSemaphore::tryLockUpTo(uint32_t count)
+{
+  return lockUntil(count, true, 0);
+}
+
 void LinuxSemaphore::unlock(uint32_t count)
 {
   uint64_t internalCount(count);
 
+  if(m_stock)
+  {
+    uint32_t current = m_count.load();
+
+    do
+    {
+      if(count > m_maxCount - current)
+        throw std::bad_syscall("eventfd write", getErrorString(EINVAL));
+    } while(!m_count.compare_exchange_weak(current, current + count));
+
+    if(m_waiters.load() != 0)
+      futexWake(reinterpret_cast<volatile uint32_t*>(&m_count), UINT32_MAX);
+
+    // The handle only needs a write when the count stops being zero
+    if(current != 0 || count == 0)
+      return;
+
+    internalCount = 1;
+  }
+
   if(write(getHandle(), &internalCount, sizeof(internalCount)) != sizeof(internalCount))
-    throw std::bad_syscall("eventfd write", lastError());
+  {
+    std::string error(lastError());
+
+    if(m_stock)
+      m_count -= count;
+
+    throw std::bad_syscall("eventfd write", error);
+  }
 }
 
 void LinuxSemaphore::error()
 {
-  if(ioctl(getHandle(), EFD_SET_ERROR, true) != 0)
+  if(m_stock)
+  {
+    // A stock eventfd can't report an error, wake up the waiters so finishWait can
+    uint64_t buffer(1);
+    m_error = true;
+
+    if(m_waiters.load() != 0)
+      futexWake(reinterpret_cast<volatile uint32_t*>(&m_count), UINT32_MAX);
+
+    if(write(getHandle(), &buffer, sizeof(buffer)) != sizeof(buffer))
+      throw std::bad_syscall("eventfd write", lastError());
+  }
+  else if(ioctl(getHandle(), EFD_SET_ERROR, true) != 0)
     throw std::bad_syscall("eventfd ioctl EFD_SET_ERROR", lastError());
 }
 
+WaitResult LinuxSemaphore::waitUntil(uint64_t endTime)
+{
+  // Only a stock semaphore has a count in user space to spin on
+  WaitResult result;
+  if(m_stock && m_spin.spin(*this, endTime, result))
+    return result;
+
+  return WaitObject::waitUntil(endTime);
+}
+
+LinuxAdaptiveSpin& LinuxSemaphore::getSpin()
+{
+  return m_spin;
+}
+
+bool LinuxSemaphore::finishWait(WaitResult& result)
+{
+  if(!m_stock)
+    return true;
+
+  if(m_error)
+  {
+    result = WaitAbandoned;
+    return true;
+  }
+
+  if(take(1, false) != 0)
+    return true;
+
+  // The handle may have been left readable by a race with take()
+  updateStockHandle();
+  return false;
+}
+
+uint32_t LinuxSemaphore::lockUntil(uint32_t count, bool upTo, uint64_t endTime)
+{
+  if(count == 0)
+    throw std::invalid_argument("count");
+
+  while(true)
+  {
+    uint32_t taken = take(count, upTo);
+
+    if(taken != 0 || endTime == 0)
+      return taken;
+
+    if(m_stock)
+    {
+      if(m_error)
+        return 0;
+
+      // Count ourselves before checking the count, so an unlock after that sees us
+      ++m_waiters;
+      uint32_t current = m_count.load();
+      bool result = true;
+
+      try
+      {
+        if(current == 0 || (!upTo && current < count))
+          result = futexWait(reinterpret_cast<volatile uint32_t*>(&m_count), current, endTime);
+      }
+      catch(...)
+      {
+        --m_waiters;
+        throw;
+      }
+
+      --m_waiters;
+
+      if(!result)
+        return take(count, upTo);
+    }
+    else if(!upTo)
+    {
+      // Part of the count may already be there, with the rest coming from another
+      //  process, so let the module wake us up whenever the count changes
+      return acquireUntil(count, endTime);
+    }
+    else
+    {
+      if(endTime != INFINITE_END_TIME && getMonotonicTime() >= endTime)
+        return 0;
+
+      // Peek at the handle, so the wait itself does not take any of the count
+      pollfd pollData = { getHandle(), POLLIN | LETHE_POLL_PEEK, 0 };
+      timespec timeout;
+      int result = ppoll(&pollData, 1, getTimeoutTimespec(endTime, timeout), NULL);
+
+      if(result < 0 && errno != EINTR)
+        throw std::bad_syscall("ppoll", lastError());
+      else if(result > 0 && (pollData.revents & POLLERR))
+        return 0;
+      else if(result > 0)
+      {
+        taken = take(count, upTo);
+
+        if(taken != 0)
+          return taken;
+      }
+    }
+  }
+}
+
+uint32_t LinuxSemaphore::acquireUntil(uint32_t count, uint64_t endTime)
+{
+  eventfd_acquire_wait acquire;
+  acquire.end_time = (endTime == INFINITE_END_TIME) ? EFD_WAIT_FOREVER : endTime;
+  acquire.count = count;
+  acquire.padding = 0;
+
+  while(true)
+  {
+    int result = ioctl(getHandle(), EFD_ACQUIRE_WAIT, &acquire);
+
+    if(result > 0)
+      return result;
+    else if(errno == ETIMEDOUT || errno == EIO)
+      return 0;
+    else if(errno != EINTR)
+      throw std::bad_syscall("eventfd ioctl EFD_ACQUIRE_WAIT", lastError());
+  }
+}
+
+uint32_t LinuxSemaphore::take(uint32_t count, bool upTo)
+{
+  if(!m_stock)
+  {
+    int result = ioctl(getHandle(), upTo ? EFD_ACQUIRE_UP_TO : EFD_ACQUIRE, count);
+
+    if(result > 0)
+      return result;
+    else if(errno == EAGAIN || errno == EIO)
+      return 0;
+
+    throw std::bad_syscall("eventfd ioctl EFD_ACQUIRE", lastError());
+  }
+
+  uint32_t current = m_count.load();
+  uint32_t taken;
+
+  do
+  {
+    if(current == 0 || (!upTo && current < count))
+      return 0;
+
+    taken = std::min(current, count);
+  } while(!m_count.compare_exchange_weak(current, current - taken));
+
+  if(current == taken)
+    updateStockHandle();
+
+  return taken;
+}
+
+void LinuxSemaphore::updateStockHandle()
+{
+  uint64_t buffer;
+
+  // Reset the handle once the count reaches zero, then check the count again, in
+  //  case an unlock made it readable in the meantime and its write was read here
+  if(read(getHandle(), &buffer, sizeof(buffer)) != sizeof(buffer) && errno != EAGAIN)
+    throw std::bad_syscall("eventfd read", lastError());
+
+  if(m_count.load() != 0 || m_error)
+  {
+    buffer = 1;
+
+    if(write(getHandle(), &buffer, sizeof(buffer)) != sizeof(buffer))
+      throw std::bad_syscall("eventfd write", lastError());
+  }
+}
+
+bool LinuxSemaphore::canUndoWait() const
+{
+  return true;
+}
+
+void LinuxSemaphore::undoWait()
+{
+  unlock(1);
+}
+
+bool LinuxSemaphore::tryAcquire(WaitResult& result)
+{
+  if(!m_stock)
+    return false;
+
+  if(m_error)
+  {
+    result = WaitAbandoned;
+    return true;
+  }
+
+  result = WaitSuccess;
+  return (take(1, false) != 0);
+}
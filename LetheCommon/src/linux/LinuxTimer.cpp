@@ -7,6 +7,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -16,28 +17,51 @@ using namespace lethe;
 const std::string LinuxTimer::s_timerfdDevice("/dev/timerfd-lethe");
 
 LinuxTimer::LinuxTimer(uint32_t timeout, bool periodic, bool autoReset) :
-  WaitObject(open(s_timerfdDevice.c_str(), O_RDWR))
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_stock(!useLetheModule(s_timerfdDevice)),
+  m_autoReset(autoReset),
+  m_error(false),
+  m_overrun(0)
 {
-  if(getHandle() == INVALID_HANDLE_VALUE)
-    throw std::bad_syscall("timerfd open", lastError());
+  createHandle();
 
-  if(!setCloseOnExec(getHandle()))
+  try
+  {
+    start(timeout, periodic);
+  }
+  catch(...)
   {
     close(getHandle());
-    throw std::bad_syscall("fcntl", lastError());
+    throw;
   }
+}
 
-  if(ioctl(getHandle(), TFD_SET_WAITREAD_MODE, autoReset) != 0)
+LinuxTimer::LinuxTimer(std::chrono::nanoseconds timeout, bool periodic, bool autoReset) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_stock(!useLetheModule(s_timerfdDevice)),
+  m_autoReset(autoReset),
+  m_error(false),
+  m_overrun(0)
+{
+  createHandle();
+
+  try
+  {
+    start(timeout, periodic);
+  }
+  catch(...)
   {
     close(getHandle());
-    throw std::bad_syscall("timerfd ioctl TFD_SET_WAITREAD_MODE", lastError());
+    throw;
   }
-
-  start(timeout, periodic);
 }
 
 LinuxTimer::LinuxTimer(Handle handle) :
-  WaitObject(handle)
+  WaitObject(handle),
+  m_stock(false),
+  m_autoReset(false),
+  m_error(false),
+  m_overrun(0)
 {
   if(getHandle() == INVALID_HANDLE_VALUE)
     throw std::invalid_argument("handle");
@@ -61,6 +85,36 @@ LinuxTimer::~LinuxTimer()
   close(getHandle());
 }
 
+void LinuxTimer::createHandle()
+{
+  if(m_stock)
+  {
+    setHandle(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC));
+
+    if(getHandle() == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("timerfd_create", lastError());
+
+    return;
+  }
+
+  setHandle(open(s_timerfdDevice.c_str(), O_RDWR));
+
+  if(getHandle() == INVALID_HANDLE_VALUE)
+    throw std::bad_syscall("timerfd open", lastError());
+
+  if(!setCloseOnExec(getHandle()))
+  {
+    close(getHandle());
+    throw std::bad_syscall("fcntl", lastError());
+  }
+
+  if(ioctl(getHandle(), TFD_SET_WAITREAD_MODE, m_autoReset) != 0)
+  {
+    close(getHandle());
+    throw std::bad_syscall("timerfd ioctl TFD_SET_WAITREAD_MODE", lastError());
+  }
+}
+
 void LinuxTimer::start(uint32_t timeout, bool periodic)
 {
   timespec elapseTime;
@@ -68,7 +122,35 @@ void LinuxTimer::start(uint32_t timeout, bool periodic)
   elapseTime.tv_sec = timeout / 1000;
   elapseTime.tv_nsec = (timeout % 1000) * 1000000;
 
-  if(periodic)
+  start(elapseTime, periodic);
+}
+
+void LinuxTimer::start(std::chrono::nanoseconds timeout, bool periodic)
+{
+  timespec elapseTime;
+
+  if(timeout.count() < 0)
+    throw std::invalid_argument("timeout");
+
+  elapseTime.tv_sec = timeout.count() / 1000000000;
+  elapseTime.tv_nsec = timeout.count() % 1000000000;
+
+  start(elapseTime, periodic);
+}
+
+void LinuxTimer::start(const timespec& elapseTime, bool periodic)
+{
+  if(m_stock)
+  {
+    itimerspec timerSpec;
+
+    timerSpec.it_value = elapseTime;
+    timerSpec.it_interval.tv_sec = periodic ? elapseTime.tv_sec : 0;
+    timerSpec.it_interval.tv_nsec = periodic ? elapseTime.tv_nsec : 0;
+
+    setTime(timerSpec, 0);
+  }
+  else if(periodic)
   {
     if(ioctl(getHandle(), TFD_SET_PERIODIC_TIME, &elapseTime) != 0)
       throw std::bad_syscall("timerfd ioctl TFD_SET_PERIODIC_TIME", lastError());
@@ -80,6 +162,28 @@ void LinuxTimer::start(uint32_t timeout, bool periodic)
   }
 }
 
+void LinuxTimer::startAt(uint64_t deadline, std::chrono::nanoseconds period)
+{
+  itimerspec timerSpec;
+
+  if(period.count() < 0)
+    throw std::invalid_argument("period");
+
+  // A zero expiration would disarm the timer, and one in the past expires now
+  if(deadline == 0)
+    deadline = 1;
+
+  timerSpec.it_value.tv_sec = deadline / 1000000000;
+  timerSpec.it_value.tv_nsec = deadline % 1000000000;
+  timerSpec.it_interval.tv_sec = period.count() / 1000000000;
+  timerSpec.it_interval.tv_nsec = period.count() % 1000000000;
+
+  if(m_stock)
+    setTime(timerSpec, TFD_TIMER_ABSTIME);
+  else if(ioctl(getHandle(), TFD_SET_DEADLINE, &timerSpec) != 0)
+    throw std::bad_syscall("timerfd ioctl TFD_SET_DEADLINE", lastError());
+}
+
 void LinuxTimer::clear()
 {
   timespec elapseTime;
@@ -87,12 +191,71 @@ void LinuxTimer::clear()
   elapseTime.tv_sec = 0;
   elapseTime.tv_nsec = 0;
 
-  if(ioctl(getHandle(), TFD_SET_RELATIVE_TIME, &elapseTime) != 0)
+  if(m_stock)
+    start(elapseTime, false);
+  else if(ioctl(getHandle(), TFD_SET_RELATIVE_TIME, &elapseTime) != 0)
     throw std::bad_syscall("timerfd ioctl TFD_SET_RELATIVE_TIME", lastError());
 }
 
 void LinuxTimer::error()
 {
-  if(ioctl(getHandle(), TFD_SET_ERROR, true) != 0)
+  if(m_stock)
+  {
+    // A stock timerfd can't report an error, expire the timer so finishWait can
+    timespec elapseTime;
+
+    elapseTime.tv_sec = 0;
+    elapseTime.tv_nsec = 1;
+
+    m_error = true;
+    start(elapseTime, false);
+  }
+  else if(ioctl(getHandle(), TFD_SET_ERROR, true) != 0)
     throw std::bad_syscall("timerfd ioctl TFD_SET_ERROR", lastError());
 }
+
+uint64_t LinuxTimer::getOverrun()
+{
+  if(m_stock)
+    return m_overrun.load();
+
+  uint64_t overrun;
+
+  if(ioctl(getHandle(), TFD_GET_OVERRUN, &overrun) != 0)
+    throw std::bad_syscall("timerfd ioctl TFD_GET_OVERRUN", lastError());
+
+  return overrun;
+}
+
+void LinuxTimer::setTime(const itimerspec& timerSpec, int flags)
+{
+  // Setting the time also discards any expirations that weren't read
+  m_overrun.store(0);
+
+  if(timerfd_settime(getHandle(), flags, &timerSpec, NULL) != 0)
+    throw std::bad_syscall("timerfd_settime", lastError());
+}
+
+bool LinuxTimer::finishWait(WaitResult& result)
+{
+  if(!m_stock)
+    return true;
+
+  if(m_error)
+  {
+    result = WaitAbandoned;
+    return true;
+  }
+
+  if(!m_autoReset)
+    return true;
+
+  // The timer only lets through the waiter that manages to reset it
+  uint64_t expirations;
+
+  if(read(getHandle(), &expirations, sizeof(expirations)) != sizeof(expirations))
+    return false;
+
+  m_overrun.store(expirations - 1);
+  return true;
+}
@@ -0,0 +1,337 @@
+#include "linux/LinuxTimerWheel.h"
+#include "LetheInternal.h"
+#include "LetheFunctions.h"
+#include "LetheException.h"
+
+using namespace lethe;
+
+const uint32_t LinuxTimerWheel::s_levels(4);
+const uint32_t LinuxTimerWheel::s_slotBits(8);
+const uint32_t LinuxTimerWheel::s_slotCount(1 << s_slotBits);
+const uint32_t LinuxTimerWheel::s_slotMask(s_slotCount - 1);
+const uint32_t LinuxTimerWheel::s_none(UINT32_MAX);
+const uint64_t LinuxTimerWheel::s_maxTicks(1ULL << (s_slotBits * s_levels));
+
+LinuxTimerWheel::LinuxTimerWheel(uint32_t resolution) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_timer(std::chrono::nanoseconds(0), false, true),
+  m_resolution(static_cast<uint64_t>(resolution) * 1000000),
+  m_startTime(getMonotonicTime()),
+  m_currentTick(0),
+  m_armedTick(UINT64_MAX),
+  m_count(0),
+  m_freeList(s_none),
+  m_slots(s_levels * s_slotCount, s_none),
+  m_occupied(s_levels * s_slotCount / 64, 0)
+{
+  if(resolution == 0)
+    throw std::invalid_argument("timer wheel resolution");
+
+  setHandle(m_timer.getHandle());
+}
+
+LinuxTimerWheel::LinuxTimerWheel(std::chrono::nanoseconds resolution) :
+  WaitObject(INVALID_HANDLE_VALUE),
+  m_timer(std::chrono::nanoseconds(0), false, true),
+  m_resolution(resolution.count()),
+  m_startTime(getMonotonicTime()),
+  m_currentTick(0),
+  m_armedTick(UINT64_MAX),
+  m_count(0),
+  m_freeList(s_none),
+  m_slots(s_levels * s_slotCount, s_none),
+  m_occupied(s_levels * s_slotCount / 64, 0)
+{
+  if(resolution.count() <= 0)
+    throw std::invalid_argument("timer wheel resolution");
+
+  setHandle(m_timer.getHandle());
+}
+
+LinuxTimerWheel::~LinuxTimerWheel()
+{
+  // Do nothing
+}
+
+TimerId LinuxTimerWheel::schedule(TimerHandler& handler, uint32_t timeout, void* userData, uint32_t slack)
+{
+  return scheduleTimer(handler, userData, static_cast<uint64_t>(timeout) * 1000000,
+                       static_cast<uint64_t>(slack) * 1000000);
+}
+
+TimerId LinuxTimerWheel::schedule(TimerHandler& handler, std::chrono::nanoseconds timeout, void* userData,
+                                  std::chrono::nanoseconds slack)
+{
+  if(timeout.count() < 0 || slack.count() < 0)
+    throw std::invalid_argument("timeout");
+
+  return scheduleTimer(handler, userData, timeout.count(), slack.count());
+}
+
+bool LinuxTimerWheel::cancel(TimerId id)
+{
+  uint32_t index = static_cast<uint32_t>(id);
+
+  if(index >= m_entries.size() || m_entries[index].generation != (id >> 32) ||
+     m_entries[index].slot == s_none)
+    return false;
+
+  // The kernel timer is left armed, advance() finds nothing to do and rearms it
+  unlink(index);
+  release(index);
+  return true;
+}
+
+size_t LinuxTimerWheel::getCount() const
+{
+  return m_count;
+}
+
+void LinuxTimerWheel::advance()
+{
+  uint64_t targetTick = (getMonotonicTime() - m_startTime) / m_resolution;
+
+  // Finish a slot left by a handler that threw
+  expire(m_currentTick);
+
+  while(m_currentTick < targetTick)
+  {
+    if(m_count == 0)
+    {
+      m_currentTick = targetTick;
+      break;
+    }
+
+    // Skip to the next slot with timers, or the next cascade from the level above
+    uint64_t nextTick = (m_currentTick | s_slotMask) + 1;
+    int32_t slot = findSlot(0, (m_currentTick & s_slotMask) + 1);
+
+    if(slot >= 0)
+      nextTick = (m_currentTick & ~static_cast<uint64_t>(s_slotMask)) | slot;
+
+    if(nextTick > targetTick)
+    {
+      m_currentTick = targetTick;
+      break;
+    }
+
+    m_currentTick = nextTick;
+
+    if((nextTick & s_slotMask) == 0)
+      cascade(nextTick);
+
+    expire(nextTick);
+  }
+
+  arm();
+}
+
+void LinuxTimerWheel::handleWait(const WaitEvent& event)
+{
+  if(event.result != WaitSuccess)
+    throw std::runtime_error("timer wheel's timer failed");
+
+  advance();
+}
+
+bool LinuxTimerWheel::finishWait(WaitResult& result)
+{
+  return static_cast<WaitObject&>(m_timer).finishWait(result);
+}
+
+TimerId LinuxTimerWheel::scheduleTimer(TimerHandler& handler, void* userData, uint64_t timeout, uint64_t slack)
+{
+  uint64_t deadline = getMonotonicTime() - m_startTime + timeout;
+  uint64_t expiry = (deadline + m_resolution - 1) / m_resolution;
+  uint64_t latest = (deadline + slack) / m_resolution;
+
+  // Round to the tick in the window with the most trailing zero bits, every
+  //  timer whose window holds that tick will pick the same one
+  if(latest > expiry)
+    expiry = latest & ~((1ULL << (63 - __builtin_clzll((expiry - 1) ^ latest))) - 1);
+
+  if(expiry <= m_currentTick)
+    expiry = m_currentTick + 1;
+
+  uint32_t index = m_freeList;
+
+  if(index != s_none)
+    m_freeList = m_entries[index].next;
+  else
+  {
+    index = m_entries.size();
+
+    if(index == s_none)
+      throw std::runtime_error("too many timers");
+
+    Entry entry = { NULL, NULL, 0, s_none, s_none, 1, s_none };
+    m_entries.push_back(entry);
+  }
+
+  Entry& entry = m_entries[index];
+  entry.handler = &handler;
+  entry.userData = userData;
+  entry.expiry = expiry;
+
+  insert(index);
+  ++m_count;
+  arm();
+
+  return (static_cast<TimerId>(entry.generation) << 32) | index;
+}
+
+void LinuxTimerWheel::insert(uint32_t index)
+{
+  Entry& entry = m_entries[index];
+  uint64_t expiry = entry.expiry;
+  uint64_t delta = expiry - m_currentTick;
+  uint32_t level = 0;
+
+  // Timers beyond the top level wait in its last slot, and are placed again
+  //  once it cascades
+  if(delta >= s_maxTicks)
+    expiry = m_currentTick + s_maxTicks - 1;
+
+  while(level < s_levels - 1 && delta >= (1ULL << (s_slotBits * (level + 1))))
+    ++level;
+
+  uint32_t slot = level * s_slotCount + ((expiry >> (s_slotBits * level)) & s_slotMask);
+
+  entry.slot = slot;
+  entry.previous = s_none;
+  entry.next = m_slots[slot];
+
+  if(entry.next != s_none)
+    m_entries[entry.next].previous = index;
+
+  m_slots[slot] = index;
+  m_occupied[slot / 64] |= (1ULL << (slot % 64));
+}
+
+void LinuxTimerWheel::unlink(uint32_t index)
+{
+  Entry& entry = m_entries[index];
+
+  if(entry.previous != s_none)
+    m_entries[entry.previous].next = entry.next;
+  else
+    m_slots[entry.slot] = entry.next;
+
+  if(entry.next != s_none)
+    m_entries[entry.next].previous = entry.previous;
+
+  if(m_slots[entry.slot] == s_none)
+    m_occupied[entry.slot / 64] &= ~(1ULL << (entry.slot % 64));
+}
+
+void LinuxTimerWheel::release(uint32_t index)
+{
+  Entry& entry = m_entries[index];
+
+  entry.slot = s_none;
+  ++entry.generation;
+  entry.next = m_freeList;
+  m_freeList = index;
+  --m_count;
+}
+
+void LinuxTimerWheel::cascade(uint64_t tick)
+{
+  // Each level moves down one slot when the level below wraps around
+  for(uint32_t level = 1; level < s_levels; ++level)
+  {
+    uint32_t offset = (tick >> (s_slotBits * level)) & s_slotMask;
+    uint32_t slot = level * s_slotCount + offset;
+    uint32_t index = m_slots[slot];
+
+    m_slots[slot] = s_none;
+    m_occupied[slot / 64] &= ~(1ULL << (slot % 64));
+
+    while(index != s_none)
+    {
+      uint32_t next = m_entries[index].next;
+      insert(index);
+      index = next;
+    }
+
+    if(offset != 0)
+      break;
+  }
+}
+
+void LinuxTimerWheel::expire(uint64_t tick)
+{
+  uint32_t slot = tick & s_slotMask;
+
+  // Handlers may schedule and cancel timers, so take one entry at a time
+  while(m_slots[slot] != s_none)
+  {
+    uint32_t index = m_slots[slot];
+    Entry& entry = m_entries[index];
+    TimerHandler* handler = entry.handler;
+    void* userData = entry.userData;
+    TimerId id = (static_cast<TimerId>(entry.generation) << 32) | index;
+
+    unlink(index);
+    release(index);
+    handler->handleTimer(id, userData);
+  }
+}
+
+int32_t LinuxTimerWheel::findSlot(uint32_t level, uint32_t first) const
+{
+  for(uint32_t offset = first; offset < s_slotCount;)
+  {
+    uint32_t slot = level * s_slotCount + offset;
+    uint64_t bits = m_occupied[slot / 64] >> (slot % 64);
+
+    if(bits != 0)
+      return offset + __builtin_ctzll(bits);
+
+    offset += 64 - (slot % 64);
+  }
+
+  return -1;
+}
+
+uint64_t LinuxTimerWheel::getNextTick() const
+{
+  for(uint32_t level = 0; level < s_levels; ++level)
+  {
+    uint32_t shift = s_slotBits * level;
+    uint64_t current = m_currentTick >> shift;
+
+    if(findSlot(level, 0) < 0)
+      continue;
+
+    // A slot of a higher level is due when the level below reaches it
+    int32_t slot = findSlot(level, (current & s_slotMask) + 1);
+
+    if(slot >= 0)
+      return ((current & ~static_cast<uint64_t>(s_slotMask)) | slot) << shift;
+
+    // Only slots that have wrapped around are left, which are reached after
+    //  the level above cascades
+    return ((current | s_slotMask) + 1) << shift;
+  }
+
+  return UINT64_MAX;
+}
+
+void LinuxTimerWheel::arm()
+{
+  uint64_t nextTick = (m_count == 0 ? UINT64_MAX : getNextTick());
+
+  if(nextTick == m_armedTick)
+    return;
+
+  m_armedTick = nextTick;
+
+  if(nextTick == UINT64_MAX)
+  {
+    m_timer.clear();
+    return;
+  }
+
+  m_timer.startAt(m_startTime + nextTick * m_resolution);
+}
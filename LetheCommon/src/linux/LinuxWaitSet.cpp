@@ -2,63 +2,155 @@
 #include "LetheFunctions.h"
 #include "LetheException.h"
 #include "LetheInternal.h"
-#include "mct/hash-map.hpp"
+#include "eventfd-lethe.h"
+#include "timerfd-lethe.h"
 #include <string.h>
 #include <errno.h>
-#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <algorithm>
+
+// Older headers don't have it, kernels before 4.5 ignore the bit
+#ifndef EPOLLEXCLUSIVE
+  #define EPOLLEXCLUSIVE (1u << 28)
+#endif
 
 using namespace lethe;
 
-const uint32_t LinuxWaitSet::s_maxWaitObjects(64);
+const uint32_t LinuxWaitSet::s_minEventCapacity(64);
+const uint64_t LinuxWaitSet::s_strideScale(1 << 20);
+std::atomic<bool> LinuxWaitSet::s_epollPwait2(true);
 
 LinuxWaitSet::LinuxWaitSet() :
-  m_waitObjects(new mct::closed_hash_map<Handle,
-                                         WaitObject*,
-                                         std::tr1::hash<Handle>,
-                                         std::equal_to<Handle>,
-                                         std::allocator<std::pair<const Handle, WaitObject*> >,
-                                         false>),
-  m_waitArray(NULL),
-  m_eventOffset(0)
+  m_epollHandle(epoll_create1(EPOLL_CLOEXEC)),
+  m_eventArray(new epoll_event[s_minEventCapacity]),
+  m_eventCapacity(s_minEventCapacity),
+  m_eventCount(0),
+  m_eventOffset(0),
+  m_policy(WaitPolicyRoundRobin),
+  m_pollCount(0),
+  m_virtualTime(0)
 {
-  // Do nothing
+  if(m_epollHandle == INVALID_HANDLE_VALUE)
+  {
+    delete [] m_eventArray;
+    throw std::bad_syscall("epoll_create1", lastError());
+  }
 }
 
 LinuxWaitSet::~LinuxWaitSet()
 {
-  delete [] m_waitArray;
-  delete m_waitObjects;
+  close(m_epollHandle);
+  delete [] m_eventArray;
 }
 
 bool LinuxWaitSet::add(WaitObject& obj)
 {
-  // Make sure there is size for the new wait object
-  if(m_waitObjects->size() >= s_maxWaitObjects)
+  return addRegistration(obj, NULL, NULL, WaitReadable, false);
+}
+
+bool LinuxWaitSet::add(WaitObject& obj, uint32_t interest)
+{
+  return addRegistration(obj, NULL, NULL, interest, false);
+}
+
+bool LinuxWaitSet::add(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  return addRegistration(obj, &handler, userData, interest, false);
+}
+
+bool LinuxWaitSet::addExclusive(WaitObject& obj)
+{
+  return addRegistration(obj, NULL, NULL, WaitReadable, true);
+}
+
+bool LinuxWaitSet::addExclusive(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  return addRegistration(obj, &handler, userData, interest, true);
+}
+
+// Returns true for handles of the eventfd-lethe and timerfd-lethe devices
+static bool isLetheModuleHandle(Handle handle)
+{
+  struct stat handleInfo;
+
+  if(fstat(handle, &handleInfo) != 0 || !S_ISCHR(handleInfo.st_mode))
     return false;
 
+  return (major(handleInfo.st_rdev) == EVENTFD_LETHE_MAJOR || major(handleInfo.st_rdev) == TIMERFD_LETHE_MAJOR);
+}
+
+bool LinuxWaitSet::addRegistration(WaitObject& obj, WaitHandler* handler, void* userData, uint32_t interest, bool exclusive)
+{
+  obj.prepareHandle();
+
   // Make sure handle is valid
   if(fcntl(obj.getHandle(), F_GETFL) == -1 && errno == EBADF)
     throw std::invalid_argument("invalid handle");
 
-  if(!m_waitObjects->insert(std::make_pair(obj.getHandle(), &obj)).second)
+  // Without LETHE_POLL_PEEK, the poll made by EPOLL_CTL_ADD would acquire a
+  //  signaled module object, and nothing would give it back
+  if(exclusive && isLetheModuleHandle(obj.getHandle()))
+    throw std::invalid_argument("objects of the lethe modules cannot be exclusive");
+
+  Registration newReg;
+  newReg.object = &obj;
+  newReg.handle = obj.getHandle();
+  newReg.writeHandle = obj.getWriteHandle();
+  newReg.handler = handler;
+  newReg.userData = userData;
+  newReg.interest = 0;
+  newReg.exclusive = exclusive;
+  newReg.priority = 0;
+  newReg.weight = 1;
+  newReg.pass = m_virtualTime;
+  newReg.dispatchCount = 0;
+
+  if(!m_registrations.insert(newReg.handle, newReg))
     return false;
 
-  pollfd* oldArray = m_waitArray;
-  m_waitArray = new pollfd[m_waitObjects->size()];
+  Registration* reg = m_registrations.find(newReg.handle);
+  reg->generation = m_registrations.getGeneration(reg->handle);
 
-  // Copy over the old array
-  uint32_t i = 0;
-  for(; i < m_waitObjects->size() - 1; ++i)
-    m_waitArray[i] = oldArray[i];
+  try
+  {
+    setInterest(*reg, interest);
+  }
+  catch(...)
+  {
+    m_registrations.erase(newReg.handle);
+    throw;
+  }
+
+  return true;
+}
+
+bool LinuxWaitSet::modify(WaitObject& obj, uint32_t interest)
+{
+  return modify(obj.getHandle(), interest);
+}
 
-  // Add the new handle at the end of the array
-  m_waitArray[i].fd = obj.getHandle();
-  m_waitArray[i].events = POLLIN;
-  m_waitArray[i].revents = 0;
+bool LinuxWaitSet::modify(Handle handle, uint32_t interest)
+{
+  Registration* reg = m_registrations.find(handle);
+
+  if(reg == NULL)
+    return false;
 
-  delete [] oldArray;
+  setInterest(*reg, interest);
+
+  // Events that were received but are no longer wanted should not be returned
+  uint32_t allowed = EPOLLERR | EPOLLHUP | getEpollEvents(interest, true);
+  uint64_t key = makeKey(reg->handle, reg->generation);
+  for(uint32_t j = m_eventOffset; j < m_eventCount; ++j)
+  {
+    if(m_eventArray[j].data.u64 == key)
+      m_eventArray[j].events &= allowed;
+  }
 
   return true;
 }
@@ -70,105 +162,494 @@ bool LinuxWaitSet::remove(WaitObject& obj)
 
 bool LinuxWaitSet::remove(Handle handle)
 {
-  if(!m_waitObjects->erase(handle))
+  Registration* reg = m_registrations.find(handle);
+
+  if(reg == NULL)
     return false;
 
-  pollfd* oldArray = m_waitArray;
-  m_waitArray = new pollfd[m_waitObjects->size()];
+  bool writeAdded = (reg->writeHandle != reg->handle && (reg->interest & WaitWritable));
+  Handle writeHandle = reg->writeHandle;
 
-  // Copy over the old array, skipping over the removed handle
-  uint32_t j = 0;
-  for(uint32_t i = 0; i < m_waitObjects->size() + 1; ++i)
+  // Any events for this handle that have been received but not yet returned are
+  //  dropped when they no longer match the generation in the table
+  m_registrations.erase(handle);
+
+  // If the handle has already been closed, the kernel has removed it from the set for us
+  if(epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, handle, NULL) != 0 && errno != EBADF && errno != ENOENT)
+    throw std::bad_syscall("epoll_ctl", lastError());
+
+  if(writeAdded && epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, writeHandle, NULL) != 0 && errno != EBADF && errno != ENOENT)
+    throw std::bad_syscall("epoll_ctl", lastError());
+
+  return true;
+}
+
+uint32_t LinuxWaitSet::getEpollEvents(uint32_t interest, bool includeWrite)
+{
+  uint32_t events = 0;
+
+  if(interest & WaitReadable)
+    events |= EPOLLIN;
+
+  if((interest & WaitWritable) && includeWrite)
+    events |= EPOLLOUT;
+
+  if(interest & WaitHangup)
+    events |= EPOLLRDHUP;
+
+  return events;
+}
+
+void LinuxWaitSet::setInterest(Registration& reg, uint32_t interest)
+{
+  bool separateWrite = (reg.writeHandle != reg.handle);
+
+  if(interest == 0 || (interest & ~(WaitReadable | WaitWritable | WaitHangup)) != 0)
+    throw std::invalid_argument("interest");
+
+  if(reg.exclusive && (interest & WaitHangup))
+    throw std::invalid_argument("WaitHangup cannot be exclusive");
+
+  if(separateWrite && (interest & WaitWritable) && reg.writeHandle == INVALID_HANDLE_VALUE)
+    throw std::invalid_argument("object has no write handle");
+
+  // Errors on the read handle are always wanted, so it stays in the set even
+  //  without WaitReadable, a separate write handle is only there for WaitWritable
+  bool readAdded = (reg.interest != 0);
+  bool writeAdded = separateWrite && (reg.interest & WaitWritable);
+
+  try
+  {
+    setEpollEvents(reg, reg.handle, readAdded, getEpollEvents(interest, !separateWrite));
+    readAdded = true;
+
+    if(separateWrite && (interest & WaitWritable))
+      setEpollEvents(reg, reg.writeHandle, writeAdded, EPOLLOUT);
+    else if(writeAdded && epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, reg.writeHandle, NULL) != 0 && errno != EBADF && errno != ENOENT)
+      throw std::bad_syscall("epoll_ctl", lastError());
+  }
+  catch(...)
   {
-    if(oldArray[i].fd != handle)
-      m_waitArray[j++] = oldArray[i];
-    else
-      m_eventOffset = i;
+    // A new registration must not be left half in the set
+    if(reg.interest == 0 && readAdded)
+      epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, reg.handle, NULL);
+
+    throw;
   }
 
-  delete [] oldArray;
+  reg.interest = interest;
+}
 
-  return true;
+void LinuxWaitSet::setEpollEvents(Registration& reg, Handle handle, bool added, uint32_t events)
+{
+  epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.data.u64 = makeKey(reg.handle, reg.generation);
+
+  // The kernel won't take LETHE_POLL_PEEK with EPOLLEXCLUSIVE, or modify an exclusive entry
+  if(reg.exclusive)
+  {
+    event.events = events | EPOLLEXCLUSIVE;
+
+    if(added && epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, handle, NULL) != 0)
+      throw std::bad_syscall("epoll_ctl", lastError());
+
+    added = false;
+  }
+  else
+    event.events = events | LETHE_POLL_PEEK;
+
+  if(epoll_ctl(m_epollHandle, added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, handle, &event) != 0)
+    throw std::bad_syscall("epoll_ctl", lastError());
 }
 
 size_t LinuxWaitSet::getSize() const
 {
-  return m_waitObjects->size();
+  return m_registrations.size();
+}
+
+void LinuxWaitSet::setPolicy(WaitPolicy policy)
+{
+  if(policy != WaitPolicyInOrder && policy != WaitPolicyRoundRobin &&
+     policy != WaitPolicyPriority && policy != WaitPolicyWeighted)
+    throw std::invalid_argument("policy");
+
+  m_policy = policy;
+}
+
+WaitPolicy LinuxWaitSet::getPolicy() const
+{
+  return m_policy;
+}
+
+bool LinuxWaitSet::setPriority(WaitObject& obj, uint32_t priority)
+{
+  Registration* reg = m_registrations.find(obj.getHandle());
+
+  if(reg == NULL)
+    return false;
+
+  reg->priority = priority;
+  return true;
+}
+
+bool LinuxWaitSet::setWeight(WaitObject& obj, uint32_t weight)
+{
+  Registration* reg = m_registrations.find(obj.getHandle());
+
+  if(weight == 0)
+    throw std::invalid_argument("weight");
+
+  if(reg == NULL)
+    return false;
+
+  reg->weight = weight;
+  return true;
+}
+
+uint64_t LinuxWaitSet::getDispatchCount(WaitObject& obj) const
+{
+  const Registration* reg = m_registrations.find(obj.getHandle());
+  return (reg != NULL) ? reg->dispatchCount : 0;
+}
+
+uint64_t LinuxWaitSet::makeKey(Handle handle, uint32_t generation)
+{
+  return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(handle);
+}
+
+LinuxWaitSet::Registration* LinuxWaitSet::findEvent(const epoll_event& event)
+{
+  return m_registrations.find(static_cast<Handle>(event.data.u64 & 0xFFFFFFFF), event.data.u64 >> 32);
 }
 
 WaitResult LinuxWaitSet::waitAny(uint32_t timeout, Handle& handle)
 {
-  uint32_t endTime = getEndTime(timeout);
+  return waitAnyUntil(getEndTime(timeout), handle);
+}
+
+WaitResult LinuxWaitSet::waitAny(std::chrono::nanoseconds timeout, Handle& handle)
+{
+  return waitAnyUntil(getEndTime(timeout), handle);
+}
 
-  if(m_waitObjects->size() == 0)
+WaitResult LinuxWaitSet::waitAnyUntil(uint64_t endTime, Handle& handle)
+{
+  if(m_registrations.size() == 0)
   {
-    sleep_ms(timeout);
+    sleepUntil(endTime);
+    handle = INVALID_HANDLE_VALUE;
     return WaitTimeout;
   }
 
-  WaitResult result = getEvent(handle);
+  WaitResult result;
+  uint32_t events;
+  Registration* reg = getEvent(result, events);
+
+  if(reg == NULL && pollEvents(endTime) == WaitSuccess)
+    reg = getEvent(result, events);
+
+  handle = (reg != NULL) ? reg->handle : INVALID_HANDLE_VALUE;
+  return result;
+}
+
+size_t LinuxWaitSet::waitMany(uint32_t timeout, Handle* handles, WaitResult* results, size_t maxCount)
+{
+  return waitManyUntil(getEndTime(timeout), handles, results, maxCount);
+}
+
+size_t LinuxWaitSet::waitMany(std::chrono::nanoseconds timeout, Handle* handles, WaitResult* results, size_t maxCount)
+{
+  return waitManyUntil(getEndTime(timeout), handles, results, maxCount);
+}
+
+size_t LinuxWaitSet::waitManyUntil(uint64_t endTime, Handle* handles, WaitResult* results, size_t maxCount)
+{
+  size_t count;
+
+  if(maxCount == 0)
+    throw std::invalid_argument("maxCount");
+
+  if(m_registrations.size() == 0)
+  {
+    sleepUntil(endTime);
+    return 0;
+  }
+
+  // Only go to the kernel if nothing is left over from the last wait
+  count = getEvents(handles, results, maxCount);
 
-  if(result == WaitTimeout)
+  if(count == 0 && pollEvents(endTime) == WaitSuccess)
+    count = getEvents(handles, results, maxCount);
+
+  return count;
+}
+
+size_t LinuxWaitSet::waitMany(uint32_t timeout, WaitEvent* events, size_t maxCount)
+{
+  return waitManyUntil(getEndTime(timeout), events, maxCount);
+}
+
+size_t LinuxWaitSet::waitMany(std::chrono::nanoseconds timeout, WaitEvent* events, size_t maxCount)
+{
+  return waitManyUntil(getEndTime(timeout), events, maxCount);
+}
+
+size_t LinuxWaitSet::waitManyUntil(uint64_t endTime, WaitEvent* events, size_t maxCount)
+{
+  size_t count;
+
+  if(maxCount == 0)
+    throw std::invalid_argument("maxCount");
+
+  if(m_registrations.size() == 0)
   {
-    if(pollEvents(timeout, endTime) == WaitSuccess)
-      result = getEvent(handle);
-    else
-      handle = INVALID_HANDLE_VALUE;
+    sleepUntil(endTime);
+    return 0;
   }
 
-  return result;
+  count = getEvents(events, maxCount);
+
+  if(count == 0 && pollEvents(endTime) == WaitSuccess)
+    count = getEvents(events, maxCount);
+
+  return count;
+}
+
+size_t LinuxWaitSet::dispatch(uint32_t timeout)
+{
+  return dispatchUntil(getEndTime(timeout));
+}
+
+size_t LinuxWaitSet::dispatch(std::chrono::nanoseconds timeout)
+{
+  return dispatchUntil(getEndTime(timeout));
+}
+
+size_t LinuxWaitSet::dispatchUntil(uint64_t endTime)
+{
+  size_t count = 0;
+  WaitEvent event;
+
+  if(m_registrations.size() == 0)
+  {
+    sleepUntil(endTime);
+    return 0;
+  }
+
+  if(getEvents(&event, 1) == 0)
+  {
+    if(pollEvents(endTime) != WaitSuccess || getEvents(&event, 1) == 0)
+      return 0;
+  }
+
+  // Take events one at a time, so a handler removing an object drops its pending events
+  do
+  {
+    if(event.handler == NULL)
+      throw std::logic_error("dispatched WaitObject has no handler");
+
+    event.handler->handleWait(event);
+    ++count;
+  } while(getEvents(&event, 1) == 1);
+
+  return count;
 }
 
-WaitResult LinuxWaitSet::pollEvents(uint32_t timeout, uint32_t endTime)
+void LinuxWaitSet::resizeEvents()
 {
+  // Grow the event array along with the set, so a single epoll_wait can return every handle
+  if(m_eventCapacity >= m_registrations.size())
+    return;
+
+  uint32_t capacity = m_eventCapacity;
+  while(capacity < m_registrations.size())
+    capacity *= 2;
+
+  epoll_event* newArray = new epoll_event[capacity];
+  delete [] m_eventArray;
+  m_eventArray = newArray;
+  m_eventCapacity = capacity;
+}
+
+WaitResult LinuxWaitSet::pollEvents(uint64_t endTime)
+{
+  resizeEvents();
+
   m_eventOffset = 0;
+  m_eventCount = 0;
 
   do
   {
-    int eventCount = poll(m_waitArray, m_waitObjects->size(), timeout);
+    int eventCount = waitEpoll(endTime);
 
     if(eventCount < 0)
     {
       if(errno == EINTR)
-      {
-        timeout = getTimeout(endTime);
         continue;
-      }
       else
-        throw std::bad_syscall("poll", lastError());
+        throw std::bad_syscall("epoll_wait", lastError());
     }
     else if(eventCount == 0)
       return WaitTimeout;
-    else
-      return WaitSuccess;
+
+    m_eventCount = eventCount;
+    orderEvents();
+    return WaitSuccess;
   } while(true);
 }
 
-WaitResult LinuxWaitSet::getEvent(Handle& handle)
+int LinuxWaitSet::waitEpoll(uint64_t endTime)
+{
+#if defined(SYS_epoll_pwait2) && defined(__LP64__)
+  // epoll_pwait2 (Linux 5.11) takes the timeout in ns, epoll_wait rounds it to ms
+  if(s_epollPwait2.load())
+  {
+    timespec timeout;
+    int result = syscall(SYS_epoll_pwait2, m_epollHandle, m_eventArray, m_eventCapacity,
+                         getTimeoutTimespec(endTime, timeout), NULL, 0);
+
+    if(result >= 0 || errno != ENOSYS)
+      return result;
+
+    s_epollPwait2 = false;
+  }
+#endif
+
+  return epoll_wait(m_epollHandle, m_eventArray, m_eventCapacity, getTimeout(endTime));
+}
+
+void LinuxWaitSet::orderEvents()
+{
+  switch(m_policy)
+  {
+  case WaitPolicyRoundRobin:
+    std::rotate(m_eventArray, m_eventArray + (m_pollCount++ % m_eventCount), m_eventArray + m_eventCount);
+    break;
+
+  case WaitPolicyPriority:
+  case WaitPolicyWeighted:
+    std::stable_sort(m_eventArray, m_eventArray + m_eventCount, EventOrder(*this));
+    break;
+
+  default:
+    break;
+  }
+}
+
+LinuxWaitSet::EventOrder::EventOrder(LinuxWaitSet& waitSet) :
+  m_waitSet(waitSet)
+{
+  // Do nothing
+}
+
+bool LinuxWaitSet::EventOrder::operator () (const epoll_event& a, const epoll_event& b) const
 {
-  WaitResult result = WaitTimeout;
-  handle = INVALID_HANDLE_VALUE;
+  Registration* regA = m_waitSet.findEvent(a);
+  Registration* regB = m_waitSet.findEvent(b);
 
-  // Scan for the next valid handle in the waitArray
-  for(; m_eventOffset < m_waitObjects->size(); ++m_eventOffset)
+  // Stale events will be skipped anyway, put them at the end
+  if(regA == NULL || regB == NULL)
+    return (regB == NULL && regA != NULL);
+
+  if(m_waitSet.m_policy == WaitPolicyPriority)
+    return regA->priority > regB->priority;
+
+  return regA->pass < regB->pass;
+}
+
+LinuxWaitSet::Registration* LinuxWaitSet::getEvent(WaitResult& result, uint32_t& events)
+{
+  result = WaitTimeout;
+  events = 0;
+
+  // Scan for the next valid handle in the received events
+  for(; m_eventOffset < m_eventCount; ++m_eventOffset)
   {
+    uint32_t epollEvents = m_eventArray[m_eventOffset].events;
+    Registration* reg = findEvent(m_eventArray[m_eventOffset]);
+
+    if(reg == NULL)
+      continue;
+
     // TODO: handled abandoned mutex event
-    if(m_waitArray[m_eventOffset].revents & (POLLERR | POLLHUP | POLLNVAL))
+    if(epollEvents & (EPOLLERR | EPOLLHUP))
     {
-      m_waitArray[m_eventOffset].revents = 0; // Mask out all events, error conditions prevent success
-      handle = m_waitArray[m_eventOffset].fd;
       result = WaitError;
-      break;
+      events = WaitHangup;
+      ++m_eventOffset;
+      return countEvent(reg);
     }
-    else if(m_waitArray[m_eventOffset].revents & POLLIN)
+    else if(epollEvents & (EPOLLIN | EPOLLOUT | EPOLLRDHUP))
     {
-      m_waitArray[m_eventOffset].revents = 0;
-      handle = m_waitArray[m_eventOffset].fd;
       result = WaitSuccess;
-      break;
+      events = ((epollEvents & EPOLLIN) ? WaitReadable : 0) |
+               ((epollEvents & EPOLLOUT) ? WaitWritable : 0) |
+               ((epollEvents & EPOLLRDHUP) ? WaitHangup : 0);
+
+      // Objects that aren't consumed by epoll are consumed here, if another waiter
+      //  got there first the readable event is dropped
+      if((events & WaitReadable) && !reg->object->finishWait(result))
+        events &= ~WaitReadable;
+
+      if(result == WaitAbandoned)
+      {
+        result = WaitError;
+        events = WaitHangup;
+      }
+      else if(events == 0)
+      {
+        result = WaitTimeout;
+        continue;
+      }
+
+      ++m_eventOffset;
+      return countEvent(reg);
     }
   }
 
-  return result;
+  return NULL;
+}
+
+LinuxWaitSet::Registration* LinuxWaitSet::countEvent(Registration* reg)
+{
+  ++reg->dispatchCount;
+
+  // Handles with a larger weight move forward in virtual time more slowly
+  if(m_policy == WaitPolicyWeighted)
+  {
+    m_virtualTime = std::max(m_virtualTime, reg->pass);
+    reg->pass = m_virtualTime + s_strideScale / reg->weight;
+  }
+
+  return reg;
+}
+
+size_t LinuxWaitSet::getEvents(Handle* handles, WaitResult* results, size_t maxCount)
+{
+  size_t count = 0;
+  uint32_t events;
+  Registration* reg;
+
+  while(count < maxCount && (reg = getEvent(results[count], events)) != NULL)
+    handles[count++] = reg->handle;
+
+  return count;
 }
 
+size_t LinuxWaitSet::getEvents(WaitEvent* events, size_t maxCount)
+{
+  size_t count = 0;
+  Registration* reg;
+
+  while(count < maxCount && (reg = getEvent(events[count].result, events[count].events)) != NULL)
+  {
+    events[count].object = reg->object;
+    events[count].handle = reg->handle;
+    events[count].handler = reg->handler;
+    events[count].userData = reg->userData;
+    ++count;
+  }
+
+  return count;
+}
@@ -2,6 +2,7 @@
 #include "LetheBasic.h"
 #include "LetheFunctions.h"
 #include "LetheException.h"
+#include "LetheInternal.h"
 #include <Windows.h>
 #include <string>
 #include <vector>
@@ -129,6 +130,17 @@ void lethe::sleep_ms(uint32_t timeout)
   Sleep(timeout);
 }
 
+void lethe::sleep_ms(std::chrono::nanoseconds timeout)
+{
+  lethe::sleepUntil(lethe::getEndTime(timeout));
+}
+
+void lethe::sleepUntil(uint64_t endTime)
+{
+  // Windows only sleeps in ms, round up so the end time has passed
+  Sleep(lethe::getTimeout(endTime));
+}
+
 std::string lethe::getErrorString(uint32_t errorCode)
 {
   TCHAR* buffer(NULL);
@@ -173,6 +185,22 @@ uint64_t lethe::getTime()
   return retval;
 }
 
+uint64_t lethe::getMonotonicTime()
+{
+  static LARGE_INTEGER frequency = { 0 };
+  LARGE_INTEGER counter;
+
+  if(frequency.QuadPart == 0 && !QueryPerformanceFrequency(&frequency))
+    throw std::bad_syscall("QueryPerformanceFrequency", lethe::lastError());
+
+  if(!QueryPerformanceCounter(&counter))
+    throw std::bad_syscall("QueryPerformanceCounter", lethe::lastError());
+
+  // Split the conversion to avoid overflowing the multiplication
+  return ((counter.QuadPart / frequency.QuadPart) * 1000000000) +
+         ((counter.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart);
+}
+
 std::string lethe::getTimeString()
 {
   std::stringstream timeString;
@@ -229,7 +257,60 @@ uint32_t lethe::seedRandom(uint32_t seed)
 
 lethe::WaitResult lethe::WaitForObject(lethe::WaitObject& obj, uint32_t timeout)
 {
-  return WaitForObject(obj.getHandle(), timeout);
+  return obj.wait(timeout);
+}
+
+lethe::WaitResult lethe::WaitForObject(lethe::WaitObject& obj, std::chrono::nanoseconds timeout)
+{
+  return obj.wait(timeout);
+}
+
+lethe::WaitResult lethe::WaitForObject(lethe::Handle handle, std::chrono::nanoseconds timeout)
+{
+  return lethe::waitForHandle(handle, lethe::getEndTime(timeout));
+}
+
+lethe::WaitResult lethe::waitForHandle(lethe::Handle handle, uint64_t endTime)
+{
+  return lethe::WaitForObject(handle, lethe::getTimeout(endTime));
+}
+
+lethe::WaitResult lethe::WaitForAllObjects(lethe::WaitObject** objects, uint32_t count, uint32_t timeout)
+{
+  return lethe::waitForAllObjects(objects, count, lethe::getEndTime(timeout));
+}
+
+lethe::WaitResult lethe::WaitForAllObjects(lethe::WaitObject** objects, uint32_t count, std::chrono::nanoseconds timeout)
+{
+  return lethe::waitForAllObjects(objects, count, lethe::getEndTime(timeout));
+}
+
+lethe::WaitResult lethe::waitForAllObjects(lethe::WaitObject** objects, uint32_t count, uint64_t endTime)
+{
+  if(objects == NULL || count == 0 || count > MAXIMUM_WAIT_OBJECTS)
+    throw std::invalid_argument("invalid number of objects to wait for");
+
+  std::vector<HANDLE> handles(count);
+
+  for(uint32_t i = 0; i < count; ++i)
+  {
+    if(objects[i] == NULL)
+      throw std::invalid_argument("object can't be used with WaitForAllObjects");
+
+    handles[i] = objects[i]->getHandle();
+  }
+
+  // The kernel takes all of the objects atomically
+  DWORD result = WaitForMultipleObjects(count, &handles[0], TRUE, lethe::getTimeout(endTime));
+
+  if(result < WAIT_OBJECT_0 + count)
+    return lethe::WaitSuccess;
+  else if(result >= WAIT_ABANDONED_0 && result < WAIT_ABANDONED_0 + count)
+    return lethe::WaitAbandoned;
+  else if(result == WAIT_TIMEOUT)
+    return lethe::WaitTimeout;
+
+  throw std::bad_syscall("WaitForMultipleObjects", lethe::lastError());
 }
 
 lethe::WaitResult lethe::WaitForObject(lethe::Handle handle, uint32_t timeout)
@@ -1,6 +1,7 @@
 #include "windows/WindowsMutex.h"
 #include "LetheFunctions.h"
 #include "LetheException.h"
+#include "LetheInternal.h"
 #include <Windows.h>
 #include <sstream>
 
@@ -9,7 +10,7 @@ using namespace lethe;
 const std::string WindowsMutex::s_mutexBaseName("Global\\lethe-mutex-");
 WindowsAtomic WindowsMutex::s_uniqueId(0);
 
-WindowsMutex::WindowsMutex(bool locked) :
+WindowsMutex::WindowsMutex(bool locked, MutexProtocol protocol GCC_UNUSED) :
   WaitObject(NULL)
 {
   std::stringstream str;
@@ -28,6 +28,7 @@ WindowsPipe::WindowsPipe() :
   m_writeMutexIn(NULL),
   m_writeMutexOut(NULL),
   m_asyncThread(INVALID_HANDLE_VALUE),
+  m_flushEvent(true, false),
   m_destructing(false)
 {
   try
@@ -73,7 +74,8 @@ WindowsPipe::WindowsPipe(const std::string& nameIn,
   m_readMutexOut(NULL),
   m_writeMutexIn(NULL),
   m_writeMutexOut(NULL),
-  m_asyncThread(INVALID_HANDLE_VALUE)
+  m_asyncThread(INVALID_HANDLE_VALUE),
+  m_flushEvent(true, false)
 {
   try
   {
@@ -206,8 +208,22 @@ void WindowsPipe::send(const void* buffer, uint32_t bufferSize)
     params->size = bufferSize;
     params->instance = this;
 
-    m_asyncThread = CreateThread(NULL, 0, asyncThreadHook, params, 0, NULL);
+    // Reset the flush event before the thread starts, since the thread sets it when done
+    m_flushEvent.reset();
+    Handle asyncThread = CreateThread(NULL, 0, asyncThreadHook, params, 0, NULL);
+
+    if(asyncThread == NULL)
+    {
+      // Nothing is pending after all, so the flush event must be set again
+      std::string error = lastError();
+      delete params;
+      pipeData->pendingWrite = false;
+      m_flushEvent.set();
+      m_readMutexOut->unlock();
+      throw std::bad_syscall("CreateThread", error);
+    }
 
+    m_asyncThread = asyncThread;
     m_readMutexOut->unlock();
   }
 }
@@ -349,6 +365,7 @@ void WindowsPipe::asyncThread(const char* buffer, uint32_t size)
   m_readMutexOut->lock();
   m_asyncThread = INVALID_HANDLE_VALUE;
   pipeData->pendingWrite = false;
+  m_flushEvent.set();
   m_readMutexOut->unlock();
 
   m_writeMutexOut->unlock();
@@ -375,4 +392,9 @@ bool WindowsPipe::flush(uint32_t timeout)
   }
 
   return retval;
-}
\ No newline at end of file
+}
+
+WaitObject& WindowsPipe::getFlushObject()
+{
+  return m_flushEvent;
+}
@@ -53,6 +53,20 @@ void WindowsTimer::start(uint32_t timeout)
     throw std::bad_syscall("SetWaitableTimer", lastError());
 }
 
+void WindowsTimer::start(std::chrono::nanoseconds timeout)
+{
+  LARGE_INTEGER elapseTime;
+
+  if(timeout.count() < 0)
+    throw std::invalid_argument("timeout");
+
+  // Relative times are negative, in 100ns units
+  elapseTime.QuadPart = -(timeout.count() / 100);
+
+  if(!SetWaitableTimer(getHandle(), &elapseTime, 0, NULL, NULL, false))
+    throw std::bad_syscall("SetWaitableTimer", lastError());
+}
+
 void WindowsTimer::clear()
 {
   LARGE_INTEGER elapseTime;
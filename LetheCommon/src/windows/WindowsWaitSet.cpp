@@ -1,17 +1,21 @@
 #include "windows/WindowsWaitSet.h"
 #include "LetheFunctions.h"
 #include "LetheException.h"
+#include "LetheInternal.h"
 #include "mct/hash-map.hpp"
 #include <Windows.h>
+#include <algorithm>
+#include <vector>
 
 using namespace lethe;
 
 const uint32_t WindowsWaitSet::s_maxWaitObjects(64);
 
 WindowsWaitSet::WindowsWaitSet() :
-  m_waitObjects(new mct::closed_hash_map<Handle, WaitObject*>),
+  m_waitObjects(new mct::closed_hash_map<Handle, Registration*>),
   m_handleArray(NULL),
-  m_offset(0)
+  m_offset(0),
+  m_policy(WaitPolicyRoundRobin)
 {
   // Do nothing
 }
@@ -19,27 +23,88 @@ WindowsWaitSet::WindowsWaitSet() :
 WindowsWaitSet::~WindowsWaitSet()
 {
   delete [] m_handleArray;
+
+  for(mct::closed_hash_map<Handle, Registration*>::iterator i = m_waitObjects->begin(); i != m_waitObjects->end(); ++i)
+    delete i->second;
+
+  delete m_waitObjects;
 }
 
 bool WindowsWaitSet::add(WaitObject& obj)
+{
+  return addRegistration(obj, NULL, NULL, WaitReadable);
+}
+
+bool WindowsWaitSet::add(WaitObject& obj, uint32_t interest)
+{
+  return addRegistration(obj, NULL, NULL, interest);
+}
+
+bool WindowsWaitSet::add(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  return addRegistration(obj, &handler, userData, interest);
+}
+
+bool WindowsWaitSet::addExclusive(WaitObject& obj)
+{
+  return addRegistration(obj, NULL, NULL, WaitReadable);
+}
+
+bool WindowsWaitSet::addExclusive(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  return addRegistration(obj, &handler, userData, interest);
+}
+
+bool WindowsWaitSet::addRegistration(WaitObject& obj, WaitHandler* handler, void* userData, uint32_t interest)
 {
   DWORD handleInfo;
 
+  checkInterest(interest);
+
   // Make sure there is size for the new wait object
   if(m_waitObjects->size() >= s_maxWaitObjects)
     return false;
 
+  obj.prepareHandle();
+
   if(obj.getHandle() == INVALID_HANDLE_VALUE ||
      !GetHandleInformation(obj.getHandle(), &handleInfo))
     throw std::invalid_argument("invalid handle");
 
-  if(!m_waitObjects->insert(std::make_pair(obj.getHandle(), &obj)).second)
+  if(m_waitObjects->find(obj.getHandle()) != m_waitObjects->end())
     return false;
 
+  Registration* reg = new Registration;
+  reg->object = &obj;
+  reg->handle = obj.getHandle();
+  reg->handler = handler;
+  reg->userData = userData;
+  reg->priority = 0;
+  reg->weight = 1;
+  reg->dispatchCount = 0;
+  m_waitObjects->insert(std::make_pair(reg->handle, reg));
+
   resizeEvents();
   return true;
 }
 
+bool WindowsWaitSet::modify(WaitObject& obj, uint32_t interest)
+{
+  return modify(obj.getHandle(), interest);
+}
+
+bool WindowsWaitSet::modify(Handle handle, uint32_t interest)
+{
+  checkInterest(interest);
+  return m_waitObjects->find(handle) != m_waitObjects->end();
+}
+
+void WindowsWaitSet::checkInterest(uint32_t interest)
+{
+  if(interest != WaitReadable)
+    throw std::invalid_argument("interest");
+}
+
 bool WindowsWaitSet::remove(WaitObject& obj)
 {
   return remove(obj.getHandle());
@@ -47,9 +112,14 @@ bool WindowsWaitSet::remove(WaitObject& obj)
 
 bool WindowsWaitSet::remove(Handle handle)
 {
-  if(!m_waitObjects->erase(handle))
+  mct::closed_hash_map<Handle, Registration*>::iterator i = m_waitObjects->find(handle);
+
+  if(i == m_waitObjects->end())
     return false;
 
+  delete i->second;
+  m_waitObjects->erase(i);
+
   resizeEvents();
   return true;
 }
@@ -59,6 +129,89 @@ size_t WindowsWaitSet::getSize() const
   return m_waitObjects->size();
 }
 
+void WindowsWaitSet::setPolicy(WaitPolicy policy)
+{
+  if(policy != WaitPolicyInOrder && policy != WaitPolicyRoundRobin &&
+     policy != WaitPolicyPriority && policy != WaitPolicyWeighted)
+    throw std::invalid_argument("policy");
+
+  m_policy = policy;
+  m_offset = 0;
+  resizeEvents();
+}
+
+WaitPolicy WindowsWaitSet::getPolicy() const
+{
+  return m_policy;
+}
+
+bool WindowsWaitSet::setPriority(WaitObject& obj, uint32_t priority)
+{
+  Registration* reg = findRegistration(obj.getHandle());
+
+  if(reg == NULL)
+    return false;
+
+  reg->priority = priority;
+
+  if(m_policy == WaitPolicyPriority)
+    resizeEvents();
+
+  return true;
+}
+
+bool WindowsWaitSet::setWeight(WaitObject& obj, uint32_t weight)
+{
+  Registration* reg = findRegistration(obj.getHandle());
+
+  if(weight == 0)
+    throw std::invalid_argument("weight");
+
+  if(reg == NULL)
+    return false;
+
+  reg->weight = weight;
+  return true;
+}
+
+uint64_t WindowsWaitSet::getDispatchCount(WaitObject& obj) const
+{
+  Registration* reg = findRegistration(obj.getHandle());
+  return (reg != NULL) ? reg->dispatchCount : 0;
+}
+
+bool WindowsWaitSet::comparePriority(const Registration* a, const Registration* b)
+{
+  return a->priority > b->priority;
+}
+
+WindowsWaitSet::Registration* WindowsWaitSet::findRegistration(Handle handle) const
+{
+  mct::closed_hash_map<Handle, Registration*>::const_iterator i = m_waitObjects->find(handle);
+  return (i != m_waitObjects->cend()) ? i->second : NULL;
+}
+
+// Windows only waits in ms, durations are rounded up
+WaitResult WindowsWaitSet::waitAny(std::chrono::nanoseconds timeout, Handle& handle)
+{
+  return waitAny(getTimeout(getEndTime(timeout)), handle);
+}
+
+size_t WindowsWaitSet::waitMany(std::chrono::nanoseconds timeout, Handle* handles, WaitResult* results, size_t maxCount)
+{
+  return waitMany(getTimeout(getEndTime(timeout)), handles, results, maxCount);
+}
+
+size_t WindowsWaitSet::waitMany(std::chrono::nanoseconds timeout, WaitEvent* events, size_t maxCount)
+{
+  return waitMany(getTimeout(getEndTime(timeout)), events, maxCount);
+}
+
+size_t WindowsWaitSet::dispatch(std::chrono::nanoseconds timeout)
+{
+  return dispatch(getTimeout(getEndTime(timeout)));
+}
+
 WaitResult WindowsWaitSet::waitAny(uint32_t timeout, Handle& handle)
 {
   WaitResult result;
@@ -67,12 +220,18 @@ WaitResult WindowsWaitSet::waitAny(uint32_t timeout, Handle& handle)
   if(retval >= WAIT_OBJECT_0 && retval < WAIT_OBJECT_0 + m_waitObjects->size())
   {
     handle = m_handleArray[retval - WAIT_OBJECT_0 + m_offset];
-    m_offset = (m_offset + retval - WAIT_OBJECT_0 + 1) % m_waitObjects->size();
+    findRegistration(handle)->dispatchCount++;
+
+    // Only slide the window for the round-robin policies, the others rely on array order
+    if(m_policy == WaitPolicyRoundRobin || m_policy == WaitPolicyWeighted)
+      m_offset = (m_offset + retval - WAIT_OBJECT_0 + 1) % m_waitObjects->size();
+
     result = WaitSuccess;
   }
   else if(retval >= WAIT_ABANDONED_0 && retval < WAIT_ABANDONED_0 + m_waitObjects->size())
   {
     handle = m_handleArray[retval - WAIT_ABANDONED_0 + m_offset];
+    findRegistration(handle)->dispatchCount++;
     result = WaitAbandoned;
   }
   else if(retval == WAIT_TIMEOUT)
@@ -86,6 +245,73 @@ WaitResult WindowsWaitSet::waitAny(uint32_t timeout, Handle& handle)
   return result;
 }
 
+size_t WindowsWaitSet::waitMany(uint32_t timeout, Handle* handles, WaitResult* results, size_t maxCount)
+{
+  size_t count = 0;
+
+  if(maxCount == 0)
+    throw std::invalid_argument("maxCount");
+
+  // Wait for the first handle, then collect whatever else is already signaled
+  while(count < maxCount)
+  {
+    results[count] = waitAny((count == 0) ? timeout : 0, handles[count]);
+
+    if(results[count] == WaitTimeout)
+      break;
+
+    ++count;
+  }
+
+  return count;
+}
+
+size_t WindowsWaitSet::waitMany(uint32_t timeout, WaitEvent* events, size_t maxCount)
+{
+  size_t count = 0;
+
+  if(maxCount == 0)
+    throw std::invalid_argument("maxCount");
+
+  while(count < maxCount)
+  {
+    events[count].result = waitAny((count == 0) ? timeout : 0, events[count].handle);
+
+    if(events[count].result == WaitTimeout)
+      break;
+
+    Registration* reg = m_waitObjects->find(events[count].handle)->second;
+    events[count].events = (events[count].result == WaitSuccess) ? WaitReadable : WaitHangup;
+    events[count].object = reg->object;
+    events[count].handler = reg->handler;
+    events[count].userData = reg->userData;
+    ++count;
+  }
+
+  return count;
+}
+
+size_t WindowsWaitSet::dispatch(uint32_t timeout)
+{
+  size_t count = 0;
+  WaitEvent event;
+
+  // Take events one at a time, so a handler removing an object can't be called afterwards
+  while(waitMany((count == 0) ? timeout : 0, &event, 1) == 1)
+  {
+    if(event.handler == NULL)
+      throw std::logic_error("dispatched WaitObject has no handler");
+
+    event.handler->handleWait(event);
+
+    // Only handle as many events as are in the set, or a busy handle could starve the caller
+    if(++count >= m_waitObjects->size())
+      break;
+  }
+
+  return count;
+}
+
 void WindowsWaitSet::resizeEvents()
 {
   Handle favoredHandle = INVALID_HANDLE_VALUE;
@@ -100,11 +326,18 @@ void WindowsWaitSet::resizeEvents()
   //  avoid unfairness in the wait
   m_handleArray = new Handle[m_waitObjects->size() * 2];
 
-  uint32_t j(0);
-  for(mct::closed_hash_map<Handle, WaitObject*>::const_iterator i = m_waitObjects->cbegin(); i != m_waitObjects->cend(); ++i)
+  std::vector<Registration*> registrations;
+  for(mct::closed_hash_map<Handle, Registration*>::const_iterator i = m_waitObjects->cbegin(); i != m_waitObjects->cend(); ++i)
+    registrations.push_back(i->second);
+
+  // WaitForMultipleObjects returns the first signaled handle, so higher priorities go first
+  if(m_policy == WaitPolicyPriority)
+    std::stable_sort(registrations.begin(), registrations.end(), comparePriority);
+
+  for(uint32_t j = 0; j < registrations.size(); ++j)
   {
-    m_handleArray[j + m_waitObjects->size()] = i->first;
-    m_handleArray[j++] = i->first;
+    m_handleArray[j + m_waitObjects->size()] = registrations[j]->handle;
+    m_handleArray[j] = registrations[j]->handle;
   }
 
   // Avoid resetting the unfairness protection, try to find where the new offset should be
@@ -114,6 +347,10 @@ void WindowsWaitSet::resizeEvents()
       m_offset = i;
   }
 
+  // The window only slides with the round-robin policies
+  if(m_policy == WaitPolicyInOrder || m_policy == WaitPolicyPriority)
+    m_offset = 0;
+
   // The favored handle must have been removed, just make sure the offset isn't out of bounds
   if(m_waitObjects->size() != 0)
     m_offset = m_offset % m_waitObjects->size();
@@ -0,0 +1,107 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include <iostream>
+#include <iomanip>
+#include <unistd.h>
+#include <time.h>
+
+/*
+ * Measures the cost of the basic operations on Events, Mutexes, Semaphores and
+ *  WaitSets with each of the linux backends.  Nothing is contended, so this is
+ *  the overhead of the system calls and the user space bookkeeping.
+ */
+using namespace lethe;
+
+const uint32_t numIterations(200000);
+
+static uint64_t getNanoseconds()
+{
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+static void report(const char* backend, const char* name, uint64_t startTime)
+{
+  uint64_t elapsed = getNanoseconds() - startTime;
+
+  std::cout << std::setw(8) << backend << "  " << std::setw(24) << std::left << name << std::right
+            << std::setw(8) << (elapsed / numIterations) << " ns/op" << std::endl;
+}
+
+static void runBenchmarks(const char* backend)
+{
+  uint64_t startTime;
+
+  {
+    Event event(false, true);
+    startTime = getNanoseconds();
+    for(uint32_t i(0); i < numIterations; ++i)
+    {
+      event.set();
+      WaitForObject(event, 0);
+    }
+    report(backend, "event set/wait", startTime);
+  }
+
+  {
+    Mutex mutex(false);
+    startTime = getNanoseconds();
+    for(uint32_t i(0); i < numIterations; ++i)
+    {
+      mutex.lock(0);
+      mutex.unlock();
+    }
+    report(backend, "mutex lock/unlock", startTime);
+  }
+
+  {
+    Semaphore semaphore(1, 0);
+    startTime = getNanoseconds();
+    for(uint32_t i(0); i < numIterations; ++i)
+    {
+      semaphore.unlock(1);
+      semaphore.lock(0);
+    }
+    report(backend, "semaphore unlock/lock", startTime);
+  }
+
+  {
+    Event event(false, true);
+    WaitSet waitSet;
+    Handle handle;
+    waitSet.add(event);
+    startTime = getNanoseconds();
+    for(uint32_t i(0); i < numIterations; ++i)
+    {
+      event.set();
+      waitSet.waitAny(0, handle);
+    }
+    report(backend, "waitSet set/waitAny", startTime);
+  }
+}
+
+int main()
+{
+  try
+  {
+    if(access("/dev/eventfd-lethe", R_OK | W_OK) == 0 &&
+       access("/dev/timerfd-lethe", R_OK | W_OK) == 0)
+    {
+      setLinuxBackend(LinuxBackendModules);
+      runBenchmarks("modules");
+    }
+    else
+      std::cout << "lethe kernel modules not loaded, skipping the modules backend" << std::endl;
+
+    setLinuxBackend(LinuxBackendStock);
+    runBenchmarks("stock");
+  }
+  catch(std::exception& ex)
+  {
+    std::cerr << "benchmark failed: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
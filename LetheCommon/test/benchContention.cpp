@@ -0,0 +1,156 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+/*
+ * Compares taking several contended Mutexes with WaitForAllObjects against
+ *  taking them one at a time.  Each thread takes the mutexes starting from a
+ *  different one, so locking them in that order could deadlock, and has to use
+ *  a timeout and start over when one of them is busy.
+ */
+using namespace lethe;
+
+const uint32_t numThreads(4);
+const uint32_t numMutexes(3);
+const uint32_t numIterations(20000);
+
+class ContentionThread : public Thread
+{
+public:
+  ContentionThread(Mutex** mutexes, uint32_t first, bool waitAll, uint32_t& counter) :
+    Thread(0),
+    m_waitAll(waitAll),
+    m_counter(counter),
+    m_retries(0),
+    m_maxWait(0)
+  {
+    for(uint32_t i(0); i < numMutexes; ++i)
+      m_objects[i] = mutexes[(first + i) % numMutexes];
+  }
+
+  uint32_t getRetries() const { return m_retries; }
+  uint64_t getMaxWait() const { return m_maxWait; }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    for(uint32_t i(0); i < numIterations; ++i)
+    {
+      uint64_t startTime = getMonotonicTime();
+
+      if(m_waitAll)
+      {
+        if(WaitForAllObjects(m_objects, numMutexes) != WaitSuccess)
+          throw std::runtime_error("failed to take the mutexes");
+      }
+      else
+        lockInOrder();
+
+      uint64_t waitTime = getMonotonicTime() - startTime;
+      if(waitTime > m_maxWait)
+        m_maxWait = waitTime;
+
+      // A short critical section
+      for(uint32_t j(0); j < 100; ++j)
+        ++m_counter;
+
+      for(uint32_t j(0); j < numMutexes; ++j)
+        static_cast<Mutex*>(m_objects[j])->unlock();
+    }
+
+    stop();
+  }
+
+private:
+  void lockInOrder()
+  {
+    uint32_t held(0);
+
+    while(held < numMutexes)
+    {
+      if(WaitForObject(*m_objects[held], 1) == WaitSuccess)
+      {
+        ++held;
+        continue;
+      }
+
+      // Back off and start over
+      while(held > 0)
+        static_cast<Mutex*>(m_objects[--held])->unlock();
+
+      ++m_retries;
+    }
+  }
+
+  WaitObject* m_objects[numMutexes];
+  bool m_waitAll;
+  volatile uint32_t& m_counter;
+  uint32_t m_retries;
+  uint64_t m_maxWait;
+};
+
+static void runBenchmark(const char* name, bool waitAll)
+{
+  Mutex* mutexes[numMutexes];
+  std::vector<ContentionThread*> threads;
+  uint32_t counter(0);
+  uint32_t retries(0);
+  uint64_t maxWait(0);
+
+  for(uint32_t i(0); i < numMutexes; ++i)
+    mutexes[i] = new Mutex(false);
+
+  uint64_t startTime = getMonotonicTime();
+
+  for(uint32_t i(0); i < numThreads; ++i)
+  {
+    threads.push_back(new ContentionThread(mutexes, i, waitAll, counter));
+    threads.back()->start();
+  }
+
+  for(uint32_t i(0); i < numThreads; ++i)
+  {
+    WaitForObject(*threads[i]);
+
+    if(threads[i]->getError() != "")
+      throw std::runtime_error(threads[i]->getError());
+
+    retries += threads[i]->getRetries();
+    if(threads[i]->getMaxWait() > maxWait)
+      maxWait = threads[i]->getMaxWait();
+
+    delete threads[i];
+  }
+
+  uint64_t elapsed = getMonotonicTime() - startTime;
+
+  for(uint32_t i(0); i < numMutexes; ++i)
+    delete mutexes[i];
+
+  if(counter != numThreads * numIterations * 100)
+    throw std::runtime_error("critical sections overlapped");
+
+  std::cout << std::setw(20) << std::left << name << std::right
+            << std::setw(8) << (elapsed / (numThreads * numIterations)) << " ns/op"
+            << std::setw(10) << (maxWait / 1000) << " us max wait"
+            << std::setw(8) << retries << " retries" << std::endl;
+}
+
+int main()
+{
+  try
+  {
+    runBenchmark("ordered locking", false);
+    runBenchmark("WaitForAllObjects", true);
+  }
+  catch(std::exception& ex)
+  {
+    std::cerr << "benchmark failed: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include <iostream>
+#include <iomanip>
+#include <fcntl.h>
+#include <sched.h>
+
+/*
+ * Measures the throughput of a Pipe for transfers from 64KB to 16MB, sending
+ *  with send() (copied into the pipe) or sendZeroCopy() (vmsplice), and
+ *  receiving with receive() (copied out) or spliceTo() into /dev/null.  The
+ *  zero-copy sender alternates between two buffers, waiting for one to be
+ *  released before writing into it again.
+ *
+ * The spliceTo() numbers measure splicing into /dev/null, which discards the
+ *  pages, not into a file that has to copy them, so they are an upper bound for
+ *  spliceTo().
+ */
+using namespace lethe;
+
+const uint64_t totalBytes(256 * 1024 * 1024);
+const uint32_t transferSizes[] = { 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024 };
+
+class ReceiveThread : public Thread
+{
+public:
+  ReceiveThread(Pipe& pipe, bool splice) :
+    Thread(0),
+    m_pipe(pipe),
+    m_splice(splice),
+    m_buffer(new uint8_t[transferSizes[4]]),
+    m_null(open("/dev/null", O_WRONLY)) // spliceTo() discards the data here
+  {
+    if(m_null == INVALID_HANDLE_VALUE)
+      throw std::bad_syscall("open", lastError());
+  }
+
+  ~ReceiveThread()
+  {
+    delete [] m_buffer;
+    close(m_null);
+  }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    uint64_t received(0);
+
+    while(received < totalBytes)
+    {
+      uint32_t size;
+
+      if(m_splice)
+        size = m_pipe.spliceTo(m_null, transferSizes[4]);
+      else
+        size = m_pipe.receive(m_buffer, transferSizes[4]);
+
+      if(size == 0 && WaitForObject(m_pipe, 1000) != WaitSuccess)
+        throw std::runtime_error("timed out receiving");
+
+      received += size;
+    }
+
+    stop();
+  }
+
+private:
+  Pipe& m_pipe;
+  bool m_splice;
+  uint8_t* m_buffer;
+  Handle m_null;
+};
+
+static void runBenchmark(uint32_t transferSize, bool zeroCopy, bool splice)
+{
+  uint8_t* buffers[2] = { new uint8_t[transferSize], new uint8_t[transferSize] };
+  uint64_t positions[2] = { 0, 0 };
+  Pipe pipe;
+  ReceiveThread thread(pipe, splice);
+
+  for(uint32_t i(0); i < transferSize; ++i)
+    buffers[0][i] = buffers[1][i] = static_cast<uint8_t>(i);
+
+  uint64_t startTime = getMonotonicTime();
+  thread.start();
+
+  for(uint64_t i(0); i < totalBytes / transferSize; ++i)
+  {
+    uint32_t current = i % 2;
+
+    if(zeroCopy)
+    {
+      // Change the buffer like a real sender would, once the pipe is done with it
+      while(!pipe.isReleased(positions[current]))
+        sched_yield();
+
+      buffers[current][0] = static_cast<uint8_t>(i);
+      positions[current] = pipe.sendZeroCopy(buffers[current], transferSize);
+    }
+    else
+    {
+      buffers[current][0] = static_cast<uint8_t>(i);
+      pipe.send(buffers[current], transferSize);
+    }
+
+    if(!pipe.flush(5000))
+      throw std::runtime_error("timed out sending");
+  }
+
+  WaitForObject(thread);
+  uint64_t elapsed = getMonotonicTime() - startTime;
+
+  if(thread.getError() != "")
+    throw std::runtime_error(thread.getError());
+
+  delete [] buffers[0];
+  delete [] buffers[1];
+
+  std::cout << std::setw(6) << (transferSize / 1024) << " KB"
+            << std::setw(16) << (zeroCopy ? "sendZeroCopy" : "send")
+            << std::setw(16) << (splice ? "spliceTo null" : "receive")
+            << std::setw(10) << (totalBytes * 1000 / elapsed) << " MB/s" << std::endl;
+}
+
+int main()
+{
+  try
+  {
+    for(uint32_t i(0); i < sizeof(transferSizes) / sizeof(transferSizes[0]); ++i)
+    {
+      runBenchmark(transferSizes[i], false, false);
+      runBenchmark(transferSizes[i], true, false);
+      runBenchmark(transferSizes[i], false, true);
+      runBenchmark(transferSizes[i], true, true);
+    }
+  }
+  catch(std::exception& ex)
+  {
+    std::cerr << "benchmark failed: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,135 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include "testCommon.h"
+#include "catch/catch.hpp"
+
+using namespace lethe;
+
+#if defined(__linux__)
+TEST_CASE("barrier/phase", "Test arriving at a barrier from one thread")
+{
+  REQUIRE_THROWS_AS(Barrier(0), std::invalid_argument);
+  REQUIRE_THROWS_AS(Barrier(Barrier::s_maxCount + 1), std::invalid_argument);
+
+  Barrier barrier(3);
+  REQUIRE(barrier.getCount() == 3);
+  REQUIRE(barrier.getPhase() == 0);
+
+  // The last arrival completes the phase
+  REQUIRE(barrier.arrive() == 0);
+  REQUIRE(barrier.arrive() == 0);
+  REQUIRE(WaitForObject(barrier, 0) == WaitTimeout);
+  REQUIRE(barrier.arriveAndWait(0) == WaitSuccess);
+  REQUIRE(barrier.getPhase() == 1);
+
+  // An arrival that times out is taken back
+  REQUIRE(barrier.arrive() == 1);
+  REQUIRE(barrier.arriveAndWait(20) == WaitTimeout);
+  REQUIRE(barrier.arrive() == 1);
+  REQUIRE(barrier.getPhase() == 1);
+  REQUIRE(barrier.arrive() == 1);
+  REQUIRE(barrier.getPhase() == 2);
+}
+
+TEST_CASE("barrier/waitSet", "Test being told of completed phases through a WaitSet")
+{
+  Barrier barrier(2);
+  WaitSet waitSet;
+  Handle handle;
+
+  REQUIRE(waitSet.add(barrier));
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+
+  // Each completion is returned once
+  for(uint32_t i(0); i < 3; ++i)
+  {
+    barrier.arrive();
+    REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+    barrier.arrive();
+    REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+    REQUIRE(handle == barrier.getHandle());
+    REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  }
+}
+
+class BarrierTestThread : public Thread
+{
+public:
+  BarrierTestThread(Barrier& barrier) :
+    Thread(0),
+    m_barrier(barrier)
+  {
+    // Do nothing
+  }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    for(uint32_t i(0); i < 100; ++i)
+    {
+      if(m_barrier.arriveAndWait(2000) != WaitSuccess)
+        throw std::runtime_error("barrier timed out");
+    }
+
+    stop();
+  };
+
+private:
+  Barrier& m_barrier;
+};
+
+TEST_CASE("barrier/threads", "Test several threads going through the phases together")
+{
+  const uint32_t threadCount(4);
+  BarrierTestThread* threadArray[threadCount];
+  Barrier barrier(threadCount);
+
+  for(uint32_t i(0); i < threadCount; ++i)
+  {
+    threadArray[i] = new BarrierTestThread(barrier);
+    threadArray[i]->start();
+  }
+
+  for(uint32_t i(0); i < threadCount; ++i)
+  {
+    REQUIRE(WaitForObject(*threadArray[i], 5000) == WaitSuccess);
+    REQUIRE(threadArray[i]->getError() == "");
+    delete threadArray[i];
+  }
+
+  REQUIRE(barrier.getPhase() == 100);
+}
+
+TEST_CASE("latch/countDown", "Test counting down a latch")
+{
+  Latch latch(3);
+  WaitSet waitSet;
+  Handle handle;
+
+  REQUIRE(latch.getCount() == 3);
+  REQUIRE(waitSet.add(latch));
+  REQUIRE(WaitForObject(latch, 0) == WaitTimeout);
+
+  latch.countDown();
+  REQUIRE(latch.getCount() == 2);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  REQUIRE_THROWS_AS(latch.countDown(3), std::logic_error);
+
+  // The latch stays triggered once it reaches zero
+  latch.countDown(2);
+  REQUIRE(latch.getCount() == 0);
+  REQUIRE(WaitForObject(latch, 0) == WaitSuccess);
+  REQUIRE(waitSet.waitAny(0, handle) == WaitSuccess);
+  REQUIRE(handle == latch.getHandle());
+  REQUIRE(waitSet.waitAny(0, handle) == WaitSuccess);
+  REQUIRE_THROWS_AS(latch.countDown(), std::logic_error);
+
+  // A latch added at zero is triggered
+  Latch done(0);
+  WaitSet doneSet;
+  REQUIRE(doneSet.add(done));
+  REQUIRE(doneSet.waitAny(0, handle) == WaitSuccess);
+  REQUIRE(handle == done.getHandle());
+}
+#endif
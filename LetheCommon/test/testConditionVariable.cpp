@@ -0,0 +1,131 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include "testCommon.h"
+#include "catch/catch.hpp"
+
+using namespace lethe;
+
+#if defined(__linux__)
+TEST_CASE("conditionVariable/timeout", "Test waiting without a signal")
+{
+  ConditionVariable condition;
+  Mutex mutex(true);
+  FastMutex fastMutex(true);
+
+  // Nobody is waiting, these do nothing
+  condition.signal();
+  condition.broadcast();
+
+  REQUIRE(condition.wait(mutex, 20) == WaitTimeout);
+  REQUIRE(condition.wait(fastMutex, std::chrono::milliseconds(20)) == WaitTimeout);
+
+  // The mutexes are locked again
+  mutex.unlock();
+  fastMutex.unlock();
+
+  // The mutex must be held to wait
+  REQUIRE_THROWS_AS(condition.wait(mutex, 20), std::bad_syscall);
+  REQUIRE_THROWS_AS(condition.wait(fastMutex, 20), std::bad_syscall);
+}
+
+TEST_CASE("conditionVariable/recursive", "Test waiting with a mutex locked more than once")
+{
+  ConditionVariable condition;
+  Mutex piMutex(true, MutexPriorityInheritance);
+  FastMutex fastMutex(true);
+
+  // The wait could only release one of the locks, so it is refused
+  piMutex.lock();
+  fastMutex.lock();
+  REQUIRE_THROWS_AS(condition.wait(piMutex, 20), std::logic_error);
+  REQUIRE_THROWS_AS(condition.wait(fastMutex, 20), std::logic_error);
+
+  // Both locks are still held, and a single lock may be used again
+  piMutex.unlock();
+  fastMutex.unlock();
+  REQUIRE(condition.wait(piMutex, 20) == WaitTimeout);
+  REQUIRE(condition.wait(fastMutex, 20) == WaitTimeout);
+  piMutex.unlock();
+  fastMutex.unlock();
+}
+
+class ConditionTestThread : public Thread
+{
+public:
+  ConditionTestThread(ConditionVariable& condition, FastMutex& mutex, uint32_t& value) :
+    Thread(0),
+    m_condition(condition),
+    m_mutex(mutex),
+    m_value(value)
+  {
+    // Do nothing
+  }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    m_mutex.lock();
+    ++m_value;
+
+    // Wait for the main thread to change the value
+    while(m_value != 0)
+    {
+      if(m_condition.wait(m_mutex, 2000) == WaitTimeout)
+      {
+        m_mutex.unlock();
+        throw std::runtime_error("condition variable timed out");
+      }
+    }
+
+    m_mutex.unlock();
+    stop();
+  };
+
+private:
+  ConditionVariable& m_condition;
+  FastMutex& m_mutex;
+  uint32_t& m_value;
+};
+
+TEST_CASE("conditionVariable/broadcast", "Test waking several threads")
+{
+  const uint32_t threadCount(4);
+  ConditionTestThread* threadArray[threadCount];
+  ConditionVariable condition;
+  FastMutex mutex(false);
+  uint32_t value(0);
+
+  for(uint32_t i(0); i < threadCount; ++i)
+  {
+    threadArray[i] = new ConditionTestThread(condition, mutex, value);
+    threadArray[i]->start();
+  }
+
+  // Wait for every thread to be waiting
+  for(uint32_t i(0); i < 200; ++i)
+  {
+    mutex.lock();
+    bool ready = (value == threadCount);
+    mutex.unlock();
+
+    if(ready)
+      break;
+
+    sleep_ms(10);
+  }
+
+  mutex.lock();
+  REQUIRE(value == threadCount);
+  value = 0;
+  condition.broadcast();
+  mutex.unlock();
+
+  for(uint32_t i(0); i < threadCount; ++i)
+  {
+    REQUIRE(WaitForObject(*threadArray[i], 2000) == WaitSuccess);
+    REQUIRE(threadArray[i]->getError() == "");
+    delete threadArray[i];
+  }
+}
+#endif
@@ -133,3 +133,43 @@ TEST_CASE("event/autoreset", "Test auto-reset of events")
   REQUIRE(WaitForObject(event2, 0) == WaitSuccess);
   REQUIRE(WaitForObject(event2, 20) == WaitTimeout);
 }
+
+TEST_CASE("event/fast", "Test FastEvents before and after being added to a WaitSet")
+{
+  FastEvent event1(false, true);
+  FastEvent event2(true, false);
+
+#if defined(__linux__)
+  // No handle is created until the event is added to a WaitSet
+  REQUIRE(event1.getHandle() == INVALID_HANDLE_VALUE);
+#endif
+
+  REQUIRE(WaitForObject(event1, 20) == WaitTimeout);
+  event1.set();
+  event1.set();
+  REQUIRE(WaitForObject(event1, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(event1, 20) == WaitTimeout);
+
+  REQUIRE(WaitForObject(event2, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(event2, 0) == WaitSuccess);
+  event2.reset();
+  REQUIRE(WaitForObject(event2, 20) == WaitTimeout);
+  event2.set();
+
+  // The state carries over to the handle
+  WaitSet waitSet;
+  Handle handle;
+  REQUIRE(waitSet.add(event1));
+  REQUIRE(waitSet.add(event2));
+  REQUIRE(event1.getHandle() != INVALID_HANDLE_VALUE);
+
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(handle == event2.getHandle());
+  event2.reset();
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+
+  event1.set();
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(handle == event1.getHandle());
+  REQUIRE(WaitForObject(event1, 20) == WaitTimeout);
+}
@@ -0,0 +1,153 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include "testCommon.h"
+#include "catch/catch.hpp"
+
+using namespace lethe;
+
+#if defined(__linux__)
+TEST_CASE("eventGroup/bits", "Test setting, clearing and waiting on bits from one thread")
+{
+  EventGroup group(0x1);
+  REQUIRE(group.getBits() == 0x1);
+
+  group.set(0x8000000000000006ULL);
+  REQUIRE(group.getBits() == 0x8000000000000007ULL);
+  group.clear(0x8000000000000001ULL);
+  REQUIRE(group.getBits() == 0x6);
+
+  REQUIRE_THROWS_AS(group.waitAny(0, 0), std::invalid_argument);
+
+  // Any returns the bits of the mask that are set
+  REQUIRE(group.waitAny(0x9, 0) == 0);
+  REQUIRE(group.waitAny(0xF, 0) == 0x6);
+  REQUIRE(group.waitAny(0xF, std::chrono::nanoseconds(0)) == 0x6);
+
+  // All needs every bit of the mask
+  REQUIRE(group.waitAll(0xE, 20) == 0);
+  REQUIRE(group.waitAll(0x6, 0) == 0x6);
+
+  // Clearing takes the bits that fired, and only those
+  group.set(0x10);
+  REQUIRE(group.waitAny(0x3, 0, true) == 0x2);
+  REQUIRE(group.getBits() == 0x14);
+  REQUIRE(group.waitAll(0x14, 0, true) == 0x14);
+  REQUIRE(group.getBits() == 0);
+  REQUIRE(group.waitAny(0x14, 0, true) == 0);
+}
+
+TEST_CASE("eventGroup/waitSet", "Test being told which bits fired through a WaitSet")
+{
+  EventGroup group;
+  WaitSet waitSet;
+  Handle handle;
+
+  REQUIRE_THROWS_AS(group.setWaitMask(0), std::invalid_argument);
+  REQUIRE(waitSet.add(group));
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+
+  // By default any bit triggers the group, and stays set
+  group.set(0x5);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(handle == group.getHandle());
+  REQUIRE(group.getFiredBits() == 0x5);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  group.clear(0x5);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+
+  // Wait for all of two bits, taking them
+  group.setWaitMask(0x30, true, true);
+  group.set(0x10);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  REQUIRE(WaitForObject(group, 0) == WaitTimeout);
+  group.set(0x21);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(group.getFiredBits() == 0x30);
+  REQUIRE(group.getBits() == 0x1);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+
+  // Bits cleared before the wait don't trigger it
+  group.set(0x30);
+  group.clear(0x10);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+
+  // Bits set before the group is added to a WaitSet trigger it
+  EventGroup early(0x2);
+  WaitSet earlySet;
+  REQUIRE(earlySet.add(early));
+  REQUIRE(earlySet.waitAny(0, handle) == WaitSuccess);
+  REQUIRE(handle == early.getHandle());
+  REQUIRE(early.getFiredBits() == 0x2);
+}
+
+class EventGroupTestThread : public Thread
+{
+public:
+  EventGroupTestThread(EventGroup& group, uint64_t bit) :
+    Thread(0),
+    m_group(group),
+    m_bit(bit)
+  {
+    // Do nothing
+  }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    // Each thread sets its bit once the previous one has been taken
+    for(uint32_t i(0); i < 100; ++i)
+    {
+      while(m_group.getBits() & m_bit)
+        sleep_ms(0);
+
+      m_group.set(m_bit);
+    }
+
+    stop();
+  };
+
+private:
+  EventGroup& m_group;
+  uint64_t m_bit;
+};
+
+TEST_CASE("eventGroup/threads", "Test taking bits set by several threads")
+{
+  const uint32_t threadCount(4);
+  EventGroupTestThread* threadArray[threadCount];
+  uint32_t counts[threadCount] = { };
+  EventGroup group;
+
+  for(uint32_t i(0); i < threadCount; ++i)
+  {
+    threadArray[i] = new EventGroupTestThread(group, 1ULL << (i * 16));
+    threadArray[i]->start();
+  }
+
+  for(uint32_t total(0); total < threadCount * 100;)
+  {
+    uint64_t fired = group.waitAny(UINT64_MAX, 2000, true);
+    REQUIRE(fired != 0);
+
+    for(uint32_t i(0); i < threadCount; ++i)
+    {
+      if(fired & (1ULL << (i * 16)))
+      {
+        ++counts[i];
+        ++total;
+      }
+    }
+  }
+
+  for(uint32_t i(0); i < threadCount; ++i)
+  {
+    REQUIRE(WaitForObject(*threadArray[i], 5000) == WaitSuccess);
+    REQUIRE(threadArray[i]->getError() == "");
+    REQUIRE(counts[i] == 100);
+    delete threadArray[i];
+  }
+
+  REQUIRE(group.getBits() == 0);
+}
+#endif
@@ -27,6 +27,46 @@ TEST_CASE("functions/sleep", "Test the sleep function")
   REQUIRE(getTime() - startTime <= 1035);
 }
 
+TEST_CASE("functions/sleepDuration", "Test sleeping for sub-millisecond durations")
+{
+  // The monotonic clock should allow sleeps much shorter than a millisecond, but
+  //  scheduling latency can still add a few ms
+  uint64_t startTime;
+
+  startTime = getMonotonicTime();
+  sleep_ms(std::chrono::microseconds(200));
+  REQUIRE(getMonotonicTime() - startTime >= 200000);
+  REQUIRE(getMonotonicTime() - startTime <= 5000000);
+
+  startTime = getMonotonicTime();
+  sleep_ms(std::chrono::nanoseconds(0));
+  REQUIRE(getMonotonicTime() - startTime <= 5000000);
+}
+
+TEST_CASE("functions/endTime", "Test converting timeouts to end times and back")
+{
+  REQUIRE(getEndTime(INFINITE) == INFINITE_END_TIME);
+  REQUIRE(getEndTime(std::chrono::nanoseconds::max()) == INFINITE_END_TIME);
+  REQUIRE(getTimeout(INFINITE_END_TIME) == INFINITE);
+  REQUIRE(getTimeoutNs(INFINITE_END_TIME) == INFINITE_END_TIME);
+
+  // Partial milliseconds are rounded up, so a wait never ends early
+  REQUIRE(getTimeout(getEndTime(std::chrono::microseconds(100))) == 1);
+  REQUIRE(getTimeout(getEndTime(std::chrono::seconds(10))) <= 10000);
+  REQUIRE(getTimeout(getEndTime(std::chrono::seconds(10))) > 9000);
+  REQUIRE(getTimeoutNs(getEndTime(std::chrono::milliseconds(-5))) == 0);
+
+  // Waits end after the duration
+  Event event(false, false);
+  uint64_t startTime = getMonotonicTime();
+  REQUIRE(WaitForObject(event, std::chrono::microseconds(300)) == WaitTimeout);
+  REQUIRE(getMonotonicTime() - startTime >= 300000);
+  REQUIRE(WaitForObject(event.getHandle(), std::chrono::microseconds(0)) == WaitTimeout);
+
+  event.set();
+  REQUIRE(WaitForObject(event, std::chrono::nanoseconds::max()) == WaitSuccess);
+}
+
 TEST_CASE("functions/getTimeString", "Test getting the current time in string form")
 {
   // TODO: implement functions/getTimeString
@@ -160,3 +200,174 @@ TEST_CASE("functions/wait", "Test waiting for single WaitObjects")
   REQUIRE(WaitForObject(timer, 20) == WaitTimeout);
   REQUIRE(WaitForObject(timer, 20) == WaitTimeout);
 }
+
+TEST_CASE("functions/waitAll", "Test taking several objects together")
+{
+  Semaphore sem1(1, 1);
+  Semaphore sem2(1, 0);
+  Mutex mutex(false);
+  FastMutex fastMutex(false);
+  FastSemaphore fastSem(2, 2);
+  WaitObject* objects[] = { &sem1, &sem2, &mutex, &fastMutex, &fastSem };
+
+  // Nothing is taken unless everything is
+  REQUIRE(WaitForAllObjects(objects, 5, 20) == WaitTimeout);
+  REQUIRE(WaitForAllObjects(objects, 5, std::chrono::nanoseconds(1000000)) == WaitTimeout);
+  REQUIRE(WaitForObject(sem1, 0) == WaitSuccess);
+  sem1.unlock(1);
+  REQUIRE(WaitForObject(fastSem, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(fastSem, 0) == WaitSuccess);
+  fastSem.unlock(2);
+
+  sem2.unlock(1);
+  REQUIRE(WaitForAllObjects(objects, 5, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(sem1, 0) == WaitTimeout);
+  REQUIRE(WaitForObject(sem2, 0) == WaitTimeout);
+  mutex.unlock();
+  fastMutex.unlock();
+  sem1.unlock(1);
+  sem2.unlock(1);
+
+  // The semaphores are full again, so only one more set can be taken
+  REQUIRE(WaitForAllObjects(objects, 5, 0) == WaitSuccess);
+  REQUIRE(WaitForAllObjects(objects, 2, 20) == WaitTimeout);
+
+  #if defined(__linux__)
+  // Objects whose wait can't be given back aren't accepted
+  Event event(true, true);
+  WaitObject* badObjects[] = { &sem1, &event };
+  REQUIRE_THROWS_AS(WaitForAllObjects(badObjects, 2, 0), std::invalid_argument);
+  REQUIRE(WaitForObject(event, 0) == WaitSuccess);
+  #endif
+
+  WaitObject* duplicates[] = { &mutex, &mutex };
+  REQUIRE_THROWS_AS(WaitForAllObjects(duplicates, 2, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(WaitForAllObjects(objects, 0, 0), std::invalid_argument);
+}
+
+class WaitAllTestThread : public Thread
+{
+public:
+  WaitAllTestThread(WaitObject** objects, uint32_t count, uint32_t& counter) :
+    Thread(0),
+    m_objects(objects),
+    m_count(count),
+    m_counter(counter)
+  {
+    // Do nothing
+  }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    for(uint32_t i(0); i < 200; ++i)
+    {
+      if(WaitForAllObjects(m_objects, m_count, 5000) != WaitSuccess)
+        throw std::runtime_error("failed to take all objects");
+
+      ++m_counter;
+
+      for(uint32_t j(0); j < m_count; ++j)
+      {
+        if(Mutex* mutex = dynamic_cast<Mutex*>(m_objects[j]))
+          mutex->unlock();
+        else
+          dynamic_cast<Semaphore*>(m_objects[j])->unlock(1);
+      }
+    }
+
+    stop();
+  };
+
+private:
+  WaitObject** m_objects;
+  uint32_t m_count;
+  uint32_t& m_counter;
+};
+
+TEST_CASE("functions/waitAllThreads", "Test threads taking overlapping sets of objects in different orders")
+{
+  Mutex mutex1(false);
+  Mutex mutex2(false);
+  Semaphore sem(1, 1);
+  uint32_t counter(0);
+
+  // Taking these in order with timeouts could deadlock or livelock
+  WaitObject* objects1[] = { &mutex1, &mutex2, &sem };
+  WaitObject* objects2[] = { &sem, &mutex2, &mutex1 };
+  WaitObject* objects3[] = { &mutex2, &sem };
+  WaitAllTestThread thread1(objects1, 3, counter);
+  WaitAllTestThread thread2(objects2, 3, counter);
+  WaitAllTestThread thread3(objects3, 2, counter);
+
+  thread1.start();
+  thread2.start();
+  thread3.start();
+
+  REQUIRE(WaitForObject(thread1, 20000) == WaitSuccess);
+  REQUIRE(WaitForObject(thread2, 20000) == WaitSuccess);
+  REQUIRE(WaitForObject(thread3, 20000) == WaitSuccess);
+  REQUIRE(thread1.getError() == "");
+  REQUIRE(thread2.getError() == "");
+  REQUIRE(thread3.getError() == "");
+
+  // Every thread held the semaphore, so the counter was never raced
+  REQUIRE(counter == 600);
+}
+
+#if defined(__linux__)
+TEST_CASE("functions/linuxBackend", "Test objects created without the lethe kernel modules")
+{
+  LinuxBackend backend = getLinuxBackend();
+  setLinuxBackend(LinuxBackendStock);
+  REQUIRE(getLinuxBackend() == LinuxBackendStock);
+
+  WaitSet waitSet;
+  Handle handle;
+
+  // Only one of two waiters gets an auto-reset event
+  Event event(false, true);
+  WaitSet otherWaitSet;
+  REQUIRE(waitSet.add(event));
+  REQUIRE(otherWaitSet.add(event));
+
+  event.set();
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(otherWaitSet.waitAny(20, handle) == WaitTimeout);
+  REQUIRE(WaitForObject(event, 0) == WaitTimeout);
+
+  // The owner may lock a mutex again, and must unlock it as many times
+  Mutex mutex(true);
+  mutex.lock(0);
+  mutex.unlock();
+  mutex.unlock();
+  REQUIRE_THROWS_AS(mutex.unlock(), std::bad_syscall);
+  REQUIRE(waitSet.add(mutex));
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(handle == mutex.getHandle());
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  mutex.unlock();
+  REQUIRE(waitSet.remove(mutex));
+
+  // The maximum count of a semaphore is enforced
+  Semaphore semaphore(2, 1);
+  REQUIRE_THROWS_AS(semaphore.unlock(2), std::bad_syscall);
+  semaphore.unlock(1);
+  REQUIRE(WaitForObject(semaphore, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(semaphore, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(semaphore, 20) == WaitTimeout);
+
+  // An auto-reset timer is reset by the wait
+  Timer timer(1, false, true);
+  REQUIRE(WaitForObject(timer, 100) == WaitSuccess);
+  REQUIRE(WaitForObject(timer, 20) == WaitTimeout);
+
+  // Errors are reported on the next wait
+  event.error();
+  REQUIRE(WaitForObject(event, 0) == WaitAbandoned);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitError);
+  REQUIRE(handle == event.getHandle());
+
+  setLinuxBackend(backend);
+}
+#endif
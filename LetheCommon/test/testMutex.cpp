@@ -266,3 +266,175 @@ TEST_CASE("mutex/multilock", "Test multilock behavior")
 {
   // TODO: test mutex/multilock
 }
+
+TEST_CASE("mutex/fast", "Test FastMutexes before and after being added to a WaitSet")
+{
+  FastMutex mutex(true);
+
+#if defined(__linux__)
+  // No handle is created until the mutex is added to a WaitSet
+  REQUIRE(mutex.getHandle() == INVALID_HANDLE_VALUE);
+#endif
+
+  mutex.lock();
+  REQUIRE(WaitForObject(mutex, 0) == WaitSuccess);
+  mutex.unlock();
+  mutex.unlock();
+  mutex.unlock();
+  REQUIRE_THROWS_AS(mutex.unlock(), std::bad_syscall);
+
+  // The locks held by this thread carry over to the handle
+  mutex.lock();
+  mutex.lock();
+
+  WaitSet waitSet;
+  REQUIRE(waitSet.add(mutex));
+  REQUIRE(mutex.getHandle() != INVALID_HANDLE_VALUE);
+
+  mutex.unlock();
+  mutex.unlock();
+  REQUIRE_THROWS_AS(mutex.unlock(), std::bad_syscall);
+}
+
+#if defined(__linux__)
+struct InversionTest
+{
+  Mutex* mutex;
+  Event* locked;
+  uint64_t holdTime; // How long the low priority thread holds the mutex
+  uint64_t hogTime; // How long the medium priority thread keeps the CPU
+};
+
+static void spinFor(uint64_t duration)
+{
+  uint64_t endTime = getMonotonicTime() + duration;
+
+  while(getMonotonicTime() < endTime)
+  {
+    // Do nothing
+  }
+}
+
+static void* lowPriorityThread(void* arg)
+{
+  InversionTest* test = static_cast<InversionTest*>(arg);
+  test->mutex->lock();
+  test->locked->set();
+  spinFor(test->holdTime);
+  test->mutex->unlock();
+  return NULL;
+}
+
+static void* mediumPriorityThread(void* arg)
+{
+  spinFor(static_cast<InversionTest*>(arg)->hogTime);
+  return NULL;
+}
+
+// All the threads run on the same CPU, so the medium thread can starve the low one
+static bool startFifoThread(pthread_t& thread, int priority, void* (*function)(void*), void* arg)
+{
+  pthread_attr_t attributes;
+  sched_param param;
+  cpu_set_t cpus;
+
+  CPU_ZERO(&cpus);
+  CPU_SET(0, &cpus);
+  param.sched_priority = priority;
+
+  pthread_attr_init(&attributes);
+  pthread_attr_setinheritsched(&attributes, PTHREAD_EXPLICIT_SCHED);
+  pthread_attr_setschedpolicy(&attributes, SCHED_FIFO);
+  pthread_attr_setschedparam(&attributes, &param);
+  pthread_attr_setaffinity_np(&attributes, sizeof(cpus), &cpus);
+
+  bool result = (pthread_create(&thread, &attributes, function, arg) == 0);
+  pthread_attr_destroy(&attributes);
+  return result;
+}
+
+static void* timeoutThread(void* arg)
+{
+  Mutex* mutex = static_cast<Mutex*>(arg);
+
+  if(WaitForObject(*mutex, 20) != WaitTimeout ||
+     WaitForObject(*mutex, 2000) != WaitSuccess)
+    return NULL;
+
+  mutex->unlock();
+  return mutex;
+}
+
+TEST_CASE("mutex/priorityInheritance", "Test mutexes using priority inheritance")
+{
+  Mutex mutex(true, MutexPriorityInheritance);
+  REQUIRE(mutex.getProtocol() == MutexPriorityInheritance);
+  REQUIRE(mutex.getHandle() == INVALID_HANDLE_VALUE);
+
+  // The same API as other mutexes, but no handle
+  mutex.lock(0);
+  REQUIRE(WaitForObject(mutex, 0) == WaitSuccess);
+  mutex.unlock();
+  mutex.unlock();
+  mutex.unlock();
+  REQUIRE_THROWS_AS(mutex.unlock(), std::bad_syscall);
+
+  WaitSet waitSet;
+  REQUIRE_THROWS_AS(waitSet.add(mutex), std::logic_error);
+  REQUIRE_THROWS_AS(mutex.error(), std::logic_error);
+
+  // Another thread times out, then gets the mutex once it is unlocked
+  pthread_t thread;
+  void* threadResult;
+  mutex.lock();
+  REQUIRE(pthread_create(&thread, NULL, timeoutThread, &mutex) == 0);
+  sleep_ms(100);
+  mutex.unlock();
+  REQUIRE(pthread_join(thread, &threadResult) == 0);
+  REQUIRE(threadResult == static_cast<void*>(&mutex));
+
+  // Priority inversion: the owner has low priority, and a medium priority thread
+  //  wants the CPU for longer than the owner needs the mutex.  This thread has
+  //  high priority, and should only wait for the owner.  Real-time priorities
+  //  need privileges, so this part is skipped without them.
+  int oldPolicy;
+  sched_param oldParam;
+  sched_param param;
+  cpu_set_t oldCpus;
+  cpu_set_t cpus;
+
+  CPU_ZERO(&cpus);
+  CPU_SET(0, &cpus);
+  param.sched_priority = 30;
+  pthread_getschedparam(pthread_self(), &oldPolicy, &oldParam);
+  pthread_getaffinity_np(pthread_self(), sizeof(oldCpus), &oldCpus);
+
+  if(pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0 &&
+     pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0)
+  {
+    Mutex piMutex(false, MutexPriorityInheritance);
+    Event locked(false, true);
+    InversionTest test = { &piMutex, &locked, 20000000, 400000000 };
+    pthread_t lowThread;
+    pthread_t mediumThread;
+
+    REQUIRE(startFifoThread(lowThread, 10, lowPriorityThread, &test));
+    REQUIRE(WaitForObject(locked, 2000) == WaitSuccess);
+    REQUIRE(startFifoThread(mediumThread, 20, mediumPriorityThread, &test));
+
+    uint64_t startTime = getMonotonicTime();
+    piMutex.lock();
+    uint64_t waitTime = getMonotonicTime() - startTime;
+    piMutex.unlock();
+
+    pthread_setschedparam(pthread_self(), oldPolicy, &oldParam);
+    pthread_join(lowThread, NULL);
+    pthread_join(mediumThread, NULL);
+
+    REQUIRE(waitTime < test.hogTime / 2);
+  }
+
+  pthread_setschedparam(pthread_self(), oldPolicy, &oldParam);
+  pthread_setaffinity_np(pthread_self(), sizeof(oldCpus), &oldCpus);
+}
+#endif
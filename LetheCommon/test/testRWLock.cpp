@@ -0,0 +1,137 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include "testCommon.h"
+#include "catch/catch.hpp"
+
+using namespace lethe;
+
+#if defined(__linux__)
+TEST_CASE("rwlock/exclusion", "Test readers and writers excluding each other")
+{
+  RWLock lock;
+  WaitObject& shared = lock.getSharedObject();
+
+  REQUIRE(lock.getPolicy() == RWLockFair);
+
+  // Any number of readers, but no writer
+  REQUIRE(WaitForObject(shared, 0) == WaitSuccess);
+  lock.lockShared(0);
+  REQUIRE(WaitForObject(lock, 0) == WaitTimeout);
+  REQUIRE_THROWS_AS(lock.lock(20), std::runtime_error);
+  lock.unlockShared();
+  REQUIRE(WaitForObject(lock, 0) == WaitTimeout);
+  lock.unlockShared();
+  REQUIRE_THROWS_AS(lock.unlockShared(), std::bad_syscall);
+
+  // One writer, and no readers
+  REQUIRE(WaitForObject(lock, 0) == WaitSuccess);
+  REQUIRE_THROWS_AS(lock.unlockShared(), std::bad_syscall);
+
+  // The lock is not recursive
+  REQUIRE_THROWS_AS(lock.lock(0), std::logic_error);
+  REQUIRE_THROWS_AS(WaitForObject(shared, 20), std::logic_error);
+  lock.unlock();
+  REQUIRE_THROWS_AS(lock.unlock(), std::bad_syscall);
+
+  lock.lock(0);
+  lock.unlock();
+}
+
+TEST_CASE("rwlock/waitSet", "Test locking through a WaitSet")
+{
+  RWLock lock;
+  WaitSet waitSet;
+  Handle handle;
+
+  REQUIRE(waitSet.add(lock));
+  REQUIRE(lock.getHandle() != INVALID_HANDLE_VALUE);
+
+  // The WaitSet locks it for writing
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(handle == lock.getHandle());
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  lock.unlock();
+
+  // Readers through the WaitSet keep the writer out
+  lock.lockShared(0);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  REQUIRE(waitSet.remove(lock));
+
+  REQUIRE(waitSet.add(lock.getSharedObject()));
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(handle == lock.getSharedObject().getHandle());
+  REQUIRE(WaitForObject(lock, 0) == WaitTimeout);
+  lock.unlockShared();
+  lock.unlockShared();
+
+  // The reader is woken when the writer unlocks
+  lock.lock(0);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  lock.unlock();
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  lock.unlockShared();
+}
+
+class RWLockWriterThread : public Thread
+{
+public:
+  RWLockWriterThread(RWLock& lock) :
+    Thread(0),
+    m_lock(lock)
+  {
+    // Do nothing
+  }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    m_lock.lock(2000);
+    m_lock.unlock();
+    stop();
+  };
+
+private:
+  RWLock& m_lock;
+};
+
+// Waits for the writer to block, then returns whether a new reader could get in
+bool readerPassesWriter(RWLock& lock)
+{
+  RWLockWriterThread thread(lock);
+  bool passed(false);
+
+  lock.lockShared(0);
+  thread.start();
+
+  // The writer can't be seen waiting, so give it time
+  sleep_ms(50);
+
+  if(WaitForObject(lock.getSharedObject(), 0) == WaitSuccess)
+  {
+    passed = true;
+    lock.unlockShared();
+  }
+
+  lock.unlockShared();
+  REQUIRE(WaitForObject(thread, 2000) == WaitSuccess);
+  REQUIRE(thread.getError() == "");
+  return passed;
+}
+
+TEST_CASE("rwlock/policy", "Test readers arriving while a writer waits")
+{
+  RWLock preferReaders(RWLockPreferReaders);
+  RWLock preferWriters(RWLockPreferWriters);
+  RWLock fair(RWLockFair);
+
+  REQUIRE(readerPassesWriter(preferReaders));
+  REQUIRE(!readerPassesWriter(preferWriters));
+  REQUIRE(!readerPassesWriter(fair));
+
+  // All the writers got in
+  preferReaders.lock(0);
+  preferWriters.lock(0);
+  fair.lock(0);
+}
+#endif
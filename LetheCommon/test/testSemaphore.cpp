@@ -1,5 +1,6 @@
 #include "Lethe.h"
 #include "LetheException.h"
+#include "LetheInternal.h"
 #include "testCommon.h"
 #include "catch/catch.hpp"
 
@@ -189,3 +190,192 @@ TEST_CASE("semaphore/waitSet", "Test semaphore using waitSets")
   REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
 }
 
+
+TEST_CASE("semaphore/fast", "Test FastSemaphores before and after being added to a WaitSet")
+{
+  FastSemaphore sem(10, 5);
+
+#if defined(__linux__)
+  // No handle is created until the semaphore is added to a WaitSet
+  REQUIRE(sem.getHandle() == INVALID_HANDLE_VALUE);
+#endif
+
+  REQUIRE_THROWS_AS(sem.unlock(6), std::bad_syscall);
+  sem.unlock(3);
+  for(uint32_t i = 0; i < 8; ++i)
+    REQUIRE(WaitForObject(sem, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(sem, 20) == WaitTimeout);
+  sem.unlock(2);
+
+  // The count carries over to the handle
+  WaitSet waitSet;
+  Handle handle;
+  REQUIRE(waitSet.add(sem));
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(handle == sem.getHandle());
+  sem.lock(0);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  REQUIRE_THROWS_AS(sem.unlock(11), std::bad_syscall);
+  sem.unlock(10);
+}
+
+#if defined(__linux__)
+TEST_CASE("semaphore/spin", "Test the spin budget used before blocking on a semaphore")
+{
+  LinuxAdaptiveSpin spin;
+  bool multiprocessor = (sysconf(_SC_NPROCESSORS_ONLN) > 1);
+
+  REQUIRE(spin.getLimit() == LinuxAdaptiveSpin::getDefaultLimit());
+  spin.setLimit(50);
+
+  if(multiprocessor)
+  {
+    // The budget starts at the minimum, and grows to twice the spins that succeed
+    REQUIRE(spin.getSpinCount() == 10);
+
+    for(uint32_t i(0); i < 100; ++i)
+      spin.record(true, 30);
+
+    REQUIRE(spin.getSpinCount() == 50);
+
+    // Spins that fail bring it back down
+    for(uint32_t i(0); i < 20; ++i)
+      spin.record(false, 50);
+
+    REQUIRE(spin.getSpinCount() == 10);
+    REQUIRE(spin.getSuccessCount() == 100);
+    REQUIRE(spin.getFailureCount() == 20);
+  }
+  else
+    REQUIRE(spin.getSpinCount() == 0);
+
+  spin.setLimit(0);
+  REQUIRE(spin.getSpinCount() == 0);
+
+  // Waiting on an empty semaphore spins first, a wait without a timeout does not
+  Semaphore semaphore(1, 0);
+  FastSemaphore fastSemaphore(1, 0);
+
+  REQUIRE(WaitForObject(semaphore, 0) == WaitTimeout);
+  REQUIRE(WaitForObject(fastSemaphore, 0) == WaitTimeout);
+  REQUIRE(semaphore.getSpin().getFailureCount() == 0);
+  REQUIRE(fastSemaphore.getSpin().getFailureCount() == 0);
+
+  REQUIRE(WaitForObject(semaphore, 10) == WaitTimeout);
+  REQUIRE(WaitForObject(fastSemaphore, 10) == WaitTimeout);
+  REQUIRE(semaphore.getSpin().getFailureCount() == (multiprocessor ? 1 : 0));
+  REQUIRE(fastSemaphore.getSpin().getFailureCount() == (multiprocessor ? 1 : 0));
+
+  // An available semaphore is taken without counting a spin
+  semaphore.unlock(1);
+  fastSemaphore.unlock(1);
+  REQUIRE(WaitForObject(semaphore, 10) == WaitSuccess);
+  REQUIRE(WaitForObject(fastSemaphore, 10) == WaitSuccess);
+  REQUIRE(semaphore.getSpin().getSuccessCount() == 0);
+  REQUIRE(fastSemaphore.getSpin().getSuccessCount() == 0);
+
+  // Moving to the kernel keeps the limit
+  fastSemaphore.getSpin().setLimit(7);
+  WaitSet waitSet;
+  REQUIRE(waitSet.add(fastSemaphore));
+  REQUIRE(fastSemaphore.getSpin().getLimit() == 7);
+}
+
+// Helper function to run the same checks on Semaphore and FastSemaphore
+template <typename SemaphoreType>
+void runBatchTest(SemaphoreType& sem)
+{
+  REQUIRE_THROWS_AS(sem.tryLock(0), std::invalid_argument);
+
+  // The whole count is taken, or nothing
+  REQUIRE(sem.tryLock(3));
+  REQUIRE(!sem.tryLock(3));
+  REQUIRE(sem.tryLock(2));
+  REQUIRE_THROWS_AS(sem.lock(2, 20), std::runtime_error);
+  sem.unlock(1);
+  REQUIRE_THROWS_AS(sem.lock(2, 20), std::runtime_error);
+  sem.unlock(1);
+  sem.lock(2, 20);
+
+  // Take whatever is there, up to the count
+  REQUIRE(sem.tryLockUpTo(4) == 0);
+  sem.unlock(3);
+  REQUIRE(sem.tryLockUpTo(2) == 2);
+  REQUIRE(sem.lockUpTo(4, 20) == 1);
+  REQUIRE_THROWS_AS(sem.lockUpTo(4, 20), std::runtime_error);
+
+  // Single locks see the count left by batches
+  sem.unlock(10);
+  REQUIRE(sem.tryLock(6));
+  for(uint32_t i = 0; i < 4; ++i)
+    REQUIRE(WaitForObject(sem, 0) == WaitSuccess);
+  REQUIRE(WaitForObject(sem, 20) == WaitTimeout);
+}
+
+template <typename SemaphoreType>
+class BatchTestThread : public Thread
+{
+public:
+  BatchTestThread(SemaphoreType& sem) :
+    Thread(0),
+    m_sem(sem)
+  {
+    // Do nothing
+  }
+
+protected:
+  void iterate(Handle handle GCC_UNUSED)
+  {
+    for(uint32_t i = 0; i < 4; ++i)
+    {
+      sleep_ms(5);
+      m_sem.unlock(1);
+    }
+
+    stop();
+  };
+
+private:
+  SemaphoreType& m_sem;
+};
+
+template <typename SemaphoreType>
+void runBatchThreadTest(SemaphoreType& sem)
+{
+  // The batch is taken once the other thread has unlocked all of it
+  BatchTestThread<SemaphoreType> thread(sem);
+  thread.start();
+  sem.lock(4, 2000);
+  REQUIRE(!sem.tryLock(1));
+  REQUIRE(WaitForObject(thread, 2000) == WaitSuccess);
+  REQUIRE(thread.getError() == "");
+}
+
+TEST_CASE("semaphore/batch", "Test taking several units of the count at once")
+{
+  Semaphore semaphore(10, 5);
+  FastSemaphore fastSemaphore(10, 5);
+
+  runBatchTest(semaphore);
+  runBatchThreadTest(semaphore);
+  runBatchTest(fastSemaphore);
+  runBatchThreadTest(fastSemaphore);
+
+  // A FastSemaphore passes batches on to the kernel object
+  WaitSet waitSet;
+  Handle handle;
+  REQUIRE(waitSet.add(fastSemaphore));
+  fastSemaphore.unlock(5);
+  runBatchTest(fastSemaphore);
+  runBatchThreadTest(fastSemaphore);
+
+  // Batches taken through the semaphore are reflected in the handle
+  fastSemaphore.unlock(3);
+  REQUIRE(fastSemaphore.tryLockUpTo(5) == 3);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+  fastSemaphore.unlock(2);
+  REQUIRE(fastSemaphore.tryLock(1));
+  REQUIRE(waitSet.waitAny(20, handle) == WaitSuccess);
+  REQUIRE(waitSet.waitAny(20, handle) == WaitTimeout);
+}
+#endif
@@ -2,6 +2,12 @@
 #include "LetheException.h"
 #include "testCommon.h"
 #include "catch/catch.hpp"
+#include <new>
+
+#if defined(__linux__)
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
 
 using namespace lethe;
 
@@ -70,3 +76,78 @@ TEST_CASE("sharedMemory/data", "Test passing data through shared memory")
   for(uint8_t* data = (uint8_t*)shm2.begin(); data != shm2.end(); ++data)
     REQUIRE(*data == i++);
 }
+
+#if defined(__linux__)
+struct SharedPrimitives
+{
+  SharedPrimitives() :
+    mutex(false),
+    semaphore(2, 0),
+    event(false, true)
+  {
+    // Do nothing
+  }
+
+  ProcessMutex mutex;
+  ProcessSemaphore semaphore;
+  ProcessEvent event;
+};
+
+TEST_CASE("sharedMemory/primitives", "Test synchronization objects constructed in shared memory")
+{
+  std::stringstream filename;
+  filename << getProcessId() << "-test4";
+
+  SharedMemory shm1(sizeof(SharedPrimitives), filename.str());
+  SharedMemory shm2(filename.str());
+  SharedPrimitives* local = new (shm1.begin()) SharedPrimitives();
+  SharedPrimitives* mapped = static_cast<SharedPrimitives*>(shm2.begin());
+
+  // Objects are the same through either mapping
+  REQUIRE(mapped->event.wait(0) == WaitTimeout);
+  local->event.set();
+  REQUIRE(mapped->event.wait(0) == WaitSuccess);
+  REQUIRE(local->event.wait(0) == WaitTimeout);
+
+  REQUIRE_THROWS_AS(mapped->semaphore.unlock(3), std::bad_syscall);
+  local->semaphore.unlock(1);
+  REQUIRE(mapped->semaphore.lock(0) == WaitSuccess);
+  REQUIRE(local->semaphore.lock(std::chrono::milliseconds(20)) == WaitTimeout);
+
+  REQUIRE(local->mutex.lock(0) == WaitSuccess);
+  REQUIRE(mapped->mutex.lock(0) == WaitSuccess);
+  mapped->mutex.unlock();
+  local->mutex.unlock();
+  REQUIRE_THROWS_AS(local->mutex.unlock(), std::bad_syscall);
+
+  // The child waits for the event, then dies holding the mutex
+  pid_t child = fork();
+
+  if(child == 0)
+  {
+    if(mapped->event.wait(2000) != WaitSuccess)
+      _exit(1);
+
+    mapped->semaphore.unlock(2);
+    _exit(mapped->mutex.lock(0) == WaitSuccess ? 0 : 1);
+  }
+
+  REQUIRE(child > 0);
+  local->event.set();
+  REQUIRE(local->semaphore.lock(2000) == WaitSuccess);
+  REQUIRE(local->semaphore.lock(2000) == WaitSuccess);
+
+  int status;
+  REQUIRE(waitpid(child, &status, 0) == child);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+
+  // The mutex is taken over by the next owner, and recovers after that
+  REQUIRE(local->mutex.lock(2000) == WaitAbandoned);
+  local->mutex.unlock();
+  REQUIRE(mapped->mutex.lock(0) == WaitSuccess);
+  mapped->mutex.unlock();
+
+  local->~SharedPrimitives();
+}
+#endif
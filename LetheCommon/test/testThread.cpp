@@ -271,3 +271,65 @@ TEST_CASE("thread/stop", "Test stopping threads")
   REQUIRE(thread.isStopping());
   REQUIRE(thread.getError() == "shutting down thread");
 }
+
+// ObjectThread lets the test queue WaitObject operations on it
+class ObjectThread : public Thread, public WaitHandler
+{
+public:
+  ObjectThread() : Thread(INFINITE) { };
+
+  void add(WaitObject& obj) { addWaitObject(obj); };
+  void addExclusive(WaitObject& obj) { addExclusiveWaitObject(obj, *this); };
+  void modify(WaitObject& obj, uint32_t interest) { modifyWaitObject(obj, interest); };
+  void remove(WaitObject& obj) { removeWaitObject(obj); };
+  void setPolicy(WaitPolicy policy) { setWaitPolicy(policy); };
+  void setWeight(WaitObject& obj, uint32_t weight) { setWaitWeight(obj, weight); };
+  uint64_t getDispatchCount(WaitObject& obj) { return getWaitDispatchCount(obj); };
+
+  void handleWait(const WaitEvent& event GCC_UNUSED) { /* Do nothing */ };
+
+protected:
+  void iterate(Handle handle GCC_UNUSED) { /* Do nothing */ };
+};
+
+TEST_CASE("thread/addFailed", "Test adding a WaitObject the WaitSet refuses")
+{
+  WaitObject invalid(INVALID_HANDLE_VALUE);
+  Event event(false, true);
+  ObjectThread thread;
+
+  thread.add(event);
+  thread.add(invalid);
+  thread.start();
+
+  // By default, the failed add stops the thread
+  REQUIRE(WaitForObject(thread, 1000) == WaitSuccess);
+  REQUIRE(thread.getError() == "invalid handle");
+
+  // The thread's mutex was released, so operations can still be queued
+  thread.remove(event);
+}
+
+TEST_CASE("thread/operationFailed", "Test WaitObject operations the WaitSet refuses")
+{
+  Pipe pipe;
+  ObjectThread thread;
+
+  // Bad arguments are refused before they reach the thread
+  REQUIRE_THROWS_AS(thread.modify(pipe, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(thread.modify(pipe, WaitHangup << 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(thread.setPolicy(static_cast<WaitPolicy>(WaitPolicyWeighted + 1)), std::invalid_argument);
+  REQUIRE_THROWS_AS(thread.setWeight(pipe, 0), std::invalid_argument);
+
+  // An exclusive registration can't wait for a hangup, which the WaitSet only finds out
+  thread.addExclusive(pipe);
+  thread.modify(pipe, WaitReadable | WaitHangup);
+  thread.start();
+
+  REQUIRE(WaitForObject(thread, 1000) == WaitSuccess);
+  REQUIRE(thread.getError() == "WaitHangup cannot be exclusive");
+
+  // The thread's mutex was released
+  REQUIRE(thread.getDispatchCount(pipe) == 0);
+  thread.remove(pipe);
+}
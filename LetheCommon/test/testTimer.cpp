@@ -65,3 +65,82 @@ TEST_CASE("timer/wait", "Test waiting for timers")
   timer.clear();
   REQUIRE(WaitForObject(timer, 0) == WaitTimeout);
 }
+
+TEST_CASE("timer/duration", "Test timers shorter than a millisecond")
+{
+  Timer timer(std::chrono::microseconds(200), false, false);
+  uint64_t startTime;
+
+  startTime = getMonotonicTime();
+  REQUIRE(WaitForObject(timer, std::chrono::milliseconds(50)) == WaitSuccess);
+  REQUIRE(getMonotonicTime() - startTime <= 10000000);
+  timer.clear();
+  REQUIRE(WaitForObject(timer, 0) == WaitTimeout);
+
+  startTime = getMonotonicTime();
+  timer.start(std::chrono::microseconds(100), true);
+
+  for(uint32_t i(0); i < 10; ++i)
+  {
+    REQUIRE(WaitForObject(timer, std::chrono::milliseconds(50)) == WaitSuccess);
+    REQUIRE(getMonotonicTime() - startTime >= 100000);
+  }
+
+  timer.clear();
+  REQUIRE_THROWS_AS(timer.start(std::chrono::microseconds(-1), false), std::invalid_argument);
+}
+
+#if defined(__linux__)
+TEST_CASE("timer/deadline", "Test timers started at absolute deadlines")
+{
+  Timer timer(INFINITE, false, true);
+  uint64_t startTime = getMonotonicTime();
+
+  timer.startAt(startTime + 20000000);
+  REQUIRE(WaitForObject(timer, 10) == WaitTimeout);
+  REQUIRE(WaitForObject(timer, 100) == WaitSuccess);
+  REQUIRE(getMonotonicTime() - startTime >= 20000000);
+  REQUIRE(timer.getOverrun() == 0);
+  REQUIRE(WaitForObject(timer, 20) == WaitTimeout);
+
+  // A deadline that has already passed expires straight away
+  timer.startAt(startTime);
+  REQUIRE(WaitForObject(timer, 0) == WaitSuccess);
+  timer.startAt(0);
+  REQUIRE(WaitForObject(timer, 0) == WaitSuccess);
+
+  REQUIRE_THROWS_AS(timer.startAt(startTime, std::chrono::nanoseconds(-1)), std::invalid_argument);
+  timer.clear();
+  REQUIRE(WaitForObject(timer, 20) == WaitTimeout);
+}
+
+TEST_CASE("timer/overrun", "Test counting the expirations of a periodic timer missed by its waiter")
+{
+  const uint64_t period(5000000);
+  Timer timer(INFINITE, false, true);
+  uint64_t firstDeadline = getMonotonicTime() + period;
+  uint64_t expirations(0);
+
+  timer.startAt(firstDeadline, std::chrono::nanoseconds(period));
+
+  // Sleeping through several periods shows up as overruns on the next wait
+  sleep_ms(52);
+  REQUIRE(WaitForObject(timer, 100) == WaitSuccess);
+  REQUIRE(timer.getOverrun() >= 8);
+  expirations += 1 + timer.getOverrun();
+
+  for(uint32_t i(0); i < 10; ++i)
+  {
+    REQUIRE(WaitForObject(timer, 100) == WaitSuccess);
+    expirations += 1 + timer.getOverrun();
+  }
+
+  // Counting the overruns accounts for every period since the deadline
+  uint64_t elapsedPeriods = (getMonotonicTime() - firstDeadline) / period + 1;
+  REQUIRE(expirations <= elapsedPeriods);
+  REQUIRE(expirations + 1 >= elapsedPeriods);
+
+  timer.clear();
+  REQUIRE(WaitForObject(timer, 20) == WaitTimeout);
+}
+#endif
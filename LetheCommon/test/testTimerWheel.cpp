@@ -0,0 +1,228 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include "testCommon.h"
+#include "catch/catch.hpp"
+#include <vector>
+#include <set>
+
+using namespace lethe;
+
+#if defined(__linux__)
+// The number of times runWheel has advanced a wheel, so a handler can tell which
+//  timers expired together
+static uint32_t advanceCount(0);
+
+// Records the timers it receives, userData points to the time each timer is due
+class TestTimerHandler : public TimerHandler
+{
+public:
+  TestTimerHandler() :
+    m_early(0),
+    m_maxLate(0)
+  {
+    // Do nothing
+  }
+
+  void handleTimer(TimerId id, void* userData)
+  {
+    uint64_t now = getMonotonicTime();
+    uint64_t dueTime = *static_cast<uint64_t*>(userData);
+
+    m_fired.push_back(id);
+    m_advances.insert(advanceCount);
+
+    if(now < dueTime)
+      ++m_early;
+    else if(now - dueTime > m_maxLate)
+      m_maxLate = now - dueTime;
+  }
+
+  std::vector<TimerId> m_fired;
+  std::set<uint32_t> m_advances; // The calls to advance() that expired timers
+  uint32_t m_early;
+  uint64_t m_maxLate;
+};
+
+// Waits for the wheel and advances it until every timer has fired
+static void runWheel(TimerWheel& wheel, uint32_t timeout)
+{
+  uint64_t endTime = getMonotonicTime() + static_cast<uint64_t>(timeout) * 1000000;
+
+  while(wheel.getCount() != 0 && getMonotonicTime() < endTime)
+  {
+    if(WaitForObject(wheel, 100) == WaitSuccess)
+    {
+      ++advanceCount;
+      wheel.advance();
+    }
+  }
+}
+
+TEST_CASE("timerWheel/schedule", "Test scheduling and cancelling timers on a wheel")
+{
+  REQUIRE_THROWS_AS(TimerWheel(0), std::invalid_argument);
+  REQUIRE_THROWS_AS(TimerWheel(std::chrono::nanoseconds(0)), std::invalid_argument);
+
+  TimerWheel wheel;
+  TestTimerHandler handler;
+  uint64_t startTime = getMonotonicTime();
+  uint64_t dueTimes[] = { startTime + 10000000, startTime + 30000000, startTime + 20000000 };
+
+  TimerId first = wheel.schedule(handler, 10, &dueTimes[0]);
+  TimerId second = wheel.schedule(handler, 30, &dueTimes[1]);
+  TimerId third = wheel.schedule(handler, std::chrono::milliseconds(20), &dueTimes[2]);
+  REQUIRE(wheel.getCount() == 3);
+  REQUIRE(first != 0);
+  REQUIRE(first != second);
+  REQUIRE_THROWS_AS(wheel.schedule(handler, std::chrono::nanoseconds(-1)), std::invalid_argument);
+
+  // Nothing is due yet
+  REQUIRE(WaitForObject(wheel, 0) == WaitTimeout);
+  wheel.advance();
+  REQUIRE(handler.m_fired.empty());
+
+  REQUIRE(wheel.cancel(second));
+  REQUIRE(!wheel.cancel(second));
+  REQUIRE(wheel.getCount() == 2);
+
+  runWheel(wheel, 1000);
+  REQUIRE(wheel.getCount() == 0);
+  REQUIRE(handler.m_fired.size() == 2);
+  REQUIRE(handler.m_fired[0] == first);
+  REQUIRE(handler.m_fired[1] == third);
+  REQUIRE(handler.m_early == 0);
+
+  // Expired timers can't be cancelled, and a reused entry gets a new id
+  REQUIRE(!wheel.cancel(first));
+  REQUIRE(!wheel.cancel(0));
+  TimerId fourth = wheel.schedule(handler, 1, &dueTimes[0]);
+  REQUIRE(fourth != first);
+  REQUIRE(fourth != third);
+  REQUIRE(!wheel.cancel(first));
+  REQUIRE(wheel.cancel(fourth));
+
+  // Once nothing is scheduled, the kernel timer is stopped
+  wheel.advance();
+  REQUIRE(WaitForObject(wheel, 20) == WaitTimeout);
+}
+
+TEST_CASE("timerWheel/levels", "Test timers that move down through the levels of a wheel")
+{
+  // With 1us ticks, the 200ms spread covers the first three levels
+  TimerWheel wheel(std::chrono::microseconds(1));
+  TestTimerHandler handler;
+  const uint32_t numTimers(2000);
+  std::vector<uint64_t> dueTimes(numTimers);
+  std::vector<TimerId> ids(numTimers);
+  uint32_t cancelled(0);
+
+  seedRandom();
+
+  for(uint32_t i(0); i < numTimers; ++i)
+  {
+    uint64_t timeout = (rand() % 200000) * 1000;
+    dueTimes[i] = getMonotonicTime() + timeout;
+    ids[i] = wheel.schedule(handler, std::chrono::nanoseconds(timeout), &dueTimes[i]);
+  }
+
+  for(uint32_t i(0); i < numTimers; i += 3)
+  {
+    REQUIRE(wheel.cancel(ids[i]));
+    ++cancelled;
+  }
+
+  REQUIRE(wheel.getCount() == numTimers - cancelled);
+  runWheel(wheel, 5000);
+  REQUIRE(wheel.getCount() == 0);
+  REQUIRE(handler.m_fired.size() == numTimers - cancelled);
+  REQUIRE(handler.m_early == 0);
+  REQUIRE(handler.m_maxLate < 50000000);
+
+  // A timer beyond the top level is still kept
+  TimerId longTimer = wheel.schedule(handler, std::chrono::hours(2), &dueTimes[0]);
+  REQUIRE(wheel.getCount() == 1);
+  wheel.advance();
+  REQUIRE(handler.m_fired.size() == numTimers - cancelled);
+  REQUIRE(wheel.cancel(longTimer));
+}
+
+TEST_CASE("timerWheel/slack", "Test coalescing timers with slack")
+{
+  TimerWheel wheel;
+  TestTimerHandler exactHandler;
+  TestTimerHandler slackHandler;
+  const uint32_t numTimers(32);
+  uint64_t dueTimes[numTimers];
+  std::vector<TimerId> ids;
+
+  // Timers 1ms apart each have their own tick, so they fire in order and none early
+  for(uint32_t i(0); i < numTimers; ++i)
+  {
+    dueTimes[i] = getMonotonicTime() + (i + 1) * 1000000;
+    ids.push_back(wheel.schedule(exactHandler, i + 1, &dueTimes[i]));
+  }
+
+  runWheel(wheel, 1000);
+  REQUIRE(exactHandler.m_fired == ids);
+  REQUIRE(exactHandler.m_early == 0);
+
+  // With enough slack, they share a few ticks, and are expired by a few advances
+  for(uint32_t i(0); i < numTimers; ++i)
+  {
+    dueTimes[i] = getMonotonicTime() + (i + 1) * 1000000;
+    wheel.schedule(slackHandler, i + 1, &dueTimes[i], numTimers);
+  }
+
+  runWheel(wheel, 1000);
+  REQUIRE(slackHandler.m_fired.size() == numTimers);
+  REQUIRE(slackHandler.m_advances.size() <= 3);
+  REQUIRE(slackHandler.m_early == 0);
+  REQUIRE(slackHandler.m_maxLate < (numTimers + 20) * 1000000);
+}
+
+// Keeps a number of timers going, each one scheduling itself again when it fires
+class TimerWheelTestThread : public Thread, public TimerHandler
+{
+public:
+  TimerWheelTestThread() :
+    Thread(INFINITE),
+    m_fired(0)
+  {
+    // Do nothing
+  }
+
+  uint32_t getFired() const { return m_fired; }
+
+protected:
+  void setup()
+  {
+    addWaitObject(m_wheel, m_wheel);
+
+    for(uint32_t i(0); i < 100; ++i)
+      m_wheel.schedule(*this, 1 + i % 5);
+  }
+
+  void handleTimer(TimerId id GCC_UNUSED, void* userData GCC_UNUSED)
+  {
+    if(++m_fired >= 1000)
+      stop();
+    else
+      m_wheel.schedule(*this, 1 + m_fired % 5);
+  }
+
+private:
+  TimerWheel m_wheel;
+  uint32_t m_fired;
+};
+
+TEST_CASE("timerWheel/thread", "Test delivering timers through a thread")
+{
+  TimerWheelTestThread thread;
+
+  thread.start();
+  REQUIRE(WaitForObject(thread, 5000) == WaitSuccess);
+  REQUIRE(thread.getError() == "");
+  REQUIRE(thread.getFired() >= 1000);
+}
+#endif
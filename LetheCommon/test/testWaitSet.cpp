@@ -2,7 +2,9 @@
 #include "LetheException.h"
 #include "LetheInternal.h"
 #include "Log.h"
+#include "HandleTable.h"
 #include "catch/catch.hpp"
+#include <vector>
 
 using namespace lethe;
 
@@ -154,6 +156,53 @@ TEST_CASE("waitSet/remove", "Test removing WaitObjects")
   REQUIRE(waitSet.getSize() == 0);
 }
 
+TEST_CASE("waitSet/capacity", "Test WaitSets larger than a single wait call used to allow")
+{
+  const uint32_t numEvents(500);
+  Event** eventArray = new Event*[numEvents];
+  WaitSet waitSet;
+  Handle waitHandle;
+
+  for(uint32_t i(0); i < numEvents; ++i)
+  {
+    eventArray[i] = new Event(false, true);
+    REQUIRE(waitSet.add(*eventArray[i]));
+  }
+
+  REQUIRE(waitSet.getSize() == numEvents);
+  REQUIRE(waitSet.waitAny(0, waitHandle) == WaitTimeout);
+
+  // Trigger every other event, each should be returned exactly once
+  std::set<Handle> unfinished;
+  for(uint32_t i(0); i < numEvents; i += 2)
+  {
+    eventArray[i]->set();
+    unfinished.insert(eventArray[i]->getHandle());
+  }
+
+  while(!unfinished.empty())
+  {
+    REQUIRE(waitSet.waitAny(20, waitHandle) == WaitSuccess);
+    REQUIRE(unfinished.erase(waitHandle) == 1);
+  }
+
+  REQUIRE(waitSet.waitAny(0, waitHandle) == WaitTimeout);
+
+  // Removing a triggered handle must drop its buffered event
+  eventArray[0]->set();
+  eventArray[2]->set();
+  REQUIRE(waitSet.waitAny(20, waitHandle) == WaitSuccess);
+  REQUIRE(waitSet.remove(waitHandle == eventArray[0]->getHandle() ? *eventArray[2] : *eventArray[0]));
+  REQUIRE(waitSet.waitAny(0, waitHandle) == WaitTimeout);
+
+  for(uint32_t i(0); i < numEvents; ++i)
+  {
+    delete eventArray[i];
+  }
+
+  delete [] eventArray;
+}
+
 TEST_CASE("waitSet/waitAny", "Test waiting for any WaitObjects")
 {
   // The waitAny function may throw exceptions, but I can't find a way to make it do so
@@ -312,6 +361,301 @@ TEST_CASE("waitSet/waitAny2", "Test behavior of waitAny in different conditions"
   REQUIRE(waitHandle == INVALID_HANDLE_VALUE);
 }
 
+TEST_CASE("waitSet/waitMany", "Test receiving several WaitObjects from one wait")
+{
+  const size_t maxCount(4);
+  WaitSet waitSet;
+  Handle handles[maxCount];
+  WaitResult results[maxCount];
+
+  Event event(false, true);
+  Semaphore semaphore(10, 0);
+  Timer timer(INFINITE, false, false);
+  Pipe pipe;
+
+  REQUIRE_THROWS_AS(waitSet.waitMany(0, handles, results, 0), std::invalid_argument);
+  REQUIRE(waitSet.waitMany(0, handles, results, maxCount) == 0);
+
+  waitSet.add(event);
+  waitSet.add(semaphore);
+  waitSet.add(timer);
+  waitSet.add(pipe);
+
+  REQUIRE(waitSet.waitMany(20, handles, results, maxCount) == 0);
+
+  // Trigger everything, all of them should come back from a single call
+  std::set<Handle> unfinished;
+  unfinished.insert(event.getHandle());
+  unfinished.insert(semaphore.getHandle());
+  unfinished.insert(timer.getHandle());
+  unfinished.insert(pipe.getHandle());
+
+  event.set();
+  semaphore.unlock(1);
+  timer.start(1, false);
+  pipe.send("text", 5);
+  sleep_ms(10);
+
+  REQUIRE(waitSet.waitMany(20, handles, results, maxCount) == maxCount);
+
+  for(size_t i(0); i < maxCount; ++i)
+  {
+    REQUIRE(results[i] == WaitSuccess);
+    REQUIRE(unfinished.erase(handles[i]) == 1);
+  }
+
+  // Events that don't fit are returned by the next call without waiting
+  uint8_t buffer[5];
+  timer.clear();
+  pipe.receive(buffer, 5);
+
+  event.set();
+  semaphore.unlock(1);
+  REQUIRE(waitSet.waitMany(20, handles, results, 1) == 1);
+  REQUIRE(waitSet.waitMany(20, handles + 1, results + 1, 1) == 1);
+  REQUIRE(handles[0] != handles[1]);
+  REQUIRE(waitSet.waitMany(20, handles, results, maxCount) == 0);
+}
+
+TEST_CASE("waitSet/reuse", "Test that buffered events are dropped when a handle is reused")
+{
+  WaitSet waitSet;
+  Handle handle;
+  WaitResult result;
+
+  Pipe pipeA;
+  Pipe* pipeB = new Pipe();
+
+  waitSet.add(pipeA);
+  waitSet.add(*pipeB);
+
+  pipeA.send("text", 5);
+  pipeB->send("text", 5);
+
+  // Receive one event, leaving the other buffered in the set
+  REQUIRE(waitSet.waitMany(20, &handle, &result, 1) == 1);
+
+  Handle oldHandle = pipeB->getHandle();
+  REQUIRE(waitSet.remove(*pipeB));
+  delete pipeB;
+  pipeB = new Pipe();
+  REQUIRE(waitSet.add(*pipeB));
+
+  // If the handle was reused, the new pipe must not inherit the old event
+  if(handle == pipeA.getHandle())
+  {
+    uint8_t buffer[5];
+    pipeA.receive(buffer, 5);
+    REQUIRE(waitSet.waitMany(20, &handle, &result, 1) == 0);
+  }
+  else
+  {
+    REQUIRE(waitSet.waitMany(20, &handle, &result, 1) == 1);
+    REQUIRE(handle == pipeA.getHandle());
+  }
+
+  REQUIRE(waitSet.getSize() == 2);
+
+  // The table behind the set keeps a generation for each handle
+  HandleTable<int> table;
+  REQUIRE(table.insert(oldHandle, 1));
+  REQUIRE(!table.insert(oldHandle, 2));
+  uint32_t generation = table.getGeneration(oldHandle);
+  REQUIRE(table.erase(oldHandle));
+  REQUIRE(table.find(oldHandle) == static_cast<int*>(NULL));
+  REQUIRE(table.insert(oldHandle, 3));
+  REQUIRE(*table.find(oldHandle) == 3);
+  REQUIRE(table.find(oldHandle, generation) == static_cast<int*>(NULL));
+  REQUIRE(table.size() == 1);
+
+  delete pipeB;
+}
+
+// Record every event dispatched to the handler, optionally removing objects from the set
+class WaitSetTestHandler : public WaitHandler
+{
+public:
+  WaitSetTestHandler(WaitSet& waitSet) : m_waitSet(waitSet), m_removeObject(NULL) { };
+
+  void handleWait(const WaitEvent& event)
+  {
+    m_events.push_back(event);
+
+    if(m_removeObject != NULL)
+      m_waitSet.remove(*m_removeObject);
+  };
+
+  WaitSet& m_waitSet;
+  WaitObject* m_removeObject;
+  std::vector<WaitEvent> m_events;
+};
+
+TEST_CASE("waitSet/dispatch", "Test WaitSet handlers and user data")
+{
+  const size_t maxCount(4);
+  WaitSet waitSet;
+  WaitEvent events[maxCount];
+  WaitSetTestHandler handler(waitSet);
+  int eventData(1);
+  int semaphoreData(2);
+
+  Event event(false, true);
+  Semaphore semaphore(10, 0);
+  Event unhandled(false, true);
+
+  REQUIRE(waitSet.dispatch(0) == 0);
+
+  REQUIRE(waitSet.add(event, handler, &eventData));
+  REQUIRE(waitSet.add(semaphore, handler, &semaphoreData));
+  REQUIRE(!waitSet.add(event, handler, &semaphoreData));
+  REQUIRE(waitSet.dispatch(20) == 0);
+
+  // WaitEvents carry the registration without any lookup by the caller
+  event.set();
+  semaphore.unlock(1);
+  REQUIRE(waitSet.waitMany(20, events, maxCount) == 2);
+
+  for(size_t i(0); i < 2; ++i)
+  {
+    REQUIRE(events[i].result == WaitSuccess);
+    REQUIRE(events[i].handler == &handler);
+
+    if(events[i].handle == event.getHandle())
+    {
+      REQUIRE(events[i].object == &event);
+      REQUIRE(events[i].userData == &eventData);
+    }
+    else
+    {
+      REQUIRE(events[i].handle == semaphore.getHandle());
+      REQUIRE(events[i].object == &semaphore);
+      REQUIRE(events[i].userData == &semaphoreData);
+    }
+  }
+
+  // Dispatch calls the handler for each event
+  event.set();
+  semaphore.unlock(1);
+  REQUIRE(waitSet.dispatch(20) == 2);
+  REQUIRE(handler.m_events.size() == 2);
+  REQUIRE(handler.m_events[0].handle != handler.m_events[1].handle);
+
+  // A handler removing an object drops its pending event
+  WaitSet waitSet2;
+  WaitSetTestHandler eventHandler(waitSet2);
+  WaitSetTestHandler semaphoreHandler(waitSet2);
+  eventHandler.m_removeObject = &semaphore;
+  semaphoreHandler.m_removeObject = &event;
+
+  REQUIRE(waitSet.remove(event));
+  REQUIRE(waitSet.remove(semaphore));
+  REQUIRE(waitSet2.add(event, eventHandler));
+  REQUIRE(waitSet2.add(semaphore, semaphoreHandler));
+
+  event.set();
+  semaphore.unlock(1);
+  sleep_ms(10);
+  REQUIRE(waitSet2.dispatch(20) == 1);
+  REQUIRE(eventHandler.m_events.size() + semaphoreHandler.m_events.size() == 1);
+  REQUIRE(waitSet2.getSize() == 1);
+
+  // Objects without a handler can't be dispatched
+  REQUIRE(waitSet.add(unhandled));
+  unhandled.set();
+  REQUIRE_THROWS_AS(waitSet.dispatch(20), std::logic_error);
+}
+
+TEST_CASE("waitSet/interest", "Test waiting for writability and changing interest masks")
+{
+  const size_t maxCount(4);
+  WaitSet waitSet;
+  WaitEvent events[maxCount];
+  Pipe pipe;
+
+  REQUIRE_THROWS_AS(waitSet.add(pipe, 0), std::invalid_argument);
+  REQUIRE_THROWS_AS(waitSet.add(pipe, 0x80), std::invalid_argument);
+  REQUIRE(!waitSet.modify(pipe, WaitReadable));
+
+  // An empty pipe is writable but not readable
+  REQUIRE(waitSet.add(pipe, WaitWritable));
+  REQUIRE(waitSet.waitMany(20, events, maxCount) == 1);
+  REQUIRE(events[0].result == WaitSuccess);
+  REQUIRE(events[0].events == WaitWritable);
+  REQUIRE(events[0].object == &pipe);
+
+  REQUIRE(waitSet.modify(pipe, WaitReadable));
+  REQUIRE(waitSet.waitMany(20, events, maxCount) == 0);
+
+  pipe.send("text", 5);
+  REQUIRE(waitSet.waitMany(20, events, maxCount) == 1);
+  REQUIRE(events[0].events == WaitReadable);
+
+  REQUIRE(waitSet.modify(pipe, WaitReadable | WaitWritable));
+  REQUIRE(waitSet.waitMany(20, events, maxCount) == 1);
+  REQUIRE(events[0].events == (WaitReadable | WaitWritable));
+  REQUIRE_THROWS_AS(waitSet.modify(pipe, 0), std::invalid_argument);
+}
+
+TEST_CASE("waitSet/policy", "Test the order of handles that are ready at the same time")
+{
+  const size_t maxCount(4);
+  WaitSet waitSet;
+  WaitEvent events[maxCount];
+  Pipe pipe1;
+  Pipe pipe2;
+  Pipe pipe3;
+
+  REQUIRE(waitSet.getPolicy() == WaitPolicyRoundRobin);
+  REQUIRE(!waitSet.setPriority(pipe1, 1));
+
+  waitSet.add(pipe1);
+  waitSet.add(pipe2);
+  waitSet.add(pipe3);
+
+  // Pipes stay readable until read, so every wait returns all three
+  pipe1.send("text", 5);
+  pipe2.send("text", 5);
+  pipe3.send("text", 5);
+
+  waitSet.setPolicy(WaitPolicyPriority);
+  REQUIRE(waitSet.setPriority(pipe1, 1));
+  REQUIRE(waitSet.setPriority(pipe2, 5));
+  REQUIRE(waitSet.setPriority(pipe3, 3));
+
+  REQUIRE(waitSet.waitMany(20, events, maxCount) == 3);
+  REQUIRE(events[0].object == &pipe2);
+  REQUIRE(events[1].object == &pipe3);
+  REQUIRE(events[2].object == &pipe1);
+
+  // Round-robin should start each wait at a different handle
+  std::set<Handle> first;
+  waitSet.setPolicy(WaitPolicyRoundRobin);
+
+  for(uint32_t i(0); i < 3; ++i)
+  {
+    REQUIRE(waitSet.waitMany(20, events, maxCount) == 3);
+    first.insert(events[0].handle);
+  }
+
+  REQUIRE(first.size() == 3);
+
+  // A heavier weight moves through virtual time slower, so it comes first
+  waitSet.setPolicy(WaitPolicyWeighted);
+  REQUIRE_THROWS_AS(waitSet.setWeight(pipe1, 0), std::invalid_argument);
+  REQUIRE(waitSet.setWeight(pipe3, 10));
+
+  for(uint32_t i(0); i < 3; ++i)
+  {
+    REQUIRE(waitSet.waitMany(20, events, maxCount) == 3);
+  }
+
+  REQUIRE(events[0].object == &pipe3);
+
+  REQUIRE(waitSet.getDispatchCount(pipe1) == 7);
+  REQUIRE(waitSet.getDispatchCount(pipe2) == 7);
+  REQUIRE(waitSet.getDispatchCount(pipe3) == 7);
+}
+
 TEST_CASE("waitSet/error", "Test WaitSet behavior with errored objects")
 {
   // Construct two sets to try slightly different situations
@@ -423,3 +767,37 @@ TEST_CASE("waitSet/abandoned", "Test WaitSet behavior with abandoned objects")
 {
   // TODO: implement waitSet/abandoned test
 }
+
+TEST_CASE("waitSet/duration", "Test waiting with sub-millisecond timeouts")
+{
+  WaitSet waitSet;
+  Handle waitHandle;
+  WaitEvent events[2];
+  uint64_t startTime;
+
+  // An empty set just sleeps
+  startTime = getMonotonicTime();
+  REQUIRE(waitSet.waitAny(std::chrono::microseconds(200), waitHandle) == WaitTimeout);
+  REQUIRE(getMonotonicTime() - startTime >= 200000);
+  REQUIRE(waitHandle == INVALID_HANDLE_VALUE);
+
+  Event event(false, false);
+  Timer timer(INFINITE, false, false);
+  REQUIRE(waitSet.add(event));
+  REQUIRE(waitSet.add(timer));
+
+  startTime = getMonotonicTime();
+  REQUIRE(waitSet.waitAny(std::chrono::microseconds(300), waitHandle) == WaitTimeout);
+  REQUIRE(getMonotonicTime() - startTime >= 300000);
+  REQUIRE(waitSet.waitMany(std::chrono::microseconds(100), events, 2) == 0);
+  REQUIRE(waitSet.dispatch(std::chrono::nanoseconds(0)) == 0);
+
+  timer.start(std::chrono::microseconds(150), false);
+  REQUIRE(waitSet.waitAny(std::chrono::milliseconds(50), waitHandle) == WaitSuccess);
+  REQUIRE(waitHandle == timer.getHandle());
+  timer.clear();
+
+  event.set();
+  REQUIRE(waitSet.waitMany(std::chrono::nanoseconds::max(), events, 2) == 1);
+  REQUIRE(events[0].handle == event.getHandle());
+}
@@ -4,24 +4,54 @@
 #include "Lethe.h"
 #include <cstdatomic>
 
+/*
+ * The ProcessByteStream class is a two-way ByteStream to another process, made
+ *  of a pair of pipes sent with a HandleTransfer.
+ *
+ * On Linux, large buffers may be sent without copying them into the pipe with
+ *  sendZeroCopy(), and received into a file with spliceTo().  The buffer given
+ *  to sendZeroCopy() must be left alone until isReleased() returns true for the
+ *  returned position (see LinuxPipe).
+ *
+ * The capacity functions apply to the pipe carrying data to the other process,
+ *  the other side controls the capacity of the pipe coming back (see LinuxPipe).
+ */
 namespace lethe
 {
   class ProcessByteStream : public ByteStream
   {
   public:
     ProcessByteStream(uint32_t processId, uint32_t timeout);
+    ProcessByteStream(uint32_t processId, std::chrono::nanoseconds timeout);
     ProcessByteStream(ByteStream& stream, uint32_t timeout);
+    ProcessByteStream(ByteStream& stream, std::chrono::nanoseconds timeout);
     ~ProcessByteStream();
 
     bool flush(uint32_t timeout);
     void send(const void* buffer, uint32_t size);
     uint32_t receive(void* buffer, uint32_t size);
+    void sendv(const iovec* vectors, uint32_t count);
+    uint32_t receivev(const iovec* vectors, uint32_t count);
+    WaitObject& getFlushObject();
+
+  #if defined(__linux__)
+    uint64_t sendZeroCopy(const void* buffer, uint32_t size);
+    bool isReleased(uint64_t position);
+    uint32_t spliceTo(Handle handle, uint32_t size);
+
+    uint32_t setCapacity(uint32_t capacity);
+    uint32_t getCapacity() const;
+    void setAdaptiveCapacity(uint32_t maxCapacity);
+  #endif
 
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
     ProcessByteStream(const ProcessByteStream&);
     ProcessByteStream& operator = (const ProcessByteStream&);
 
+    void doSetup(uint32_t remoteProcessId, uint64_t endTime);
+    void doSetup(ByteStream& stream, uint64_t endTime);
+
     Pipe* m_pipeIn;
     Pipe* m_pipeOut;
   };
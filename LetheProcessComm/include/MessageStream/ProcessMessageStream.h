@@ -11,7 +11,9 @@ namespace lethe
   {
   public:
     ProcessMessageStream(ByteStream& stream, uint32_t outgoingSize, uint32_t timeout);
+    ProcessMessageStream(ByteStream& stream, uint32_t outgoingSize, std::chrono::nanoseconds timeout);
     ProcessMessageStream(uint32_t remoteProcessId, uint32_t outgoingSize, uint32_t timeout);
+    ProcessMessageStream(uint32_t remoteProcessId, uint32_t outgoingSize, std::chrono::nanoseconds timeout);
     ~ProcessMessageStream();
 
     void* allocate(uint32_t size);
@@ -32,6 +34,8 @@ namespace lethe
     static const uint32_t s_minSize = 20 * sizeof(ProcessMessage) + sizeof(ProcessMessageHeader);
     static const uint32_t s_maxSize = (1 << 25); // Arbitrary limit: 32 MB
 
+    void construct(ByteStream& stream, uint64_t endTime);
+    void construct(uint32_t remoteProcessId, uint64_t endTime);
     void doSetup(ByteStream& stream, uint64_t endTime);
     void shutdown();
 
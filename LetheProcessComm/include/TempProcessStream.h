@@ -15,6 +15,9 @@ namespace lethe
     bool flush(uint32_t timeout);
     void send(const void* buffer, uint32_t size);
     uint32_t receive(void* buffer, uint32_t size);
+    void sendv(const iovec* vectors, uint32_t count);
+    uint32_t receivev(const iovec* vectors, uint32_t count);
+    WaitObject& getFlushObject();
 
   private:
     // Private, undefined copy constructor and assignment operator so they can't be used
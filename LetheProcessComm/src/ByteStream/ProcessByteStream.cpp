@@ -11,13 +11,16 @@ ProcessByteStream::ProcessByteStream(uint32_t remoteProcessId,
   m_pipeIn(NULL),
   m_pipeOut(new Pipe())
 {
-  uint64_t endTime = getEndTime(timeout);
-  HandleTransfer transfer(remoteProcessId, getTimeout(endTime));
-
-  transfer.sendPipe(*m_pipeOut);
-  m_pipeIn = transfer.recvPipe(getTimeout(endTime));
+  doSetup(remoteProcessId, getEndTime(timeout));
+}
 
-  setHandle(m_pipeIn->getHandle());
+ProcessByteStream::ProcessByteStream(uint32_t remoteProcessId,
+                                     std::chrono::nanoseconds timeout) :
+  ByteStream(INVALID_HANDLE_VALUE),
+  m_pipeIn(NULL),
+  m_pipeOut(new Pipe())
+{
+  doSetup(remoteProcessId, getEndTime(timeout));
 }
 
 ProcessByteStream::ProcessByteStream(ByteStream& stream,
@@ -26,7 +29,30 @@ ProcessByteStream::ProcessByteStream(ByteStream& stream,
   m_pipeIn(NULL),
   m_pipeOut(new Pipe())
 {
-  uint64_t endTime = getEndTime(timeout);
+  doSetup(stream, getEndTime(timeout));
+}
+
+ProcessByteStream::ProcessByteStream(ByteStream& stream,
+                                     std::chrono::nanoseconds timeout) :
+  ByteStream(INVALID_HANDLE_VALUE),
+  m_pipeIn(NULL),
+  m_pipeOut(new Pipe())
+{
+  doSetup(stream, getEndTime(timeout));
+}
+
+void ProcessByteStream::doSetup(uint32_t remoteProcessId, uint64_t endTime)
+{
+  HandleTransfer transfer(remoteProcessId, getTimeout(endTime));
+
+  transfer.sendPipe(*m_pipeOut);
+  m_pipeIn = transfer.recvPipe(getTimeout(endTime));
+
+  setHandle(m_pipeIn->getHandle());
+}
+
+void ProcessByteStream::doSetup(ByteStream& stream, uint64_t endTime)
+{
   HandleTransfer transfer(stream, getTimeout(endTime));
 
   transfer.sendPipe(*m_pipeOut);
@@ -55,3 +81,52 @@ uint32_t ProcessByteStream::receive(void* buffer, uint32_t size)
 {
   return m_pipeIn->receive(buffer, size);
 }
+
+void ProcessByteStream::sendv(const iovec* vectors, uint32_t count)
+{
+  m_pipeOut->sendv(vectors, count);
+}
+
+uint32_t ProcessByteStream::receivev(const iovec* vectors, uint32_t count)
+{
+  return m_pipeIn->receivev(vectors, count);
+}
+
+WaitObject& ProcessByteStream::getFlushObject()
+{
+  return m_pipeOut->getFlushObject();
+}
+
+#if defined(__linux__)
+
+uint64_t ProcessByteStream::sendZeroCopy(const void* buffer, uint32_t size)
+{
+  return m_pipeOut->sendZeroCopy(buffer, size);
+}
+
+bool ProcessByteStream::isReleased(uint64_t position)
+{
+  return m_pipeOut->isReleased(position);
+}
+
+uint32_t ProcessByteStream::spliceTo(Handle handle, uint32_t size)
+{
+  return m_pipeIn->spliceTo(handle, size);
+}
+
+uint32_t ProcessByteStream::setCapacity(uint32_t capacity)
+{
+  return m_pipeOut->setCapacity(capacity);
+}
+
+uint32_t ProcessByteStream::getCapacity() const
+{
+  return m_pipeOut->getCapacity();
+}
+
+void ProcessByteStream::setAdaptiveCapacity(uint32_t maxCapacity)
+{
+  m_pipeOut->setAdaptiveCapacity(maxCapacity);
+}
+
+#endif
@@ -7,6 +7,8 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/un.h>
+#include <poll.h>
+#include <fcntl.h>
 
 using namespace lethe;
 
@@ -222,7 +224,7 @@ void LinuxHandleTransfer::sendSemaphore(const Semaphore& semaphore)
 
 Pipe* LinuxHandleTransfer::recvPipe(uint32_t timeout)
 {
-  uint32_t endTime = getEndTime(timeout);
+  uint64_t endTime = getEndTime(timeout);
   Handle pipeIn = recvInternal(s_pipeType, timeout);
 
   timeout = getTimeout(endTime);
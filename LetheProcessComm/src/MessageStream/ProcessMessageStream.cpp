@@ -20,18 +20,21 @@ ProcessMessageStream::ProcessMessageStream(ByteStream& stream,
   m_headerIn(NULL),
   m_semaphoreIn(NULL)
 {
-  try
-  {
-    doSetup(stream, getEndTime(timeout));
-  }
-  catch(...)
-  {
-    shutdown();
-    throw;
-  }
+  construct(stream, getEndTime(timeout));
+}
 
-  m_headerIn = reinterpret_cast<ProcessMessageHeader*>(m_shmIn->begin());
-  setHandle(m_semaphoreIn->getHandle());
+ProcessMessageStream::ProcessMessageStream(ByteStream& stream,
+                                           uint32_t outgoingSize,
+                                           std::chrono::nanoseconds timeout) :
+  MessageStream(INVALID_HANDLE_VALUE),
+  m_shmOut(checkSize(outgoingSize)),
+  m_headerOut(new (m_shmOut.begin()) ProcessMessageHeader(m_shmOut.size())),
+  m_semaphoreOut(UINT32_MAX, 0),
+  m_shmIn(NULL),
+  m_headerIn(NULL),
+  m_semaphoreIn(NULL)
+{
+  construct(stream, getEndTime(timeout));
 }
 
 ProcessMessageStream::ProcessMessageStream(uint32_t remoteProcessId,
@@ -44,12 +47,47 @@ ProcessMessageStream::ProcessMessageStream(uint32_t remoteProcessId,
   m_shmIn(NULL),
   m_headerIn(NULL),
   m_semaphoreIn(NULL)
+{
+  construct(remoteProcessId, getEndTime(timeout));
+}
+
+ProcessMessageStream::ProcessMessageStream(uint32_t remoteProcessId,
+                                           uint32_t outgoingSize,
+                                           std::chrono::nanoseconds timeout) :
+  MessageStream(INVALID_HANDLE_VALUE),
+  m_shmOut(checkSize(outgoingSize)),
+  m_headerOut(new (m_shmOut.begin()) ProcessMessageHeader(m_shmOut.size())),
+  m_semaphoreOut(UINT32_MAX, 0),
+  m_shmIn(NULL),
+  m_headerIn(NULL),
+  m_semaphoreIn(NULL)
+{
+  construct(remoteProcessId, getEndTime(timeout));
+}
+
+void ProcessMessageStream::construct(ByteStream& stream, uint64_t endTime)
+{
+  try
+  {
+    doSetup(stream, endTime);
+  }
+  catch(...)
+  {
+    shutdown();
+    throw;
+  }
+
+  m_headerIn = reinterpret_cast<ProcessMessageHeader*>(m_shmIn->begin());
+  setHandle(m_semaphoreIn->getHandle());
+}
+
+void ProcessMessageStream::construct(uint32_t remoteProcessId, uint64_t endTime)
 {
   try
   {
     // Since we don't have a stream to use, create a temporary one
     TempProcessStream stream(remoteProcessId);
-    doSetup(stream, getEndTime(timeout));
+    doSetup(stream, endTime);
   }
   catch(...)
   {
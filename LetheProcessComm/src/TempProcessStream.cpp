@@ -80,3 +80,18 @@ uint32_t TempProcessStream::receive(void* buffer, uint32_t size)
 {
   return m_stream->receive(buffer, size);
 }
+
+void TempProcessStream::sendv(const iovec* vectors, uint32_t count)
+{
+  m_stream->sendv(vectors, count);
+}
+
+uint32_t TempProcessStream::receivev(const iovec* vectors, uint32_t count)
+{
+  return m_stream->receivev(vectors, count);
+}
+
+WaitObject& TempProcessStream::getFlushObject()
+{
+  return m_stream->getFlushObject();
+}
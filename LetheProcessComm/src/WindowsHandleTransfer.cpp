@@ -117,7 +117,7 @@ void WindowsHandleTransfer::sendSemaphore(const Semaphore& semaphore)
 
 Pipe* WindowsHandleTransfer::recvPipe(uint32_t timeout)
 {
-  uint32_t endTime = getEndTime(timeout);
+  uint64_t endTime = getEndTime(timeout);
   std::string pipeInName = recvInternal(s_pipeType, timeout);
   std::string pipeOutName = recvInternal(s_pipeType, getTimeout(endTime));
 
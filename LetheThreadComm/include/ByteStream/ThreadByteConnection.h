@@ -4,6 +4,14 @@
 #include "Lethe.h"
 #include "ByteStream/ThreadByteStream.h"
 
+/*
+ * The ThreadByteConnection class is a pair of pipes between two threads, each
+ *  thread gets one end as a ByteStream.
+ *
+ * On Linux, the capacity functions apply to both pipes (see LinuxPipe).
+ *  setCapacity() returns the smaller of the two sizes used, which only differ if
+ *  the kernel refused to change one of them.
+ */
 namespace lethe
 {
   class ThreadByteConnection
@@ -15,6 +23,12 @@ namespace lethe
     ByteStream& getStreamA();
     ByteStream& getStreamB();
 
+  #if defined(__linux__)
+    uint32_t setCapacity(uint32_t capacity);
+    uint32_t getCapacity() const;
+    void setAdaptiveCapacity(uint32_t maxCapacity);
+  #endif
+
   private:
     Pipe m_pipeAtoB;
     Pipe m_pipeBtoA;
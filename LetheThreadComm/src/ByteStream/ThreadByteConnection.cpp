@@ -1,5 +1,6 @@
 #include "Lethe.h"
 #include "ByteStream/ThreadByteConnection.h"
+#include <algorithm>
 
 using namespace lethe;
 
@@ -25,3 +26,25 @@ ByteStream& ThreadByteConnection::getStreamB()
   return m_streamB;
 }
 
+#if defined(__linux__)
+
+uint32_t ThreadByteConnection::setCapacity(uint32_t capacity)
+{
+  uint32_t capacityAtoB = m_pipeAtoB.setCapacity(capacity);
+  uint32_t capacityBtoA = m_pipeBtoA.setCapacity(capacity);
+
+  return std::min(capacityAtoB, capacityBtoA);
+}
+
+uint32_t ThreadByteConnection::getCapacity() const
+{
+  return std::min(m_pipeAtoB.getCapacity(), m_pipeBtoA.getCapacity());
+}
+
+void ThreadByteConnection::setAdaptiveCapacity(uint32_t maxCapacity)
+{
+  m_pipeAtoB.setAdaptiveCapacity(maxCapacity);
+  m_pipeBtoA.setAdaptiveCapacity(maxCapacity);
+}
+
+#endif
@@ -31,3 +31,17 @@ uint32_t ThreadByteStream::receive(void* buffer, uint32_t size)
   return m_pipeIn.receive(buffer, size);
 }
 
+void ThreadByteStream::sendv(const iovec* vectors, uint32_t count)
+{
+  m_pipeOut.sendv(vectors, count);
+}
+
+uint32_t ThreadByteStream::receivev(const iovec* vectors, uint32_t count)
+{
+  return m_pipeIn.receivev(vectors, count);
+}
+
+WaitObject& ThreadByteStream::getFlushObject()
+{
+  return m_pipeOut.getFlushObject();
+}
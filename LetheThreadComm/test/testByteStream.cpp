@@ -46,3 +46,38 @@ TEST_CASE("byteStream/largeData", "Test passing excessively large data through a
 {
   // TODO: implement largeData test
 }
+
+#if defined(__linux__)
+
+TEST_CASE("byteStream/capacity", "Test setting the pipe capacity of a ThreadByteConnection")
+{
+  ThreadByteConnection byteConnection;
+  ByteStream& streamA = byteConnection.getStreamA();
+  ByteStream& streamB = byteConnection.getStreamB();
+  std::string data(200 * 1024, 'x');
+  std::string received;
+  char buffer[4096];
+
+  uint32_t capacity = byteConnection.setCapacity(256 * 1024);
+  REQUIRE(capacity >= 256 * 1024);
+  REQUIRE(byteConnection.getCapacity() == capacity);
+
+  // Both directions take the whole send at once
+  streamA.send(data.c_str(), data.length());
+  REQUIRE(streamA.flush(0));
+  streamB.send(data.c_str(), data.length());
+  REQUIRE(streamB.flush(0));
+
+  for(uint32_t size; (size = streamB.receive(buffer, sizeof(buffer))) != 0; )
+    received.append(buffer, size);
+
+  REQUIRE(received == data);
+  received.clear();
+
+  for(uint32_t size; (size = streamA.receive(buffer, sizeof(buffer))) != 0; )
+    received.append(buffer, size);
+
+  REQUIRE(received == data);
+}
+
+#endif
@@ -6,13 +6,7 @@
 #include "ProcessComm.h"
 #include "SocketComm.h"
 #include "StaticSingleton.h"
-
-// Prototype of the hash map, so users don't need the include
-namespace mct
-{
-  template<typename, typename, typename, typename, typename, bool>
-  class closed_hash_map;
-}
+#include "HandleTable.h"
 
 namespace lethe
 {
@@ -73,7 +67,7 @@ namespace lethe
     void destroyInternal(Handle handle);
     void destroyThreadByteConnection(void* conn);
     void destroyThreadMessageConnection(void* conn);
-    void* acceptWait(StreamType& type, uint32_t timeout, uint32_t endTime);
+    void* acceptWait(StreamType& type, uint32_t timeout, uint64_t endTime);
     void* receiveProcessStream(StreamType& type, uint32_t timeout);
 
     Mutex m_mutex;
@@ -97,12 +91,7 @@ namespace lethe
       uint32_t m_processId;
     };
 
-    mct::closed_hash_map<Handle,
-                         ConnectionInfo*,
-                         std::tr1::hash<Handle>,
-                         std::equal_to<Handle>,
-                         std::allocator<std::pair<const Handle, ConnectionInfo*> >,
-                         false>* m_streams;
+    HandleTable<ConnectionInfo*> m_streams;
 
     class CommThread : public Thread
     {
@@ -125,19 +114,9 @@ namespace lethe
     Pipe m_pipeIn;
     WaitSet m_waitSet;
 
-    mct::closed_hash_map<Handle,
-                         SocketByteStreamListener*,
-                         std::tr1::hash<Handle>,
-                         std::equal_to<Handle>,
-                         std::allocator<std::pair<const Handle, SocketByteStreamListener*> >,
-                         false>* m_byteListeners;
-
-    mct::closed_hash_map<Handle,
-                         SocketMessageStreamListener*,
-                         std::tr1::hash<Handle>,
-                         std::equal_to<Handle>,
-                         std::allocator<std::pair<const Handle, SocketMessageStreamListener*> >,
-                         false>* m_messageListeners;
+    HandleTable<SocketByteStreamListener*> m_byteListeners;
+
+    HandleTable<SocketMessageStreamListener*> m_messageListeners;
 
     static const uint32_t s_defaultSocketListenerQueueLength;
     uint32_t m_defaultSocketListenerQueueLength;
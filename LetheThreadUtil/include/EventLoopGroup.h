@@ -0,0 +1,104 @@
+#ifndef _EVENTLOOPGROUP_H
+#define _EVENTLOOPGROUP_H
+
+#include "Lethe.h"
+#include <string>
+#include <vector>
+#include <map>
+
+/*
+ * The EventLoopGroup class runs a number of loop threads, each with its own WaitSet,
+ *  and spreads WaitObjects across them so that the work of many streams is not
+ *  limited to a single thread.  Every object is added with a WaitHandler, which is
+ *  called from the loop thread the object was given to.
+ *
+ * add() - gives the object to a loop chosen by the group's balancing mode, and
+ *   returns the index of that loop.  RoundRobin cycles through the loops, LeastLoaded
+ *   picks the loop with the fewest objects.  The object is counted in the loop's
+ *   load right away, but is only added to its WaitSet once the loop is running.
+ * addSticky() - gives the object to the loop selected by key, so objects with the
+ *   same key are always handled by the same thread.
+ * addExclusive() - adds the object to every loop, but only one loop is woken each
+ *   time it triggers (see WaitSet::addExclusive).  This is meant for listeners and
+ *   other handles shared by all of the loops, the handler may be called from any
+ *   of the loop threads, possibly at the same time.
+ * modify() - changes the WaitInterest flags of an object in the group.
+ * remove() - removes the object from its loop (or all loops if exclusive).  As with
+ *   Thread::removeWaitObject, the removal is done by the loop thread, so the object
+ *   must stay valid until the loop has woken up.
+ *
+ * The loops begin stopped, start() and stop() start and stop all of them.  If a
+ *  handler throws, its loop exits, and getError() returns the exception text.  If
+ *  a loop's WaitSet can't add an object (see BaseThread::addFailed), the object is
+ *  dropped from the group as if it had been removed, the loop keeps running, and
+ *  getError() returns the reason until a loop fails.  An exclusive object that
+ *  fails in one loop is removed from all of them.
+ */
+namespace lethe
+{
+  class EventLoopGroup
+  {
+  public:
+    enum Balancing
+    {
+      RoundRobin,
+      LeastLoaded
+    };
+
+    explicit EventLoopGroup(uint32_t loopCount, Balancing balancing = RoundRobin);
+    ~EventLoopGroup();
+
+    void start();
+    void stop();
+
+    uint32_t add(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+    uint32_t addSticky(WaitObject& obj, uint64_t key, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+    void addExclusive(WaitObject& obj, WaitHandler& handler, void* userData = NULL, uint32_t interest = WaitReadable);
+    bool modify(WaitObject& obj, uint32_t interest);
+    bool remove(WaitObject& obj);
+
+    uint32_t getLoopCount() const;
+    uint32_t getLoad(uint32_t loop);
+    std::string getError();
+
+  private:
+    // Private, undefined copy constructor and assignment operator so they can't be used
+    EventLoopGroup(const EventLoopGroup&);
+    EventLoopGroup& operator = (const EventLoopGroup&);
+
+    uint32_t addToLoop(uint32_t loop, WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest);
+    void dropObject(WaitObject& obj, uint32_t loop, const std::string& reason);
+
+    static const uint32_t s_exclusiveLoop; // Loop index recorded for objects added to every loop
+
+    class LoopThread : public Thread
+    {
+    public:
+      LoopThread(EventLoopGroup& group, uint32_t index);
+      ~LoopThread();
+
+      void add(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest);
+      void addExclusive(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest);
+      void modify(WaitObject& obj, uint32_t interest);
+      void remove(WaitObject& obj);
+
+    private:
+      void iterate(Handle handle);
+      void addFailed(WaitObject& obj, const std::string& reason);
+
+      EventLoopGroup& m_group;
+      uint32_t m_index;
+    };
+
+    Mutex m_mutex;
+    std::vector<LoopThread*> m_loops;
+    std::vector<uint32_t> m_loads; // The number of objects given to each loop
+    Balancing m_balancing;
+    uint32_t m_nextLoop; // The next loop to use for RoundRobin
+
+    std::map<WaitObject*, uint32_t> m_objectLoops; // The loop each object was given to, by address
+    std::string m_addError; // Why the last object a loop couldn't add was dropped
+  };
+}
+
+#endif
@@ -1,6 +1,5 @@
 #include "CommRegistry.h"
 #include "LetheInternal.h"
-#include "mct/hash-map.hpp"
 #include <sstream>
 
 using namespace lethe;
@@ -11,7 +10,6 @@ const uint32_t CommRegistry::s_defaultSocketListenerQueueLength = 10;
 const uint32_t CommRegistry::s_mutexTimeout = 1000;
 
 CommRegistry::CommRegistry() :
-  m_streams(new mct::closed_hash_map<Handle, ConnectionInfo*>()),
   m_internalThread(NULL),
   m_callbackThread(NULL),
   m_callbackFunction(NULL),
@@ -26,9 +24,10 @@ CommRegistry::~CommRegistry()
   m_mutex.lock(s_mutexTimeout);
 
   // Clean up any remaining streams
-  while(!m_streams->empty())
+  while(!m_streams.empty())
   {
-    Handle handle = m_streams->begin()->first;
+    Handle handle;
+    m_streams.front(handle);
     destroyInternal(handle);
   }
 }
@@ -62,7 +61,7 @@ void CommRegistry::addSocketByteStreamListener(const std::string& host, uint16_t
   SocketByteStreamListener* listener = new SocketByteStreamListener(host, port, s_defaultSocketListenerQueueLength);
   m_mutex.lock(s_mutexTimeout);
   m_waitSet.add(*listener);
-  if(!m_byteListeners->insert(std::make_pair(listener->getHandle(), listener)).second)
+  if(!m_byteListeners.insert(listener->getHandle(), listener))
   {
     m_mutex.unlock();
     throw std::logic_error("failed to add listener to map");
@@ -75,7 +74,7 @@ void CommRegistry::addSocketMessageStreamListener(const std::string& host, uint1
   SocketMessageStreamListener* listener = new SocketMessageStreamListener(host, port, s_defaultSocketListenerQueueLength);
   m_mutex.lock(s_mutexTimeout);
   m_waitSet.add(*listener);
-  if(!m_messageListeners->insert(std::make_pair(listener->getHandle(), listener)).second)
+  if(!m_messageListeners.insert(listener->getHandle(), listener))
   {
     m_mutex.unlock();
     throw std::logic_error("failed to add listener to map");
@@ -106,16 +105,16 @@ std::pair<ByteStream*, ByteStream*> CommRegistry::createThreadByteStream()
 
   ConnectionInfo* infoA = new ConnectionInfo(StreamType::ThreadByte, conn->getStreamA().getHandle(), &conn->getStreamA(), conn);
   ConnectionInfo* infoB = new ConnectionInfo(StreamType::ThreadByte, conn->getStreamB().getHandle(), &conn->getStreamB(), conn);
-  if(!m_streams->insert(std::make_pair(conn->getStreamA().getHandle(), infoA)).second)
+  if(!m_streams.insert(conn->getStreamA().getHandle(), infoA))
   {
     delete infoA;
     delete infoB;
     delete conn;
     throw std::logic_error("failed to insert first stream into map");
   }
-  if(!m_streams->insert(std::make_pair(conn->getStreamB().getHandle(), infoB)).second)
+  if(!m_streams.insert(conn->getStreamB().getHandle(), infoB))
   {
-    m_streams->erase(conn->getStreamA().getHandle());
+    m_streams.erase(conn->getStreamA().getHandle());
     delete infoA;
     delete infoB;
     delete conn;
@@ -137,7 +136,7 @@ ByteStream* CommRegistry::createProcessByteStream(uint32_t processId, uint32_t t
   ProcessByteStream* stream = new ProcessByteStream(processId, timeout);
   ConnectionInfo* connInfo = new ConnectionInfo(StreamType::ProcessMessage, stream->getHandle(), stream, NULL);
 
-  if(!m_streams->insert(std::make_pair(stream->getHandle(), connInfo)).second)
+  if(!m_streams.insert(stream->getHandle(), connInfo))
   {
     delete stream;
     delete connInfo;
@@ -159,16 +158,16 @@ std::pair<MessageStream*, MessageStream*> CommRegistry::createThreadMessageStrea
 
   ConnectionInfo* infoA = new ConnectionInfo(StreamType::ThreadMessage, conn->getStreamA().getHandle(), &conn->getStreamA(), conn);
   ConnectionInfo* infoB = new ConnectionInfo(StreamType::ThreadMessage, conn->getStreamB().getHandle(), &conn->getStreamB(), conn);
-  if(!m_streams->insert(std::make_pair(conn->getStreamA().getHandle(), infoA)).second)
+  if(!m_streams.insert(conn->getStreamA().getHandle(), infoA))
   {
     delete infoA;
     delete infoB;
     delete conn;
     throw std::logic_error("failed to insert stream into map");
   }
-  if(!m_streams->insert(std::make_pair(conn->getStreamB().getHandle(), infoB)).second)
+  if(!m_streams.insert(conn->getStreamB().getHandle(), infoB))
   {
-    m_streams->erase(conn->getStreamA().getHandle());
+    m_streams.erase(conn->getStreamA().getHandle());
     delete infoA;
     delete infoB;
     delete conn;
@@ -190,7 +189,7 @@ MessageStream* CommRegistry::createProcessMessageStream(uint32_t processId, uint
   ProcessMessageStream* stream = new ProcessMessageStream(processId, m_defaultMessageStreamSize, timeout);
   ConnectionInfo* connInfo = new ConnectionInfo(StreamType::ProcessMessage, stream->getHandle(), stream, NULL);
 
-  if(!m_streams->insert(std::make_pair(stream->getHandle(), connInfo)).second)
+  if(!m_streams.insert(stream->getHandle(), connInfo))
   {
     delete stream;
     delete connInfo;
@@ -218,30 +217,30 @@ void CommRegistry::destroyStream(MessageStream& stream)
 
 void CommRegistry::destroyInternal(Handle handle)
 {
-  auto i = m_streams->find(handle);
+  ConnectionInfo** info = m_streams.find(handle);
 
-  if(i != m_streams->cend())
+  if(info != NULL)
   {
-    switch(i->second->m_type)
+    switch((*info)->m_type)
     {
     case StreamType::ThreadByte:
-      destroyThreadByteConnection(i->second->m_connection);
+      destroyThreadByteConnection((*info)->m_connection);
       break;
 
     case StreamType::ThreadMessage:
-      destroyThreadMessageConnection(i->second->m_connection);
+      destroyThreadMessageConnection((*info)->m_connection);
       break;
 
     case StreamType::ProcessByte:
     case StreamType::SocketByte:
-      delete reinterpret_cast<ByteStream*>(i->second->m_stream);
-      m_streams->erase(i);
+      delete reinterpret_cast<ByteStream*>((*info)->m_stream);
+      m_streams.erase(handle);
       break;
 
     case StreamType::ProcessMessage:
     case StreamType::SocketMessage:
-      delete reinterpret_cast<MessageStream*>(i->second->m_stream);
-      m_streams->erase(i);
+      delete reinterpret_cast<MessageStream*>((*info)->m_stream);
+      m_streams.erase(handle);
       break;
 
     default:
@@ -251,71 +250,43 @@ void CommRegistry::destroyInternal(Handle handle)
   }
 }
 
-// TODO: two nearly identical implementations - can't templatize because avoiding exposing mct to users
+// TODO: two nearly identical implementations
 void CommRegistry::destroyThreadByteConnection(void* conn)
 {
   ThreadByteConnection* connection = reinterpret_cast<ThreadByteConnection*>(conn);
 
-  auto a = m_streams->find(connection->getStreamA().getHandle());
-  auto b = m_streams->find(connection->getStreamB().getHandle());
-
   if(connection == NULL)
     throw std::logic_error("null connection in thread stream info");
 
-  try
-  {
-    if(a == m_streams->cend() || b == m_streams->cend())
-      throw std::logic_error("could not find both sides of thread stream");
-
-    delete connection;
-    m_streams->erase(a);
-    m_streams->erase(b);
-  }
-  catch(...)
-  {
-    delete connection;
-
-    if(a != m_streams->end())
-      m_streams->erase(a);
+  Handle a = connection->getStreamA().getHandle();
+  Handle b = connection->getStreamB().getHandle();
+  bool found = (m_streams.find(a) != NULL && m_streams.find(b) != NULL);
 
-    if(b != m_streams->end())
-      m_streams->erase(b);
+  delete connection;
+  m_streams.erase(a);
+  m_streams.erase(b);
 
-    throw;
-  }
+  if(!found)
+    throw std::logic_error("could not find both sides of thread stream");
 }
 
 void CommRegistry::destroyThreadMessageConnection(void* conn)
 {
   ThreadMessageConnection* connection = reinterpret_cast<ThreadMessageConnection*>(conn);
 
-  auto a = m_streams->find(connection->getStreamA().getHandle());
-  auto b = m_streams->find(connection->getStreamB().getHandle());
-
   if(connection == NULL)
     throw std::logic_error("null connection in thread stream info");
 
-  try
-  {
-    if(a == m_streams->cend() || b == m_streams->cend())
-      throw std::logic_error("could not find both sides of thread stream");
-
-    delete connection;
-    m_streams->erase(a);
-    m_streams->erase(b);
-  }
-  catch(...)
-  {
-    delete connection;
-
-    if(a != m_streams->end())
-      m_streams->erase(a);
+  Handle a = connection->getStreamA().getHandle();
+  Handle b = connection->getStreamB().getHandle();
+  bool found = (m_streams.find(a) != NULL && m_streams.find(b) != NULL);
 
-    if(b != m_streams->end())
-      m_streams->erase(b);
+  delete connection;
+  m_streams.erase(a);
+  m_streams.erase(b);
 
-    throw;
-  }
+  if(!found)
+    throw std::logic_error("could not find both sides of thread stream");
 }
 
 void CommRegistry::setMode(bool asynchronous,
@@ -350,7 +321,7 @@ void CommRegistry::setMode(bool asynchronous,
 
 void* CommRegistry::accept(StreamType& type, uint32_t timeout)
 {
-  uint32_t endTime = getEndTime(timeout);
+  uint64_t endTime = getEndTime(timeout);
 
   if(m_internalThread != NULL)
     throw std::logic_error("cannot use synchronous accept while in asynchronous mode");
@@ -362,7 +333,7 @@ uint32_t CommRegistry::accept(uint32_t count, uint32_t timeout)
 {
   StreamType type;
   uint32_t numStreams = 0;
-  uint32_t endTime = getEndTime(timeout);
+  uint64_t endTime = getEndTime(timeout);
 
   if(m_internalThread != NULL)
     throw std::logic_error("cannot use synchronous accept while in asynchronous mode");
@@ -381,7 +352,7 @@ uint32_t CommRegistry::accept(uint32_t count, uint32_t timeout)
   return numStreams;
 }
 
-void* CommRegistry::acceptWait(StreamType& type, uint32_t timeout, uint32_t endTime)
+void* CommRegistry::acceptWait(StreamType& type, uint32_t timeout, uint64_t endTime)
 {
   void* newStream = NULL;
   Handle handle;
@@ -447,7 +418,7 @@ void* CommRegistry::acceptWait(StreamType& type, uint32_t timeout, uint32_t endT
 
   // Add the stream to the mapping structures
   m_mutex.lock(s_mutexTimeout);
-  if(!m_streams->insert(std::make_pair(handle, info)).second)
+  if(!m_streams.insert(handle, info))
   {
     m_mutex.unlock();
     delete info;
@@ -0,0 +1,279 @@
+#include "EventLoopGroup.h"
+#include "LetheInternal.h"
+
+using namespace lethe;
+
+const uint32_t EventLoopGroup::s_exclusiveLoop(UINT32_MAX);
+
+EventLoopGroup::EventLoopGroup(uint32_t loopCount, Balancing balancing) :
+  m_mutex(false),
+  m_loads(loopCount, 0),
+  m_balancing(balancing),
+  m_nextLoop(0)
+{
+  if(loopCount == 0)
+    throw std::invalid_argument("loopCount");
+
+  for(uint32_t i = 0; i < loopCount; ++i)
+    m_loops.push_back(new LoopThread(*this, i));
+}
+
+EventLoopGroup::~EventLoopGroup()
+{
+  // Each delete will not return until the loop has stopped
+  for(uint32_t i = 0; i < m_loops.size(); ++i)
+    delete m_loops[i];
+}
+
+void EventLoopGroup::start()
+{
+  for(uint32_t i = 0; i < m_loops.size(); ++i)
+    m_loops[i]->start();
+}
+
+void EventLoopGroup::stop()
+{
+  for(uint32_t i = 0; i < m_loops.size(); ++i)
+    m_loops[i]->stop();
+}
+
+uint32_t EventLoopGroup::add(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  m_mutex.lock();
+
+  uint32_t loop = m_nextLoop;
+
+  if(m_balancing == LeastLoaded)
+  {
+    for(uint32_t i = 0; i < m_loads.size(); ++i)
+    {
+      if(m_loads[i] < m_loads[loop])
+        loop = i;
+    }
+  }
+  else
+    m_nextLoop = (m_nextLoop + 1) % m_loops.size();
+
+  try
+  {
+    addToLoop(loop, obj, handler, userData, interest);
+  }
+  catch(...)
+  {
+    m_mutex.unlock();
+    throw;
+  }
+
+  m_mutex.unlock();
+  return loop;
+}
+
+uint32_t EventLoopGroup::addSticky(WaitObject& obj, uint64_t key, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  uint32_t loop = key % m_loops.size();
+
+  m_mutex.lock();
+
+  try
+  {
+    addToLoop(loop, obj, handler, userData, interest);
+  }
+  catch(...)
+  {
+    m_mutex.unlock();
+    throw;
+  }
+
+  m_mutex.unlock();
+  return loop;
+}
+
+void EventLoopGroup::addExclusive(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  m_mutex.lock();
+
+  if(!m_objectLoops.insert(std::make_pair(&obj, s_exclusiveLoop)).second)
+  {
+    m_mutex.unlock();
+    throw std::logic_error("object already added to EventLoopGroup");
+  }
+
+  for(uint32_t i = 0; i < m_loops.size(); ++i)
+    m_loops[i]->addExclusive(obj, handler, userData, interest);
+
+  m_mutex.unlock();
+}
+
+uint32_t EventLoopGroup::addToLoop(uint32_t loop, WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  if(!m_objectLoops.insert(std::make_pair(&obj, loop)).second)
+    throw std::logic_error("object already added to EventLoopGroup");
+
+  m_loops[loop]->add(obj, handler, userData, interest);
+  ++m_loads[loop];
+
+  return loop;
+}
+
+void EventLoopGroup::dropObject(WaitObject& obj, uint32_t loop, const std::string& reason)
+{
+  m_mutex.lock();
+
+  std::map<WaitObject*, uint32_t>::iterator entry = m_objectLoops.find(&obj);
+
+  // The object may have been removed (or given to another loop) since the add was queued
+  if(entry == m_objectLoops.end() || (entry->second != loop && entry->second != s_exclusiveLoop))
+  {
+    m_mutex.unlock();
+    return;
+  }
+
+  if(entry->second == s_exclusiveLoop)
+  {
+    for(uint32_t j = 0; j < m_loops.size(); ++j)
+    {
+      if(j != loop)
+        m_loops[j]->remove(obj);
+    }
+  }
+  else
+    --m_loads[loop];
+
+  m_objectLoops.erase(entry);
+  m_addError = reason;
+  m_mutex.unlock();
+}
+
+bool EventLoopGroup::modify(WaitObject& obj, uint32_t interest)
+{
+  m_mutex.lock();
+
+  std::map<WaitObject*, uint32_t>::iterator entry = m_objectLoops.find(&obj);
+
+  if(entry == m_objectLoops.end())
+  {
+    m_mutex.unlock();
+    return false;
+  }
+
+  uint32_t loop = entry->second;
+
+  if(loop == s_exclusiveLoop)
+  {
+    for(uint32_t j = 0; j < m_loops.size(); ++j)
+      m_loops[j]->modify(obj, interest);
+  }
+  else
+    m_loops[loop]->modify(obj, interest);
+
+  m_mutex.unlock();
+  return true;
+}
+
+bool EventLoopGroup::remove(WaitObject& obj)
+{
+  m_mutex.lock();
+
+  std::map<WaitObject*, uint32_t>::iterator entry = m_objectLoops.find(&obj);
+
+  if(entry == m_objectLoops.end())
+  {
+    m_mutex.unlock();
+    return false;
+  }
+
+  uint32_t loop = entry->second;
+
+  if(loop == s_exclusiveLoop)
+  {
+    for(uint32_t j = 0; j < m_loops.size(); ++j)
+      m_loops[j]->remove(obj);
+  }
+  else
+  {
+    m_loops[loop]->remove(obj);
+    --m_loads[loop];
+  }
+
+  m_objectLoops.erase(entry);
+  m_mutex.unlock();
+  return true;
+}
+
+uint32_t EventLoopGroup::getLoopCount() const
+{
+  return m_loops.size();
+}
+
+uint32_t EventLoopGroup::getLoad(uint32_t loop)
+{
+  if(loop >= m_loops.size())
+    throw std::out_of_range("loop");
+
+  m_mutex.lock();
+  uint32_t load = m_loads[loop];
+  m_mutex.unlock();
+
+  return load;
+}
+
+std::string EventLoopGroup::getError()
+{
+  for(uint32_t i = 0; i < m_loops.size(); ++i)
+  {
+    std::string error = m_loops[i]->getError();
+
+    if(!error.empty())
+      return error;
+  }
+
+  m_mutex.lock();
+  std::string error(m_addError);
+  m_mutex.unlock();
+
+  return error;
+}
+
+EventLoopGroup::LoopThread::LoopThread(EventLoopGroup& group, uint32_t index) :
+  Thread(INFINITE),
+  m_group(group),
+  m_index(index)
+{
+  // Do nothing
+}
+
+EventLoopGroup::LoopThread::~LoopThread()
+{
+  // Do nothing
+}
+
+void EventLoopGroup::LoopThread::add(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  addWaitObject(obj, handler, userData, interest);
+}
+
+void EventLoopGroup::LoopThread::addExclusive(WaitObject& obj, WaitHandler& handler, void* userData, uint32_t interest)
+{
+  addExclusiveWaitObject(obj, handler, userData, interest);
+}
+
+void EventLoopGroup::LoopThread::modify(WaitObject& obj, uint32_t interest)
+{
+  modifyWaitObject(obj, interest);
+}
+
+void EventLoopGroup::LoopThread::remove(WaitObject& obj)
+{
+  removeWaitObject(obj);
+}
+
+void EventLoopGroup::LoopThread::iterate(Handle handle GCC_UNUSED)
+{
+  // Do nothing, every object is added with a handler
+}
+
+void EventLoopGroup::LoopThread::addFailed(WaitObject& obj, const std::string& reason)
+{
+  // Keep the loop running for the other objects
+  m_group.dropObject(obj, m_index, reason);
+}
@@ -0,0 +1,301 @@
+#include "Lethe.h"
+#include "LetheException.h"
+#include "LetheInternal.h"
+#include "EventLoopGroup.h"
+#include "catch/catch.hpp"
+#include <set>
+
+using namespace lethe;
+
+// Counts the events dispatched to it and the loop threads they came from.  Every
+//  event also unlocks the semaphore, so a test can wait for them to arrive.
+class LoopTestHandler : public WaitHandler
+{
+public:
+  LoopTestHandler() :
+    m_mutex(false),
+    m_semaphore(1000, 0),
+    m_count(0)
+  {
+    // Do nothing
+  }
+
+  void handleWait(const WaitEvent& event GCC_UNUSED)
+  {
+    m_mutex.lock();
+    ++m_count;
+    m_threads.insert(getThreadId());
+    m_mutex.unlock();
+
+    m_semaphore.unlock(1);
+  }
+
+  uint32_t getCount()
+  {
+    m_mutex.lock();
+    uint32_t count = m_count;
+    m_mutex.unlock();
+
+    return count;
+  }
+
+  size_t getThreadCount()
+  {
+    m_mutex.lock();
+    size_t count = m_threads.size();
+    m_mutex.unlock();
+
+    return count;
+  }
+
+  Mutex m_mutex;
+  Semaphore m_semaphore;
+  uint32_t m_count;
+  std::set<uint32_t> m_threads;
+};
+
+// Reads everything from a pipe before counting the event, so the pipe doesn't stay readable
+class PipeTestHandler : public LoopTestHandler
+{
+public:
+  PipeTestHandler(Pipe& pipe) :
+    m_pipe(pipe)
+  {
+    // Do nothing
+  }
+
+  void handleWait(const WaitEvent& event)
+  {
+    char buffer[16];
+    while(m_pipe.receive(buffer, sizeof(buffer)) != 0);
+
+    LoopTestHandler::handleWait(event);
+  }
+
+private:
+  Pipe& m_pipe;
+};
+
+class ThrowingTestHandler : public WaitHandler
+{
+public:
+  void handleWait(const WaitEvent& event GCC_UNUSED)
+  {
+    throw std::runtime_error("handler failed");
+  }
+};
+
+TEST_CASE("eventLoopGroup/roundRobin", "Test placing objects in turn")
+{
+  LoopTestHandler handler;
+  Event event1(false, true);
+  Event event2(false, true);
+  Event event3(false, true);
+  Event event4(false, true);
+  EventLoopGroup group(3);
+
+  REQUIRE(group.getLoopCount() == 3);
+  REQUIRE(group.add(event1, handler) == 0);
+  REQUIRE(group.add(event2, handler) == 1);
+  REQUIRE(group.add(event3, handler) == 2);
+  REQUIRE(group.add(event4, handler) == 0);
+
+  REQUIRE(group.getLoad(0) == 2);
+  REQUIRE(group.getLoad(1) == 1);
+  REQUIRE(group.getLoad(2) == 1);
+  REQUIRE_THROWS_AS(group.getLoad(3), std::out_of_range);
+
+  // Removing an object gives back its load, but doesn't change the order
+  REQUIRE(group.remove(event2));
+  REQUIRE(group.getLoad(1) == 0);
+  REQUIRE(group.add(event2, handler) == 1);
+}
+
+TEST_CASE("eventLoopGroup/leastLoaded", "Test placing objects in the emptiest loop")
+{
+  LoopTestHandler handler;
+  Event event1(false, true);
+  Event event2(false, true);
+  Event event3(false, true);
+  Event event4(false, true);
+  EventLoopGroup group(3, EventLoopGroup::LeastLoaded);
+
+  REQUIRE(group.add(event1, handler) == 0);
+  REQUIRE(group.add(event2, handler) == 1);
+  REQUIRE(group.add(event3, handler) == 2);
+
+  // Every loop has one object, ties go to the first loop
+  REQUIRE(group.remove(event2));
+  REQUIRE(group.add(event4, handler) == 1);
+  REQUIRE(group.add(event2, handler) == 0);
+  REQUIRE(group.getLoad(0) == 2);
+  REQUIRE(group.getLoad(1) == 1);
+  REQUIRE(group.getLoad(2) == 1);
+}
+
+TEST_CASE("eventLoopGroup/sticky", "Test placing objects by key")
+{
+  LoopTestHandler handler;
+  Event event1(false, true);
+  Event event2(false, true);
+  Event event3(false, true);
+  EventLoopGroup group(3);
+
+  REQUIRE(group.addSticky(event1, 5, handler) == 2);
+  REQUIRE(group.addSticky(event2, 8, handler) == 2);
+  REQUIRE(group.addSticky(event3, 9, handler) == 0);
+  REQUIRE_THROWS_AS(group.addSticky(event1, 5, handler), std::logic_error);
+
+  REQUIRE(group.getLoad(0) == 1);
+  REQUIRE(group.getLoad(1) == 0);
+  REQUIRE(group.getLoad(2) == 2);
+
+  // Sticky placement doesn't move the round-robin position
+  REQUIRE(group.remove(event1));
+  REQUIRE(group.add(event1, handler) == 0);
+}
+
+TEST_CASE("eventLoopGroup/exclusive", "Test waking one loop for a shared object")
+{
+  Pipe pipe;
+  PipeTestHandler handler(pipe);
+  EventLoopGroup group(3);
+
+  group.addExclusive(pipe, handler);
+  REQUIRE_THROWS_AS(group.add(pipe, handler), std::logic_error);
+  REQUIRE_THROWS_AS(group.addExclusive(pipe, handler), std::logic_error);
+
+  // Exclusive objects aren't counted against any loop
+  REQUIRE(group.getLoad(0) == 0);
+  REQUIRE(group.getLoad(1) == 0);
+  REQUIRE(group.getLoad(2) == 0);
+
+  group.start();
+  sleep_ms(50);
+
+  for(uint32_t i(0); i < 10; ++i)
+  {
+    pipe.send("x", 1);
+    REQUIRE(WaitForObject(handler.m_semaphore, 2000) == WaitSuccess);
+    REQUIRE(WaitForObject(handler.m_semaphore, 20) == WaitTimeout);
+    REQUIRE(handler.getCount() == i + 1);
+  }
+
+  REQUIRE(group.remove(pipe));
+  sleep_ms(50);
+
+  // No loop handles the pipe once it has been removed
+  pipe.send("x", 1);
+  REQUIRE(WaitForObject(handler.m_semaphore, 50) == WaitTimeout);
+  REQUIRE(handler.getCount() == 10);
+
+  group.stop();
+  REQUIRE(group.getError() == "");
+}
+
+TEST_CASE("eventLoopGroup/modify", "Test modifying and removing objects")
+{
+  Pipe pipe;
+  Pipe otherPipe;
+  PipeTestHandler handler(pipe);
+  EventLoopGroup group(2);
+
+  REQUIRE(!group.modify(pipe, WaitReadable));
+  REQUIRE(!group.remove(pipe));
+
+  group.add(pipe, handler);
+  group.start();
+
+  pipe.send("x", 1);
+  REQUIRE(WaitForObject(handler.m_semaphore, 2000) == WaitSuccess);
+  REQUIRE(handler.getThreadCount() == 1);
+
+  // The object stays with its loop after a modify
+  REQUIRE(group.modify(pipe, WaitReadable | WaitHangup));
+  REQUIRE(!group.modify(otherPipe, WaitReadable));
+  pipe.send("x", 1);
+  REQUIRE(WaitForObject(handler.m_semaphore, 2000) == WaitSuccess);
+  REQUIRE(handler.getThreadCount() == 1);
+
+  REQUIRE(group.remove(pipe));
+  REQUIRE(!group.remove(pipe));
+  REQUIRE(!group.modify(pipe, WaitReadable));
+  sleep_ms(50);
+
+  pipe.send("x", 1);
+  REQUIRE(WaitForObject(handler.m_semaphore, 50) == WaitTimeout);
+  REQUIRE(handler.getCount() == 2);
+
+  group.stop();
+  REQUIRE(group.getError() == "");
+}
+
+TEST_CASE("eventLoopGroup/error", "Test a handler stopping its loop")
+{
+  ThrowingTestHandler handler;
+  Event event(false, true);
+  EventLoopGroup group(2);
+
+  group.add(event, handler);
+  group.start();
+  REQUIRE(group.getError() == "");
+
+  event.set();
+
+  for(uint32_t i(0); i < 200 && group.getError().empty(); ++i)
+    sleep_ms(10);
+
+  REQUIRE(group.getError() == "handler failed");
+  group.stop();
+}
+
+TEST_CASE("eventLoopGroup/fastObjects", "Test objects that have no handle until a loop adds them")
+{
+  LoopTestHandler handler;
+  FastEvent event(false, true);
+  EventLoopGroup group(2);
+
+  // The FastEvent gets its handle from the loop's WaitSet
+  group.add(event, handler);
+  REQUIRE_THROWS_AS(group.add(event, handler), std::logic_error);
+  group.start();
+
+  event.set();
+  REQUIRE(WaitForObject(handler.m_semaphore, 2000) == WaitSuccess);
+  REQUIRE(handler.getCount() == 1);
+
+  REQUIRE(group.modify(event, WaitReadable));
+  REQUIRE(group.remove(event));
+  REQUIRE(!group.remove(event));
+
+  group.stop();
+  REQUIRE(group.getError() == "");
+}
+
+TEST_CASE("eventLoopGroup/addFailed", "Test dropping an object a loop can't add")
+{
+  LoopTestHandler handler;
+  WaitObject invalid(INVALID_HANDLE_VALUE);
+  Event event(false, true);
+  EventLoopGroup group(1);
+
+  // The loop's WaitSet only refuses the object once the loop runs
+  group.add(invalid, handler);
+  REQUIRE(group.getLoad(0) == 1);
+  group.start();
+
+  for(uint32_t i(0); i < 200 && group.getError().empty(); ++i)
+    sleep_ms(10);
+
+  // The object was dropped, but the loop still runs
+  REQUIRE(group.getError() == "invalid handle");
+  REQUIRE(group.getLoad(0) == 0);
+  REQUIRE(!group.remove(invalid));
+
+  group.add(event, handler);
+  event.set();
+  REQUIRE(WaitForObject(handler.m_semaphore, 2000) == WaitSuccess);
+  REQUIRE(handler.getCount() == 1);
+
+  group.stop();
+}